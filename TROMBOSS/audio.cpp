@@ -0,0 +1,207 @@
+#include <Arduino.h>
+#include "audio.h"
+#include "notes_frequencies.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#endif
+
+volatile uint8_t audio_activeVoices = 0;
+
+#if AUDIO_DDS
+
+#if defined(__AVR__)
+#define AUDIO_LOCK()   uint8_t audio_sreg = SREG; cli()
+#define AUDIO_UNLOCK() SREG = audio_sreg
+#else
+#define AUDIO_LOCK()   noInterrupts()
+#define AUDIO_UNLOCK() interrupts()
+#endif
+
+// one period of a parabolic sine, -127..127: x * (128 - x) on each half period
+constexpr int8_t audioWaveSample(uint16_t i) {
+  return (int8_t)((i < 128 ? 1 : -1) * (int16_t)((uint32_t)(i & 127) * (128 - (i & 127)) * 127 / 4096));
+}
+#define AUDIO_WAVE_4(i)  audioWaveSample(i), audioWaveSample(i + 1), audioWaveSample(i + 2), audioWaveSample(i + 3)
+#define AUDIO_WAVE_16(i) AUDIO_WAVE_4(i), AUDIO_WAVE_4(i + 4), AUDIO_WAVE_4(i + 8), AUDIO_WAVE_4(i + 12)
+#define AUDIO_WAVE_64(i) AUDIO_WAVE_16(i), AUDIO_WAVE_16(i + 16), AUDIO_WAVE_16(i + 32), AUDIO_WAVE_16(i + 48)
+static const PROGMEM int8_t audioWave[AUDIO_WAVE_SIZE] = {
+  AUDIO_WAVE_64(0), AUDIO_WAVE_64(64), AUDIO_WAVE_64(128), AUDIO_WAVE_64(192)
+};
+#undef AUDIO_WAVE_4
+#undef AUDIO_WAVE_16
+#undef AUDIO_WAVE_64
+
+// notes above AUDIO_MAX_FREQUENCY (octaves 8 and 9) would alias: play them
+// whole octaves lower, same note name
+constexpr double audioFoldedFrequency(double frequency) {
+  return frequency > AUDIO_MAX_FREQUENCY ? audioFoldedFrequency(frequency / 2) : frequency;
+}
+// 16-bit phase step per sample
+constexpr uint16_t audioPhaseIncrement(uint16_t frequency) {
+  return (uint16_t)(audioFoldedFrequency(frequency) * 65536.0 / AUDIO_SAMPLE_RATE + 0.5);
+}
+#define AUDIO_INCREMENT(n) audioPhaseIncrement(NOTE_##n),
+static const PROGMEM uint16_t notePhaseIncrements[] = { NOTE_TABLE(AUDIO_INCREMENT) };
+#undef AUDIO_INCREMENT
+
+static_assert(sizeof(notePhaseIncrements) == NOTE_COUNT * sizeof(uint16_t), "one increment per note");
+static_assert(audioPhaseIncrement(NOTE_C4) > 0 && audioPhaseIncrement(NOTE_B9) <= 65536 / 4,
+              "every note between 1 and AUDIO_MAX_FREQUENCY");
+static_assert(audioWaveSample(64) == 127 && audioWaveSample(0) == 0 && audioWaveSample(192) == -127,
+              "full scale wavetable");
+
+// voices: phase, step (0 = voice free) and the key that gated it
+static uint16_t audio_phase[AUDIO_VOICES];
+static uint16_t audio_increment[AUDIO_VOICES];
+static uint8_t audio_key[AUDIO_VOICES] = { AUDIO_KEY_NONE, AUDIO_KEY_NONE, AUDIO_KEY_NONE, AUDIO_KEY_NONE };
+// sum scaling by gated voice count: one voice at full scale, four without clipping
+static uint8_t audio_shift = 0;
+static const uint8_t audio_shifts[AUDIO_VOICES + 1] = { 0, 0, 1, 2, 2 };
+
+
+/*
+ * audio_start / audio_stop
+ * PWM on OC2B and its overflow interrupt, only while a voice is gated:
+ * a silent buzzer stays low and costs no interrupt.
+ */
+static void audio_start()
+{
+#if defined(__AVR__)
+  TCNT2 = 0;
+  OCR2B = AUDIO_SILENCE;
+  TCCR2A = _BV(COM2B1) | _BV(WGM20);   // phase correct PWM, TOP = 255, OC2B non inverted
+  TCCR2B = _BV(CS20);                  // no prescaler: 31.4 kHz
+  TIFR2 = _BV(TOV2);
+  TIMSK2 = _BV(TOIE2);
+#endif
+}
+
+static void audio_stop()
+{
+#if defined(__AVR__)
+  TIMSK2 = 0;
+  TCCR2B = 0;
+  TCCR2A = 0;
+  PORTD &= ~_BV(PORTD3);              // OC2B disconnected: pin 3 back to its PORT value, low
+#endif
+}
+
+
+/*
+ * audio_begin
+ * the pin is driven by OC2B from now on.
+ */
+void audio_begin()
+{
+  pinMode(AUDIO_PIN, OUTPUT);
+  digitalWrite(AUDIO_PIN, LOW);
+  audio_allOff();
+}
+
+
+/*
+ * audio_noteOn
+ * the voice already gated by this key, or the first free one, starts the
+ * note at phase 0 (no click). The note is dropped when all voices are busy.
+ */
+void audio_noteOn(uint8_t key, uint8_t note)
+{
+  uint16_t increment = pgm_read_word(&notePhaseIncrements[note]);
+  AUDIO_LOCK();
+  uint8_t voice = AUDIO_VOICES;
+  for (uint8_t v = 0; v < AUDIO_VOICES; v++) {
+    if (audio_key[v] == key) {
+      voice = v;
+      break;
+    }
+    if (audio_key[v] == AUDIO_KEY_NONE && voice == AUDIO_VOICES)
+      voice = v;
+  }
+  if (voice < AUDIO_VOICES) {
+    if (audio_key[voice] == AUDIO_KEY_NONE) {
+      audio_key[voice] = key;
+      audio_shift = audio_shifts[++audio_activeVoices];
+      if (audio_activeVoices == 1)
+        audio_start();
+    }
+    audio_phase[voice] = 0;
+    audio_increment[voice] = increment;
+  }
+  AUDIO_UNLOCK();
+}
+
+
+/*
+ * audio_noteOff
+ */
+void audio_noteOff(uint8_t key)
+{
+  AUDIO_LOCK();
+  for (uint8_t v = 0; v < AUDIO_VOICES; v++) {
+    if (audio_key[v] != key)
+      continue;
+    audio_key[v] = AUDIO_KEY_NONE;
+    audio_increment[v] = 0;
+    audio_shift = audio_shifts[--audio_activeVoices];
+    if (!audio_activeVoices)
+      audio_stop();
+    break;
+  }
+  AUDIO_UNLOCK();
+}
+
+
+/*
+ * audio_allOff
+ */
+void audio_allOff()
+{
+  AUDIO_LOCK();
+  for (uint8_t v = 0; v < AUDIO_VOICES; v++) {
+    audio_key[v] = AUDIO_KEY_NONE;
+    audio_increment[v] = 0;
+  }
+  audio_activeVoices = 0;
+  audio_shift = 0;
+  audio_stop();
+  AUDIO_UNLOCK();
+}
+
+
+/*
+ * audio_nextSample
+ * advance every gated voice by one sample and mix them.
+ */
+uint8_t audio_nextSample()
+{
+  int16_t sum = 0;
+  for (uint8_t v = 0; v < AUDIO_VOICES; v++) {
+    uint16_t increment = audio_increment[v];
+    if (!increment)
+      continue;
+    uint16_t phase = audio_phase[v] + increment;
+    audio_phase[v] = phase;
+    sum += (int8_t)pgm_read_byte(&audioWave[phase >> 8]);
+  }
+  return (uint8_t)(AUDIO_SILENCE + (sum >> audio_shift));
+}
+
+
+#if defined(__AVR__)
+/*
+ * Timer2 overflow, every 510 cycles: a new duty cycle every other period
+ * (AUDIO_SAMPLE_RATE), the carrier stays at 31.4 kHz.
+ */
+ISR(TIMER2_OVF_vect)
+{
+  static uint8_t odd = 0;
+  odd ^= 1;
+  if (odd)
+    return;
+  OCR2B = audio_nextSample();
+}
+#endif
+
+#endif // AUDIO_DDS
@@ -0,0 +1,57 @@
+/*
+ * audio.h
+ * wavetable DDS (direct digital synthesis) on Timer2 for the buzzer.
+ *
+ * Timer2 runs in 8-bit phase correct PWM with no prescaler: OC2B (pin 3)
+ * carries a 31.4 kHz PWM, out of earshot, whose duty cycle is the sample.
+ * Every other overflow interrupt computes one sample (AUDIO_SAMPLE_RATE):
+ * each gated voice adds its 16-bit phase increment and reads the wavetable
+ * at the high byte of its phase, then the voices are summed and scaled.
+ *
+ * Voices are gated by events (audio_noteOn() / audio_noteOff()), keyed by
+ * the caller (the block index in the game), so two blocks on the green
+ * columns sound together instead of one replacing the other.
+ *
+ * audio_nextSample() holds the whole sample computation; it is the body of
+ * the interrupt on AVR and is called directly by the host bench to render
+ * a WAV file.
+ */
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <Arduino.h>
+
+#if !defined(AUDIO_DDS)
+#define AUDIO_DDS 1   // 0 = one square wave voice, Timer2 in CTC mode (playNote() / stopNote())
+#endif
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+#define AUDIO_PIN 3                                           // OC2B (PD3), fixed by Timer2
+#define AUDIO_VOICES 4
+#define AUDIO_WAVE_SIZE 256                                   // wavetable entries (8-bit index)
+#define AUDIO_PWM_RATE (F_CPU / 510.0)                        // phase correct, TOP = 255
+#define AUDIO_SAMPLE_RATE (AUDIO_PWM_RATE / 2)                // 15686 Hz
+#define AUDIO_MAX_FREQUENCY (AUDIO_SAMPLE_RATE / 4)           // higher notes are played octaves down
+#define AUDIO_KEY_NONE 0xFF
+#define AUDIO_SILENCE 128                                     // PWM duty of the zero level
+
+extern volatile uint8_t audio_activeVoices;   // gated voices
+
+#if AUDIO_DDS
+// configure Timer2 / OC2B; the PWM and its interrupt only run while a voice is gated
+void audio_begin();
+// gate a free voice with a note (index of notes_frequencies.h) for this key
+void audio_noteOn(uint8_t key, uint8_t note);
+// release the voice of this key (if any)
+void audio_noteOff(uint8_t key);
+// release every voice
+void audio_allOff();
+// one sample, 0..255 (AUDIO_SILENCE when no voice is gated)
+uint8_t audio_nextSample();
+#endif
+
+#endif // AUDIO_H
@@ -0,0 +1,165 @@
+#include <Arduino.h>
+#include "button.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#define BUTTON_LOCK()   uint8_t button_sreg = SREG; cli()
+#define BUTTON_UNLOCK() SREG = button_sreg
+#else
+#define BUTTON_LOCK()   noInterrupts()
+#define BUTTON_UNLOCK() interrupts()
+#endif
+
+volatile ButtonStats button_stats;
+
+static volatile ButtonEdge button_queue[BUTTON_QUEUE];
+static volatile uint8_t button_head = 0;
+static volatile uint8_t button_count = 0;
+static volatile uint8_t button_state = 0;          // last accepted level, 1 = pressed
+static volatile uint32_t button_lastEdge = 0;      // micros() of the last accepted edge
+static uint8_t button_pin = 0;
+#if defined(__AVR__)
+static volatile uint8_t* button_input = 0;         // PINx of the button
+static uint8_t button_mask = 0;
+#endif
+
+static_assert((BUTTON_QUEUE & (BUTTON_QUEUE - 1)) == 0, "queue index wraps with a mask");
+
+
+/*
+ * button_read
+ * 1 when the button is pressed (input low).
+ */
+static inline uint8_t button_read()
+{
+#if defined(__AVR__)
+  return !(*button_input & button_mask);
+#else
+  return digitalRead(button_pin) == LOW;
+#endif
+}
+
+
+/*
+ * button_push
+ * accept an edge; called with interrupts disabled.
+ */
+static void button_push(uint8_t pressed, uint32_t now)
+{
+  button_state = pressed;
+  button_lastEdge = now;
+  if (button_count >= BUTTON_QUEUE) {
+    button_stats.overflows++;
+    return;
+  }
+  volatile ButtonEdge& edge = button_queue[(button_head + button_count) & (BUTTON_QUEUE - 1)];
+  edge.time = now;
+  edge.pressed = pressed;
+  button_count++;
+  button_stats.edges++;
+}
+
+
+/*
+ * button_change
+ */
+void button_change()
+{
+  uint32_t now = micros();
+  uint8_t pressed = button_read();
+  if (pressed == button_state)
+    return;
+  if (now - button_lastEdge < BUTTON_DEBOUNCE_US) {
+    button_stats.bounces++;
+    return;
+  }
+  button_push(pressed, now);
+}
+
+
+/*
+ * button_poll
+ * a bounce dropped during the debounce time may have been the last edge:
+ * the level then differs from the accepted state with no interrupt left
+ * to come.
+ */
+void button_poll()
+{
+  BUTTON_LOCK();
+  uint32_t now = micros();
+  uint8_t pressed = button_read();
+  if (pressed != button_state && now - button_lastEdge >= BUTTON_DEBOUNCE_US) {
+    button_push(pressed, now);
+    button_stats.restored++;
+  }
+  BUTTON_UNLOCK();
+}
+
+
+/*
+ * button_pop
+ */
+bool button_pop(ButtonEdge* edge)
+{
+  bool found = false;
+  BUTTON_LOCK();
+  if (button_count) {
+    edge->time = button_queue[button_head].time;
+    edge->pressed = button_queue[button_head].pressed;
+    button_head = (button_head + 1) & (BUTTON_QUEUE - 1);
+    button_count--;
+    found = true;
+  }
+  BUTTON_UNLOCK();
+  return found;
+}
+
+
+/*
+ * button_sync
+ */
+void button_sync()
+{
+  BUTTON_LOCK();
+  button_count = 0;
+  button_state = button_read();
+  button_lastEdge = micros();
+  BUTTON_UNLOCK();
+}
+
+
+/*
+ * button_pressed
+ */
+uint8_t button_pressed()
+{
+  return button_state;
+}
+
+
+/*
+ * button_begin
+ */
+void button_begin(uint8_t pin)
+{
+  button_pin = pin;
+  pinMode(pin, INPUT_PULLUP);
+#if defined(__AVR__)
+  button_input = portInputRegister(digitalPinToPort(pin));
+  button_mask = digitalPinToBitMask(pin);
+#endif
+  button_sync();
+#if defined(__AVR__)
+  *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+  PCIFR = _BV(digitalPinToPCICRbit(pin));
+  PCICR |= _BV(digitalPinToPCICRbit(pin));
+#endif
+}
+
+
+#if defined(__AVR__)
+ISR(PCINT0_vect)
+{
+  button_change();
+}
+#endif
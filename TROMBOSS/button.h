@@ -0,0 +1,50 @@
+/*
+ * button.h
+ * button edges stamped by a pin change interrupt.
+ *
+ * Every accepted edge of the button (press = low, pull-up input) is queued
+ * with its micros() time stamp, so the game knows when the player pressed
+ * and released, to the microsecond, however rarely it looks at the queue.
+ * Bounces are dropped for BUTTON_DEBOUNCE_US after an accepted edge;
+ * button_poll() restores an edge whose bounce hid the final level.
+ *
+ * button_change() is the whole interrupt body; the host HAL calls it when
+ * the simulated input changes.
+ */
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include <Arduino.h>
+
+#define BUTTON_QUEUE 8               // edges waiting for the game (power of two)
+#define BUTTON_DEBOUNCE_US 5000UL    // edges ignored after an accepted edge
+
+typedef struct {
+  uint32_t time;      // micros() of the edge
+  uint8_t pressed;    // 1 = press (pin low), 0 = release
+} ButtonEdge;
+
+typedef struct {
+  uint16_t edges;     // accepted edges
+  uint16_t bounces;   // edges dropped by the debounce
+  uint16_t restored;  // edges restored by button_poll()
+  uint16_t overflows; // edges lost, queue full
+} ButtonStats;
+
+extern volatile ButtonStats button_stats;
+
+// input with pull-up and pin change interrupt (Uno: pins 8..13 = PCINT0_vect)
+void button_begin(uint8_t pin);
+// pin change interrupt body
+void button_change();
+// restore a missed edge once the level has been stable for the debounce time
+void button_poll();
+// oldest queued edge; false if none
+bool button_pop(ButtonEdge* edge);
+// forget queued edges and take the current level as is
+void button_sync();
+// debounced level: 1 = pressed
+uint8_t button_pressed();
+
+#endif // BUTTON_H
@@ -0,0 +1,220 @@
+/*
+ * charts.h
+ * Partitions précalculées - généré par tools/midi2chart, ne pas modifier à la main.
+ * Un événement par bloc (16 bits) :
+ *   bits 15..13 couloir 0..6 (ligne 2 x couloir), 7 = attente
+ *   bits 12..10 longueur - 1, bits 9..7 octave - 4
+ *   bits  6..0  ticks de 25 ms depuis l'événement précédent
+ *   attente : bits 9..0 = ticks sans apparition
+ * Pool vérifié : 32 blocs (CHART_POOL, au plus MAX_BLOCKS).
+ */
+
+#ifndef CHARTS_H
+#define CHARTS_H
+
+#define CHART_LEVELS 9
+#define CHART_PARTS 4
+#define CHART_POOL 32
+#define CHART_WAIT_LANE 7
+#define CHART_LANE(e) ((e) >> 13)
+#define CHART_LENGTH(e) ((((e) >> 10) & 0x07) + 1)
+#define CHART_OCTAVE(e) (((e) >> 7) & 0x07)
+#define CHART_DELTA(e) ((e) & 0x7F)
+#define CHART_WAIT_TICKS(e) ((e) & 0x3FF)
+
+const PROGMEM uint16_t chart_empty[] = {0};
+
+const PROGMEM uint16_t chart_level1_intro[] = {
+    0x1C00, 0xE168, 0xDC00
+};
+
+const PROGMEM uint16_t chart_level1_verse[] = {
+    0xE168, 0x9C00, 0xE168, 0x5400, 0xE12C, 0x3C80
+};
+
+const PROGMEM uint16_t chart_level1_chorus[] = {
+    0xE168, 0x1480, 0xE12C, 0x7480
+};
+
+const PROGMEM uint16_t chart_level1_hook[] = {
+    0xE12C, 0x9400, 0xE12C, 0x1480
+};
+
+const PROGMEM uint16_t chart_level2_intro[] = {
+    0x1400, 0xE0FA, 0x7400, 0xE0FA, 0x7080
+};
+
+const PROGMEM uint16_t chart_level2_verse[] = {
+    0xE0FA, 0x1080, 0xE0FA, 0x9400, 0xE0FA, 0x1480, 0xE0FA, 0xD000
+};
+
+const PROGMEM uint16_t chart_level2_chorus[] = {
+    0xE0FA, 0x5080, 0xE0FA, 0x9400, 0xE0FA, 0x7080
+};
+
+const PROGMEM uint16_t chart_level2_hook[] = {
+    0xE0FA, 0x9080, 0xE0FA, 0x9000
+};
+
+const PROGMEM uint16_t chart_level3_intro[] = {
+    0x1000, 0xE0D2, 0xD000, 0xE0D2, 0x0C80, 0xE0A8, 0xB080
+};
+
+const PROGMEM uint16_t chart_level3_verse[] = {
+    0xE0D2, 0x2C80, 0xE0A8, 0xAC80, 0xE0A8, 0x8C80, 0xE0A8, 0x6C80,
+    0xE0A8, 0x5080
+};
+
+const PROGMEM uint16_t chart_level3_chorus[] = {
+    0xE0D2, 0x8C00, 0xE0A8, 0x0C80, 0xE0A8, 0x7000, 0xE0D2, 0xCC80
+};
+
+const PROGMEM uint16_t chart_level3_hook[] = {
+    0xE0A8, 0x0C00, 0xE0A8, 0x8C00, 0xE0A8, 0xB000
+};
+
+const PROGMEM uint16_t chart_level4_intro[] = {
+    0x0C00, 0xE090, 0x6800, 0x696C, 0x886C, 0x896C
+};
+
+const PROGMEM uint16_t chart_level4_verse[] = {
+    0x0C6C, 0xE090, 0x6C00, 0xE090, 0xCC00, 0xE090, 0x4C00, 0xE090,
+    0x6880, 0x496C, 0x886C
+};
+
+const PROGMEM uint16_t chart_level4_chorus[] = {
+    0x09EC, 0x28EC, 0x49EC, 0x6C6C, 0xE090, 0x4C80, 0xE090, 0x2C00
+};
+
+const PROGMEM uint16_t chart_level4_hook[] = {
+    0xE090, 0x0C80, 0xE090, 0xCC80, 0xE090, 0xAC00
+};
+
+const PROGMEM uint16_t chart_level5_intro[] = {
+    0x4480, 0x08BC, 0xC85A, 0x08DA, 0x08DA, 0x24DA, 0x04BC, 0xA03C
+};
+
+const PROGMEM uint16_t chart_level5_verse[] = {
+    0x68BC, 0x68DA, 0x44DA, 0x08BC, 0x24DA, 0x04BC, 0xA03C
+};
+
+const PROGMEM uint16_t chart_level5_chorus[] = {
+    0xC83C, 0x08DA, 0xA85A, 0x28DA, 0x08DA, 0x04DA, 0xA03C, 0x68BC,
+    0x68DA
+};
+
+const PROGMEM uint16_t chart_level5_hook[] = {
+    0x44DA, 0x08BC, 0x24DA, 0x04BC, 0xA03C
+};
+
+const PROGMEM uint16_t chart_level6_intro[] = {
+    0x0800, 0x05CB, 0x69B2, 0x684B, 0xA9CB, 0x08CB, 0x084B, 0x28CB,
+    0x49CB
+};
+
+const PROGMEM uint16_t chart_level6_verse[] = {
+    0xA44B, 0x0832, 0xA1CB, 0x01B2, 0x41B2, 0x61B2, 0xC1B2, 0x41B2,
+    0x81B2, 0x21B2, 0xA1B2, 0x0032, 0x61B2, 0x8032, 0x41B2
+};
+
+const PROGMEM uint16_t chart_level6_chorus[] = {
+    0x0232, 0x21B2, 0xC1B2, 0x41B2, 0xA1B2, 0x01B2, 0x81B2, 0x61B2,
+    0x2232, 0xC1B2, 0x4232, 0xA1B2
+};
+
+const PROGMEM uint16_t chart_level6_hook[] = {
+    0x0232, 0x61B2, 0x2232, 0x41B2, 0xC1B2, 0x81B2, 0xA232, 0x01B2
+};
+
+const PROGMEM uint16_t chart_level7_intro[] = {
+    0x0400, 0x6428, 0xC028, 0x4028, 0xA428, 0x2028, 0x8028, 0x04A8,
+    0x60A8, 0xC0A8, 0x44A8, 0xA128, 0x2128, 0x8528
+};
+
+const PROGMEM uint16_t chart_level7_verse[] = {
+    0x0428, 0x80A8, 0x6028, 0xA128, 0x2428, 0xC128, 0x4028, 0x05A8,
+    0xA028, 0x21A8, 0xC428, 0x41A8, 0x00A8, 0x65A8, 0x8028, 0xA1A8,
+    0x64A8, 0xC1A8, 0x4128, 0x85A8
+};
+
+const PROGMEM uint16_t chart_level7_chorus[] = {
+    0x2028, 0xA4A8, 0x4028, 0x0128, 0x6428, 0x2128, 0x8028, 0x4528,
+    0xA028, 0x6528, 0xC028, 0x8128, 0x04A8, 0xA128
+};
+
+const PROGMEM uint16_t chart_level7_hook[] = {
+    0x4028, 0xC528, 0x6028, 0x01A8, 0x8428, 0x21A8, 0xA028, 0x45A8,
+    0x0028, 0x65A8, 0x2028, 0x81A8
+};
+
+const PROGMEM uint16_t chart_level8_intro[] = {
+    0x0000, 0x4420, 0x8020, 0x0420, 0x6020, 0xA420, 0x2020, 0xC420,
+    0x8020, 0x4420, 0x00A0, 0xA420, 0x60A0, 0x2420, 0xC0A0, 0x8420,
+    0x4120, 0x0420
+};
+
+const PROGMEM uint16_t chart_level8_verse[] = {
+    0x6020, 0x01A0, 0xA020, 0x21A0, 0xC020, 0x41A0, 0x0020, 0x61A0,
+    0x8020, 0x81A0, 0x2020, 0xA1A0, 0x4020, 0xC1A0, 0x60A0, 0x0220,
+    0xA0A0, 0x2220, 0xC0A0, 0x4220, 0x0120, 0x6220, 0x8120, 0x8220
+};
+
+const PROGMEM uint16_t chart_level8_chorus[] = {
+    0x2020, 0xA220, 0x4020, 0xC220, 0x6020, 0x02A0, 0x8020, 0x22A0,
+    0xA020, 0x42A0, 0xC020, 0x62A0, 0x00A0, 0x82A0, 0x20A0, 0xA2A0
+};
+
+const PROGMEM uint16_t chart_level8_hook[] = {
+    0x40A0, 0xC2A0, 0x60A0, 0x02A0, 0x80A0, 0x22A0, 0xA0A0, 0x42A0,
+    0xC0A0, 0x62A0, 0x0120, 0x82A0
+};
+
+const PROGMEM uint16_t chart_level9_intro[] = {
+    0x0000, 0x4018, 0xA218, 0x6298, 0x0298, 0xA298, 0x2298, 0x8298,
+    0x4298, 0xC298, 0x6298, 0xA298, 0x0298, 0x2298, 0x8298, 0x4298,
+    0xC298, 0x6298
+};
+
+const PROGMEM uint16_t chart_level9_verse[] = {
+    0xA298, 0x0018, 0x6218, 0x8298, 0x4018, 0xC218, 0x2298, 0x0298,
+    0x4298, 0x6298, 0x8218, 0xA298, 0xC298, 0x0218, 0x2298, 0x4298,
+    0x6218, 0x8298, 0xA298, 0xC218, 0x0298, 0x2298, 0x4218, 0x6298,
+    0x8218, 0xA298, 0xC218, 0x0298
+};
+
+const PROGMEM uint16_t chart_level9_chorus[] = {
+    0x2298, 0x4218, 0x6298, 0x8218, 0xA298, 0xC218, 0x0298, 0x2218,
+    0x4298, 0x6218, 0x8298, 0xA218, 0xC298, 0x0218, 0xA298, 0x2218,
+    0x6298, 0x8218, 0x4298, 0xC218
+};
+
+const PROGMEM uint16_t chart_level9_hook[] = {
+    0x8298, 0xA218, 0xC298, 0x0218, 0x2298, 0x4218, 0x6298, 0x8218,
+    0xA298, 0xC218, 0x0298, 0x2218, 0x4298, 0x6218, 0x8298, 0xA218
+};
+
+const uint16_t* const chartParts[CHART_LEVELS][CHART_PARTS] PROGMEM = {
+    {chart_level1_intro, chart_level1_verse, chart_level1_chorus, chart_level1_hook},
+    {chart_level2_intro, chart_level2_verse, chart_level2_chorus, chart_level2_hook},
+    {chart_level3_intro, chart_level3_verse, chart_level3_chorus, chart_level3_hook},
+    {chart_level4_intro, chart_level4_verse, chart_level4_chorus, chart_level4_hook},
+    {chart_level5_intro, chart_level5_verse, chart_level5_chorus, chart_level5_hook},
+    {chart_level6_intro, chart_level6_verse, chart_level6_chorus, chart_level6_hook},
+    {chart_level7_intro, chart_level7_verse, chart_level7_chorus, chart_level7_hook},
+    {chart_level8_intro, chart_level8_verse, chart_level8_chorus, chart_level8_hook},
+    {chart_level9_intro, chart_level9_verse, chart_level9_chorus, chart_level9_hook}
+};
+
+const uint16_t chartSizes[CHART_LEVELS][CHART_PARTS] PROGMEM = {
+    {3, 6, 4, 4},
+    {5, 8, 6, 4},
+    {7, 10, 8, 6},
+    {6, 11, 8, 6},
+    {8, 7, 9, 5},
+    {9, 15, 12, 8},
+    {14, 20, 14, 12},
+    {18, 24, 16, 12},
+    {18, 28, 20, 16}
+};
+
+#endif // CHARTS_H
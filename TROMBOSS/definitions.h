@@ -8,14 +8,8 @@
 #define BUTTON_PIN 12
 #define BUZZER_PIN 3
 
-// ===== CONSTANTES MATRICE LED =====
-#define MATRIX_WIDTH 32
-#define MATRIX_HEIGHT 16
-#define BLOCK_HEIGHT 2
-#define MAX_BLOCKS 18
-
-// ===== CONSTANTES TIMING =====
-#define TIMER_PERIOD 25000  // 25ms en microsecondes
+// Matrice, blocs, niveaux, horloge musicale, score et jugement : règles du jeu dans engine.h
+// (MATRIX_WIDTH, MAX_BLOCKS, TIMER_PERIOD, CHART_MODE, LEVEL_n_BPM, TEMPO_*, JUDGE_*...)
 
 // ===== CONSTANTES COULEURS =====
 #define COLOR_OFF 0
@@ -35,8 +29,6 @@
 
 // ===== CONSTANTES CURSEUR =====
 #define CURSOR_WIDTH 2
-#define CURSOR_HEIGHT 2
-#define CURSOR_COLUMN_START 2
 #define CURSOR_BLINK_INTERVAL 200  // ms
 
 // États du curseur
@@ -54,48 +46,11 @@
 #define DEBUG_SERIAL 0
 
 // ===== CONSTANTES NIVEAUX DE DIFFICULTE =====
-#define MIN_DIFFICULTY_LEVEL 1
-#define MAX_DIFFICULTY_LEVEL 9
-
-// Nombre de cycles entre chaque déplacement de bloc selon le niveau
-#define BLOCK_MOVE_CYCLES_LEVEL_1 40
-#define BLOCK_MOVE_CYCLES_LEVEL_2 35
-#define BLOCK_MOVE_CYCLES_LEVEL_3 30
-#define BLOCK_MOVE_CYCLES_LEVEL_4 25
-#define BLOCK_MOVE_CYCLES_LEVEL_5 20
-#define BLOCK_MOVE_CYCLES_LEVEL_6 15
-#define BLOCK_MOVE_CYCLES_LEVEL_7 12
-#define BLOCK_MOVE_CYCLES_LEVEL_8 10
-#define BLOCK_MOVE_CYCLES_LEVEL_9 8
-
-// Nombre de cycles entre chaque création de nouvelle note selon le niveau
-#define NOTE_CREATION_CYCLES_LEVEL_1 60  // 1.5 secondes - très lent
-#define NOTE_CREATION_CYCLES_LEVEL_2 50  // 1.25 secondes - lent  
-#define NOTE_CREATION_CYCLES_LEVEL_3 42  // 1.05 secondes - moyen-lent
-#define NOTE_CREATION_CYCLES_LEVEL_4 36  // 0.9 secondes - moyen
-#define NOTE_CREATION_CYCLES_LEVEL_5 30  // 0.75 secondes - moyen-rapide
-#define NOTE_CREATION_CYCLES_LEVEL_6 25  // 0.625 secondes - rapide
-#define NOTE_CREATION_CYCLES_LEVEL_7 20  // 0.5 secondes - très rapide
-#define NOTE_CREATION_CYCLES_LEVEL_8 16  // 0.4 secondes - ultra-rapide
-#define NOTE_CREATION_CYCLES_LEVEL_9 12  // 0.3 secondes - extrême
-
-// ===== STRUCTURE BLOC =====
-typedef struct {
-  int16_t x;              // Position horizontale
-  uint8_t y;              // Position verticale
-  uint8_t length;         // Longueur du bloc
-  uint8_t color : 3;      // Couleur du bloc sur 3 bits (0-7)
-  uint8_t active : 1;     // Flag actif sur 1 bit
-  uint16_t frequency;     // Fréquence de la note associée
-  uint8_t needsUpdate : 1; // Flag pour indiquer si le bloc doit être mis à jour
-  int16_t oldX;           // Ancienne position X pour effacer
-  uint32_t hitPixels;     // Masque de bits pour les pixels déjà touchés (max 32 pixels)
-} Block;
+#define DEFAULT_DIFFICULTY_LEVEL 1
 
 // ===== STRUCTURE CURSEUR =====
 typedef struct {
-  uint8_t y;              // Position Y cible (0-14)
-  uint8_t yDisplayed;     // Position Y actuellement affichée
+  uint8_t y;              // Position Y cible (0-14), affichée : game.cursorY
   uint8_t yLast;          // Dernière position affichée (pour effacement)
   uint8_t state;          // État: CURSOR_STATE_NORMAL ou CURSOR_STATE_BLINKING
   uint8_t visible;        // Visibilité: CURSOR_VISIBLE ou CURSOR_HIDDEN
@@ -104,13 +59,6 @@ typedef struct {
   uint32_t lastBlinkTime; // Dernier temps de clignotement
 } Cursor;
 
-// ===== STRUCTURE SCORE =====
-typedef struct {
-  uint16_t current;         // Score actuel du joueur
-  uint16_t maxPossible;     // Score maximum actuellement atteignable (points qui ont passé la ligne)
-  uint8_t transformed;      // Score transformé en pourcentage (0-100)
-} Score;
-
 // ===== STRUCTURE JEU =====
 typedef struct {
   uint8_t etat;           // État du jeu: GAME_STATE_MENU, GAME_STATE_LEVEL, GAME_STATE_WIN, GAME_STATE_LOSE
@@ -151,31 +99,27 @@ bool menu7SegInitialized = false;   // Flag pour savoir si le menu a été initi
 volatile uint16_t periodicCounter = 0;
 
 Cursor cursor;
-Block blocks[MAX_BLOCKS];
-volatile bool displayNeedsUpdate = false;
-volatile bool shouldShowCursor = true;
 
-// Variable principale de l'état du jeu
-GameState gameState;
+// Moteur du niveau (engine.h) : blocs, bitboards, ligne de temps, score et jugement
+Engine game;
 
-// Variable de score
-Score gameScore;
+volatile bool displayNeedsUpdate = false;
+volatile bool shouldShowCursor = true;
 
-// Variables pour la musique
-uint8_t songPosition = 0;
-uint8_t currentSongPart = 0;
-uint8_t songFinished = 0;
-uint8_t lastNoteFrequency = 0;
-bool lastNoteStillActive = false;
-bool blockNotePlaying[MAX_BLOCKS] = {0};
+// Nombre d'impulsions d'horloge envoyées sur le bus HT1632 par la dernière mise à jour de handleLevelLoop()
+unsigned long levelFrameBusBits = 0;
 
-// Variable globale pour garder trace de la dernière note créée
-uint8_t lastNotePosition = 255;
+// ===== COMPOSITEUR DU NIVEAU =====
+// Trois couches résolues ligne par ligne à chaque image : fond (colonnes vertes), blocs
+// (boardBlocks), curseur (si visible). Priorité : curseur > bloc > colonne verte.
+// Plans vert/rouge de la dernière image envoyée : seuls les pixels qui diffèrent sont tracés
+uint32_t composedGreen[MATRIX_HEIGHT];
+uint32_t composedRed[MATRIX_HEIGHT];
+uint8_t levelFramePixels = 0;   // Pixels modifiés par la dernière image composée
+uint16_t levelFrameCount = 0;   // Images composées depuis le début du niveau
 
-// Variables pour le système de niveaux
-uint8_t currentDifficultyLevel = DEFAULT_DIFFICULTY_LEVEL;
-uint8_t blockMoveCycles = BLOCK_MOVE_CYCLES_LEVEL_6;
-uint8_t noteCreationCycles = NOTE_CREATION_CYCLES_LEVEL_1;
+// Variable principale de l'état du jeu
+GameState gameState;
 
 // ===== CONSTANTES MENU =====
 #define MENU_LEVEL_MIN 1
@@ -195,8 +139,17 @@ uint8_t persistentSelectedLevel = 1;
 // Variable globale pour signaler la réinitialisation du bouton après changement d'état
 bool needButtonReset = false;
 
-// Variable globale pour forcer la réinitialisation du menu
-bool forceMenuReinit = false;
+// Transition d'état en cours (changeGameState) : periodicFunction() ne fait rien
+volatile bool stateTransition = false;
+uint16_t transitionTicks = 0;          // Ticks de l'interruption sautés pendant les transitions
+uint32_t stateEnterTime = 0;           // millis() à l'entrée dans l'état courant
+
+// Mesure des changements d'écran : de changeGameState() à l'écran complet, par état
+uint32_t screenChangeStart = 0;        // micros() au changement d'état
+unsigned long screenChangeBits = 0;    // ht1632_busbits au changement d'état
+bool screenChangePending = false;
+uint32_t screenReadyMicros[4] = {0};   // Dernière durée mesurée (µs)
+unsigned long screenReadyBits[4] = {0}; // Impulsions envoyées sur le bus HT1632
 
 // ===== DONNÉES MENU COMPRESSÉES =====
 
@@ -214,47 +167,26 @@ void clear7Seg();
 // Fonction optimisée pour mettre à jour l'affichage 7 segments selon l'état du jeu
 void update7SegDisplay(uint8_t gameState, uint8_t transformedScore, uint8_t level);
 
-// ===== FONCTIONS UTILITAIRES =====
-// Fonction pour obtenir le nombre de cycles selon le niveau de difficulté
-uint8_t getDifficultyBlockMoveCycles(uint8_t level);
-// Fonction pour définir le niveau de difficulté
-void setDifficultyLevel(uint8_t level);
-// Fonction pour déterminer la position Y en fonction de la fréquence
-uint8_t getPositionYFromFrequency(uint16_t frequency);
-// Fonction pour vérifier si une position verticale est déjà occupée par un bloc actif
-bool isVerticalPositionOccupied(uint8_t posY);
-// Fonction pour vérifier si une colonne est déjà occupée par un bloc actif
-bool isColumnOccupied(int16_t x);
-
-// ===== FONCTIONS DE GESTION DES BLOCS =====
-// Fonction pour créer un nouveau bloc en fonction d'une note
-void createNewBlock(const MusicNote* noteArray, uint8_t noteIndex);
-// Affiche uniquement la tête du bloc (nouvelle colonne)
-void drawBlockHead(const Block& block);
-// Fonction pour dessiner un bloc sur la matrice
-void drawBlock(Block block);
-// Efface uniquement la colonne et lignes concernées par la queue d'un bloc
-void eraseBlockTail(const Block& block);
-// Fonction pour passer à la prochaine note de la chanson
-void nextNote();
-
 // ===== FONCTIONS DE GESTION DU CURSEUR =====
 // Fonction périodique pour lire le potentiomètre et calculer la position cible du curseur
 void updateCursorFromPot();
-// Efface le curseur 2x2 à une position donnée et restaure la colonne verte uniquement sur cette zone
-void eraseCursor(uint8_t y);
-// Affiche le curseur 2x2 rouge à une position donnée
-void drawCursor(uint8_t y);
-// Fonction périodique pour déplacer le curseur bloc par bloc avec clignotement si demandé
-void periodicMoveCursor();
 
 // ===== FONCTIONS D'AFFICHAGE =====
-// Affiche les colonnes 2 et 3 en vert (statique, hors zone curseur et hors zone bloc)
-void drawStaticColumnsExceptCursorAndBlocks();
+// Masque des colonnes du curseur affiché sur la ligne y
+uint32_t boardCursorRow(uint8_t y);
+// Oublier la dernière image composée (écran effacé)
+void composeReset();
+// Composer l'image du niveau et tracer les pixels dont la couleur finale a changé
+uint8_t composeFrame();
 
 // ===== FONCTIONS DE GESTION DU JEU =====
 // Initialisation de l'état du jeu
 void initGameState();
+// Entrée dans chaque état : écran dessiné dans la trame ouverte par changeGameState()
+void enterMenuState();
+void enterLevelState();
+void enterWinState();
+void enterLoseState();
 // Gestion du menu principal
 void handleMenuState();
 // Gestion de l'état de jeu (niveau)
@@ -263,42 +195,36 @@ void handleLevelState();
 void handleWinState();
 // Gestion de l'état de défaite
 void handleLoseState();
+// Retour au menu sur appui (WIN et LOSE)
+void handleEndScreen();
 // Fonction pour changer l'état du jeu
 void changeGameState(uint8_t newState);
+// Fin de la mesure du changement d'écran : l'écran de l'état est complet
+void screenReady(uint8_t state);
 // Fonction principale de gestion du niveau
 void handleLevelLoop();
 
-// ===== FONCTIONS DE GESTION DU SCORE =====
-// Initialisation du score
-void initScore();
-// Ajouter des points au score actuel
-void addScore(uint16_t points);
-// Ajouter des points au score maximum possible
-void addMaxScore(uint16_t points);
-// Calculer et mettre à jour le score transformé
-void updateTransformedScore();
-
-// ===== FONCTIONS DE DÉTECTION DE COLLISION =====
-// Vérifier si le curseur touche un bloc et marquer les points
-void checkCursorCollision();
-// Calculer quels pixels du bloc sont touchés par le curseur
-uint32_t getBlockPixelsHitByCursor(uint8_t blockIndex);
-
 // ===== FONCTIONS SYSTÈME =====
 // Fonction principale setup
 void setup();
 // Fonction principale loop
 void loop();
+// Événements du moteur : voix des blocs qui entrent sur / sortent des colonnes vertes, suivi série
+void gameEvent(Engine* engine, uint8_t event, uint8_t block, uint8_t value);
+#if !AUDIO_DDS
+// Jouer une note (index) sur le buzzer, registres du Timer2 précalculés
+void playNote(uint8_t note);
+// Couper le buzzer
+void stopNote();
 // Fonction séparée pour la gestion audio
 void updateAudio();
+#endif
 // Fonction appelée périodiquement par TimerOne (toutes les 25ms)
 void periodicFunction();
 
 // ===== FONCTIONS MENU =====
 // Initialiser l'état du menu
 void initMenuState();
-// Dessiner le texte "MENU" statique
-void drawMenuText();
 // Dessiner la boîte du niveau (rectangle)
 void drawMenuBox();
 // Effacer la boîte du niveau
@@ -315,7 +241,7 @@ void updateMenuValidation();
 // ===== DONNÉES MENU COMPRESSÉES =====
 
 // Coordonnées du texte "MENU" (format: x, y)
-const uint8_t menuTextCoords[] PROGMEM = {
+constexpr uint8_t menuTextCoords[] PROGMEM = {
   1,2, 5,2, 7,2, 8,2, 9,2, 10,2, 21,2, 25,2, 27,2, 30,2,
   1,3, 2,3, 4,3, 5,3, 7,3, 21,3, 22,3, 25,3, 27,3, 30,3,
   1,4, 3,4, 5,4, 7,4, 21,4, 22,4, 25,4, 27,4, 30,4,
@@ -327,7 +253,7 @@ const uint8_t menuTextCoords[] PROGMEM = {
 const uint8_t menuTextCoordsCount = sizeof(menuTextCoords) / 2;
 
 // Coordonnées de la boîte (rectangle milieu)
-const uint8_t menuBoxCoords[] PROGMEM = {
+constexpr uint8_t menuBoxCoords[] PROGMEM = {
   12,5, 13,5, 14,5, 15,5, 16,5, 17,5, 18,5, 19,5,
   12,6, 19,6, 12,7, 19,7, 12,8, 19,8, 12,9, 19,9,
   12,10, 19,10, 12,11, 19,11, 12,12, 19,12,
@@ -335,45 +261,57 @@ const uint8_t menuBoxCoords[] PROGMEM = {
 };
 const uint8_t menuBoxCoordsCount = sizeof(menuBoxCoords) / 2;
 
-// Coordonnées des chiffres 1-9 (format: nombre de points, puis x,y,x,y...)
-const uint8_t menuDigit1[] PROGMEM = {
+// Coordonnées des chiffres 1-9 (format: x, y)
+constexpr uint8_t menuDigit1[] PROGMEM = {
   15,7, 16,7, 14,8, 15,8, 16,8, 15,9, 16,9, 15,10, 16,10, 14,11, 15,11, 16,11, 17,11
 };
-const uint8_t menuDigit2[] PROGMEM = {
+constexpr uint8_t menuDigit2[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 17,8, 14,9, 15,9, 16,9, 17,9, 14,10, 14,11, 15,11, 16,11, 17,11
 };
-const uint8_t menuDigit3[] PROGMEM = {
+constexpr uint8_t menuDigit3[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 17,8, 14,9, 15,9, 16,9, 17,9, 17,10, 14,11, 15,11, 16,11, 17,11
 };
-const uint8_t menuDigit4[] PROGMEM = {
+constexpr uint8_t menuDigit4[] PROGMEM = {
   14,7, 16,7, 14,8, 16,8, 14,9, 15,9, 16,9, 17,9, 16,10, 16,11
 };
-const uint8_t menuDigit5[] PROGMEM = {
+constexpr uint8_t menuDigit5[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 14,8, 14,9, 15,9, 16,9, 17,9, 17,10, 14,11, 15,11, 16,11, 17,11
 };
-const uint8_t menuDigit6[] PROGMEM = {
+constexpr uint8_t menuDigit6[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 14,8, 14,9, 15,9, 16,9, 17,9, 14,10, 17,10, 14,11, 15,11, 16,11, 17,11
 };
-const uint8_t menuDigit7[] PROGMEM = {
+constexpr uint8_t menuDigit7[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 17,8, 16,9, 15,10, 14,11
 };
-const uint8_t menuDigit8[] PROGMEM = {
+constexpr uint8_t menuDigit8[] PROGMEM = {
   15,7, 16,7, 14,8, 17,8, 15,9, 16,9, 14,10, 17,10, 15,11, 16,11
 };
-const uint8_t menuDigit9[] PROGMEM = {
+constexpr uint8_t menuDigit9[] PROGMEM = {
   14,7, 15,7, 16,7, 17,7, 14,8, 17,8, 14,9, 15,9, 16,9, 17,9, 17,10, 14,11, 15,11, 16,11, 17,11
 };
 
-const uint8_t menuDigitCounts[] PROGMEM = {0, 13, 14, 14, 10, 14, 15, 8, 10, 15};
-const uint8_t* const menuDigits[] PROGMEM = {
-  nullptr, menuDigit1, menuDigit2, menuDigit3, menuDigit4,
-  menuDigit5, menuDigit6, menuDigit7, menuDigit8, menuDigit9
+// ===== GLYPHES MENU =====
+// Bitmaps 1 bit par pixel générés à la compilation à partir des coordonnées ci-dessus
+// (HT1632_GLYPH_*, quartets des puces) : ht1632_blit() les dessine quartet par quartet
+#define MENU_BOX_X 12
+#define MENU_BOX_Y 4      // multiple de 4 (quartets HT1632)
+#define MENU_DIGIT_X 14
+#define MENU_DIGIT_Y 4
+#define MENU_DIGIT_GLYPH(d) HT1632_GLYPH_4x8(d, sizeof(d) / 2, MENU_DIGIT_X, MENU_DIGIT_Y)
+
+const byte menuBoxGlyph[HT1632_GLYPH_8x12_SIZE] PROGMEM =
+    HT1632_GLYPH_8x12(menuBoxCoords, menuBoxCoordsCount, MENU_BOX_X, MENU_BOX_Y);
+const byte menuDigitGlyphs[10][HT1632_GLYPH_4x8_SIZE] PROGMEM = {
+  {4, 2},
+  MENU_DIGIT_GLYPH(menuDigit1), MENU_DIGIT_GLYPH(menuDigit2), MENU_DIGIT_GLYPH(menuDigit3),
+  MENU_DIGIT_GLYPH(menuDigit4), MENU_DIGIT_GLYPH(menuDigit5), MENU_DIGIT_GLYPH(menuDigit6),
+  MENU_DIGIT_GLYPH(menuDigit7), MENU_DIGIT_GLYPH(menuDigit8), MENU_DIGIT_GLYPH(menuDigit9)
 };
 
 // ===== COORDONNÉES ÉCRAN LOSER =====
 // Coordonnées des espaces VIDES pour l'écran LOSER (format: x, y)
 // L'écran sera rempli en rouge sauf à ces coordonnées qui forment le motif "LOSER"
-const uint8_t loserEmptyCoords[] PROGMEM = {
+constexpr uint8_t loserEmptyCoords[] PROGMEM = {
   1,4, 8,4, 9,4, 10,4, 11,4, 14,4, 15,4, 16,4, 17,4, 18,4, 20,4, 21,4, 22,4, 23,4, 24,4, 26,4, 27,4, 28,4, 29,4,
   1,5, 7,5, 12,5, 14,5, 20,5, 26,5, 30,5,
   1,6, 7,6, 12,6, 14,6, 20,6, 26,6, 30,6,
@@ -387,7 +325,7 @@ const uint16_t loserEmptyCoordsCount = sizeof(loserEmptyCoords) / 2;
 // ===== COORDONNÉES ÉCRAN WINNER =====
 // Coordonnées des espaces VIDES pour l'écran WINNER (format: x, y)
 // L'écran sera rempli en vert sauf à ces coordonnées qui forment le motif "WINNER"
-const uint8_t winnerEmptyCoords[] PROGMEM = {
+constexpr uint8_t winnerEmptyCoords[] PROGMEM = {
   // Ligne 4: pixels vides pour former les lettres WINNER
   1,4, 5,4, 7,4, 9,4, 13,4, 15,4, 19,4, 21,4, 22,4, 23,4, 24,4, 27,4, 28,4, 29,4,
   // Ligne 5: pixels vides
@@ -405,16 +343,22 @@ const uint8_t winnerEmptyCoords[] PROGMEM = {
 };
 const uint16_t winnerEmptyCoordsCount = sizeof(winnerEmptyCoords) / 2;
 
+// ===== IMAGES D'ÉCRAN PRÉCALCULÉES =====
+// Générées à la compilation à partir des listes de coordonnées ci-dessus (HT1632_IMAGE,
+// format des puces) : ht1632_image() les envoie en une écriture à adresses successives par puce
+const byte menuScreen[HT1632_IMAGE_SIZE] PROGMEM =
+    HT1632_IMAGE(menuTextCoords, menuTextCoordsCount, COLOR_GREEN, COLOR_OFF);
+const byte loserScreen[HT1632_IMAGE_SIZE] PROGMEM =
+    HT1632_IMAGE(loserEmptyCoords, loserEmptyCoordsCount, COLOR_OFF, COLOR_RED);
+const byte winnerScreen[HT1632_IMAGE_SIZE] PROGMEM =
+    HT1632_IMAGE(winnerEmptyCoords, winnerEmptyCoordsCount, COLOR_OFF, COLOR_GREEN);
+
 // ===== FONCTIONS AFFICHAGE LOSER =====
 // Dessiner l'écran LOSER complet
 void drawLoserScreen();
-// Effacer l'écran LOSER
-void eraseLoserScreen();
 
 // ===== FONCTIONS AFFICHAGE WINNER =====
 // Dessiner l'écran WINNER complet
 void drawWinnerScreen();
-// Effacer l'écran WINNER
-void eraseWinnerScreen();
 
 #endif // DEFINITIONS_H
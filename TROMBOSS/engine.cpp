@@ -0,0 +1,830 @@
+#include <Arduino.h>
+#include "engine.h"
+#include "song_data.h"
+#if CHART_MODE
+#include "charts.h"
+#endif
+
+static_assert(SONG_LEVELS == MAX_DIFFICULTY_LEVEL, "one song per level");
+#if CHART_MODE
+static_assert(CHART_POOL <= MAX_BLOCKS, "charts.h checked for more live blocks than the pool: run tools/midi2chart --pool MAX_BLOCKS");
+#endif
+
+#define ENGINE_EVENT(e, event, block, value) \
+  do { if ((e)->onEvent) (e)->onEvent((e), (event), (block), (value)); } while (0)
+
+
+/*
+ * engine_levelBpm
+ */
+uint16_t engine_levelBpm(uint8_t level)
+{
+#if CHART_MODE
+  (void)level;
+  return CHART_BPM;  // one thirty-second = one chart tick
+#else
+  switch (level) {
+    case 2: return LEVEL_2_BPM;
+    case 3: return LEVEL_3_BPM;
+    case 4: return LEVEL_4_BPM;
+    case 5: return LEVEL_5_BPM;
+    case 6: return LEVEL_6_BPM;
+    case 7: return LEVEL_7_BPM;
+    case 8: return LEVEL_8_BPM;
+    case 9: return LEVEL_9_BPM;
+    default: return LEVEL_1_BPM;
+  }
+#endif
+}
+
+
+/*
+ * engine_levelColumn
+ * one scroll column of the level, in timeline units.
+ */
+uint16_t engine_levelColumn(uint8_t level)
+{
+  switch (level) {
+#if CHART_MODE
+    case 2: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_2);
+    case 3: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_3);
+    case 4: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_4);
+    case 5: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_5);
+    case 6: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_6);
+    case 7: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_7);
+    case 8: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_8);
+    case 9: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_9);
+    default: return TEMPO_FIXED(BLOCK_MOVE_CYCLES_LEVEL_1);
+#else
+    case 2: return TEMPO_FIXED(LEVEL_2_COLUMN);
+    case 3: return TEMPO_FIXED(LEVEL_3_COLUMN);
+    case 4: return TEMPO_FIXED(LEVEL_4_COLUMN);
+    case 5: return TEMPO_FIXED(LEVEL_5_COLUMN);
+    case 6: return TEMPO_FIXED(LEVEL_6_COLUMN);
+    case 7: return TEMPO_FIXED(LEVEL_7_COLUMN);
+    case 8: return TEMPO_FIXED(LEVEL_8_COLUMN);
+    case 9: return TEMPO_FIXED(LEVEL_9_COLUMN);
+    default: return TEMPO_FIXED(LEVEL_1_COLUMN);
+#endif
+  }
+}
+
+
+/*
+ * tempoStart
+ * back to the level start: first note at once, first move one column later.
+ */
+void tempoStart(Tempo* tempo)
+{
+  uint32_t step = (uint32_t)TIMER_PERIOD * tempo->bpm * 8;  // units * TEMPO_DENOMINATOR per tick
+  tempo->whole = step / TEMPO_DENOMINATOR;
+  tempo->fraction = step % TEMPO_DENOMINATOR;
+  tempo->remainder = 0;
+  tempo->now = 0;
+  tempo->nextMove = tempo->column;
+  tempo->nextSpawn = 0;
+}
+
+
+/*
+ * tempoAdvance
+ * one tick: whole part, then the exact remainder.
+ */
+void tempoAdvance(Tempo* tempo)
+{
+  tempo->now += tempo->whole;
+  tempo->remainder += tempo->fraction;
+  if (tempo->remainder >= TEMPO_DENOMINATOR) {
+    tempo->remainder -= TEMPO_DENOMINATOR;
+    tempo->now++;
+  }
+}
+
+
+/*
+ * tempoLateMicros
+ * less than a tick.
+ */
+uint32_t tempoLateMicros(const Tempo* tempo, uint32_t due)
+{
+  return (tempo->now - due) * TEMPO_DENOMINATOR / (tempo->bpm * 8UL);
+}
+
+
+/*
+ * songStart
+ * level 1..9.
+ */
+void songStart(SongReader* song, uint8_t level)
+{
+  song->level = level - 1;
+  song->section = pgm_read_word(&songLevelStart[song->level]);
+  song->sectionEnd = pgm_read_word(&songLevelStart[song->level + 1]);
+  song->start = song->pos = song->end = 0;
+  song->repeat = 0;
+  song->transpose = 0;
+}
+
+
+/*
+ * songRead
+ * each level is a list of sections (dictionary phrase, transposition,
+ * repeats); a phrase byte gives the note and the code of its duration in
+ * songDurations.
+ */
+bool songRead(SongReader* song, MusicNote* note)
+{
+  while (song->pos >= song->end) {
+    if (song->repeat) {  // phrase played again by the same section
+      song->repeat--;
+      song->pos = song->start;
+      continue;
+    }
+    if (song->section >= song->sectionEnd)
+      return false;
+    const SongSection* section = &songSections[song->section++];
+    uint8_t phrase = pgm_read_byte(&section->phrase);
+    song->transpose = (int8_t)pgm_read_byte(&section->transpose);
+    song->repeat = pgm_read_byte(&section->repeat) - 1;
+    song->start = song->pos = pgm_read_word(&songPhraseStart[phrase]);
+    song->end = pgm_read_word(&songPhraseStart[phrase + 1]);
+  }
+  uint8_t b = pgm_read_byte(&songPhrases[song->pos++]);
+  note->note = SONG_NOTE(b) + song->transpose;
+  note->duration = pgm_read_byte(&songDurations[song->level][SONG_CODE(b)]);
+  return true;
+}
+
+
+// ===== SCORE =====
+
+static void engine_updateTransformed(Engine* e)
+{
+  if (e->score.maxPossible > 0)
+    e->score.transformed = (uint8_t)(((uint32_t)e->score.current * 100) / e->score.maxPossible);
+  else
+    e->score.transformed = 0;
+}
+
+
+// ===== JUDGEMENT =====
+
+/*
+ * engine_columnsLeft
+ * the block still has columns to bring onto x=3 after the one there.
+ */
+static bool engine_columnsLeft(const Engine* e, uint8_t block)
+{
+  return e->blockX[block] + e->blockLength[block] - 1 > CURSOR_COLUMN_START + 1;
+}
+
+
+/*
+ * engine_judgeGrade
+ * the press closes the window of the block: perfect or good by its error.
+ */
+static void engine_judgeGrade(Engine* e, uint32_t error)
+{
+  uint8_t grade;
+  if (error <= JUDGE_PERFECT_US) {
+    e->judge.perfect++;
+    grade = ENGINE_JUDGE_PERFECT;
+  } else {
+    e->judge.good++;
+    grade = ENGINE_JUDGE_GOOD;
+  }
+  uint8_t block = e->judgeBlock;
+  e->judgedMask |= (BlockMask)1 << block;
+  e->judgeBlock = BLOCK_NONE;
+  e->lastPressPending = false;
+  ENGINE_EVENT(e, ENGINE_EVENT_JUDGE, block, grade);
+}
+
+
+/*
+ * engine_judgeMiss
+ */
+static void engine_judgeMiss(Engine* e)
+{
+  e->judge.miss++;
+  e->judgedMask |= (BlockMask)1 << e->judgeBlock;
+  ENGINE_EVENT(e, ENGINE_EVENT_JUDGE, e->judgeBlock, ENGINE_JUDGE_MISS);
+  e->judgeBlock = BLOCK_NONE;
+}
+
+
+/*
+ * engine_judgePress
+ * perfect or good by the distance to the last column crossing of x=3,
+ * cursor aligned on the block. A press nearer the next crossing of the
+ * same block, or before the first one, stays pending until it.
+ */
+static void engine_judgePress(Engine* e, uint32_t time)
+{
+  e->lastPressTime = time;
+  e->lastPressPending = true;
+  if (e->judgeBlock == BLOCK_NONE || e->cursorY != e->blockY[e->judgeBlock])
+    return;
+  int32_t delta = (int32_t)(time - e->judgeTime);
+  uint32_t error = delta < 0 ? -delta : delta;
+  if (error > JUDGE_GOOD_US || (delta > (int32_t)JUDGE_PERFECT_US && engine_columnsLeft(e, e->judgeBlock)))
+    return;
+  engine_judgeGrade(e, error);
+}
+
+
+/*
+ * engine_pressError
+ * distance of the pending press to a crossing of x=3.
+ */
+static uint32_t engine_pressError(const Engine* e, uint32_t crossing)
+{
+  int32_t delta = (int32_t)(e->lastPressTime - crossing);
+  return delta < 0 ? -delta : delta;
+}
+
+
+/*
+ * engine_judgeArrival
+ * a column of the block reaches x=3 (time of the move). Its head opens the
+ * window and closes the one of the previous block; every later column keeps
+ * it open. A pending press is judged against the nearer of this crossing
+ * and the previous one of the same block.
+ */
+static void engine_judgeArrival(Engine* e, uint8_t block, uint32_t time)
+{
+  if (e->judgedMask & ((BlockMask)1 << block))
+    return;
+  uint8_t open = e->judgeBlock;
+  uint32_t error = JUDGE_GOOD_US + 1;
+  if (e->lastPressPending && open != BLOCK_NONE && e->cursorY == e->blockY[open])
+    error = engine_pressError(e, e->judgeTime);
+  if (open != BLOCK_NONE && open != block) {
+    // a press deferred for a later column still counts for the block it followed
+    if (error <= JUDGE_GOOD_US)
+      engine_judgeGrade(e, error);
+    else
+      engine_judgeMiss(e);
+    error = JUDGE_GOOD_US + 1;
+  }
+  e->judgeBlock = block;
+  e->judgeTime = time;
+  if (e->lastPressPending && e->cursorY == e->blockY[block] && engine_pressError(e, time) < error)
+    error = engine_pressError(e, time);
+  if (error <= JUDGE_GOOD_US)
+    engine_judgeGrade(e, error);
+}
+
+
+/*
+ * engine_judgeExpire
+ * last column more than the good window past x=3 with no valid press: miss.
+ */
+static void engine_judgeExpire(Engine* e, uint32_t now)
+{
+  if (e->judgeBlock != BLOCK_NONE && (int32_t)(now - e->judgeTime) > (int32_t)JUDGE_GOOD_US &&
+      !engine_columnsLeft(e, e->judgeBlock))
+    engine_judgeMiss(e);
+}
+
+
+// ===== BLOCK POOL AND BITBOARDS =====
+
+static void engine_poolReset(Engine* e)
+{
+  for (uint8_t i = 0; i < MAX_BLOCKS; i++)
+    e->blockNextFree[i] = (i + 1 < MAX_BLOCKS) ? i + 1 : BLOCK_NONE;
+  e->blockFreeHead = 0;
+  e->blockLiveCount = 0;
+  e->blockActiveMask = 0;
+  e->blockPlayingMask = 0;
+  e->judgedMask = 0;
+  for (uint8_t y = 0; y < MATRIX_HEIGHT; y++) {
+    e->boardBlocks[y] = 0;
+    e->boardSpawn[y] = 0;
+    e->boardHits[y] = 0;
+  }
+}
+
+
+/*
+ * engine_blockFree
+ * its pixels have already left the bitboards on the left.
+ */
+static void engine_blockFree(Engine* e, uint8_t i)
+{
+  BlockMask bit = (BlockMask)1 << i;
+  if (!(e->blockActiveMask & bit))
+    return;
+  e->blockActiveMask &= ~bit;
+  e->blockPlayingMask &= ~bit;
+  e->judgedMask &= ~bit;
+  e->blockNextFree[i] = e->blockFreeHead;
+  e->blockFreeHead = i;
+  e->blockLiveCount--;
+}
+
+
+/*
+ * engine_boardAdd
+ * columns outside 0..39 are ignored.
+ */
+static void engine_boardAdd(Engine* e, int16_t x, uint8_t y, uint8_t length)
+{
+  uint32_t visible = 0;
+  uint8_t spawn = 0;
+  for (int16_t col = x; col < x + length; col++) {
+    if (col >= 0 && col < MATRIX_WIDTH)
+      visible |= 1UL << col;
+    else if (col >= MATRIX_WIDTH && col < MATRIX_WIDTH + BOARD_SPAWN_WIDTH)
+      spawn |= 1 << (col - MATRIX_WIDTH);
+  }
+  for (uint8_t dy = 0; dy < BLOCK_HEIGHT && y + dy < MATRIX_HEIGHT; dy++) {
+    e->boardBlocks[y + dy] |= visible;
+    e->boardSpawn[y + dy] |= spawn;
+  }
+  if (visible & BOARD_GREEN_MASK)
+    e->hitDirty = true;
+}
+
+
+/*
+ * engine_boardShift
+ * column 32 enters the screen, column 0 leaves it.
+ */
+static void engine_boardShift(Engine* e)
+{
+  e->hitDirty = true;
+  for (uint8_t y = 0; y < MATRIX_HEIGHT; y++) {
+    e->boardBlocks[y] = (e->boardBlocks[y] >> 1) | ((uint32_t)(e->boardSpawn[y] & 1) << (MATRIX_WIDTH - 1));
+    e->boardSpawn[y] >>= 1;
+    e->boardHits[y] >>= 1;
+  }
+}
+
+
+/*
+ * engine_spawn
+ * take a block from the pool and place it (room checked by the caller).
+ */
+static void engine_spawn(Engine* e, int16_t x, uint8_t y, uint8_t length, uint8_t note)
+{
+  uint8_t i = e->blockFreeHead;
+  if (i == BLOCK_NONE)
+    return;
+  e->blockFreeHead = e->blockNextFree[i];
+  e->blockActiveMask |= (BlockMask)1 << i;
+  e->blockLiveCount++;
+  e->blockX[i] = x;
+  e->blockY[i] = y;
+  e->blockLength[i] = length;
+  e->blockNote[i] = note;
+  engine_boardAdd(e, x, y, length);
+  e->changed = true;
+  ENGINE_EVENT(e, ENGINE_EVENT_SPAWN, i, note);
+}
+
+
+#if !CHART_MODE
+/*
+ * engine_drop
+ */
+static void engine_drop(Engine* e, uint8_t reason)
+{
+  e->dropped++;
+  ENGINE_EVENT(e, ENGINE_EVENT_DROP, BLOCK_NONE, reason);
+}
+
+
+// ===== SPAWN PLANNER =====
+
+/*
+ * engine_plan
+ * read one more note into the ring and place it: head on the column of
+ * its due date, block before it shortened to leave ENGINE_PLAN_GAP free
+ * columns if it is in the same lane. Bounded: one note, one move per
+ * column of its duration.
+ */
+static void engine_plan(Engine* e)
+{
+  MusicNote note;
+  if (e->planRead || e->planCount >= ENGINE_PLAN_NOTES)
+    return;
+  if (!songRead(&e->song, &note)) {
+    e->planRead = 1;
+    return;
+  }
+  while ((int32_t)(e->planTime - e->planMove) >= 0) {
+    e->planColumn++;
+    e->planMove += e->tempo.column;
+  }
+  uint8_t slot = (e->planHead + e->planCount) & (ENGINE_PLAN_NOTES - 1);
+  PlannedNote* p = &e->plan[slot];
+  p->column = e->planColumn;
+  p->note = note.note;
+  p->duration = note.duration;
+  p->length = pgm_read_byte(&durationLengths[note.duration]);
+  uint8_t row = pgm_read_byte(&noteRows[note.note]);
+  int16_t room = (int16_t)(e->planColumn - e->planLastEnd);  // < 0: overlap
+  if (row == e->planLastRow)
+    room -= ENGINE_PLAN_GAP;
+  if (room < 0 && e->planLast != BLOCK_NONE) {
+    PlannedNote* last = &e->plan[e->planLast];
+    int16_t length = last->length + room;
+    if (length >= 1) {
+      last->length = length;  // not taken yet: shortened
+      room = 0;
+    }
+  }
+  if (room < 0) {
+    p->length = 0;  // too close to a block already on its way
+  } else {
+    e->planLast = slot;
+    e->planLastRow = row;
+    e->planLastEnd = e->planColumn + p->length;
+  }
+  e->planCount++;
+  e->planTime += (uint32_t)note.duration << TEMPO_FRAC_BITS;
+}
+
+
+/*
+ * engine_planStart
+ * after tempoStart(): read the first notes of the level.
+ */
+static void engine_planStart(Engine* e)
+{
+  songStart(&e->song, e->level);
+  e->planHead = 0;
+  e->planCount = 0;
+  e->planLast = BLOCK_NONE;
+  e->planLastRow = BLOCK_NONE;
+  e->planRead = 0;
+  e->planColumn = MATRIX_WIDTH;
+  e->planLastEnd = 0;
+  e->planTime = 0;
+  e->planMove = e->tempo.nextMove;
+  for (uint8_t i = 0; i < ENGINE_PLAN_NOTES; i++)
+    engine_plan(e);
+}
+
+
+/*
+ * engine_nextNote
+ * the note at the head of the ring, its block where it was placed.
+ * Returns its duration (thirty-seconds): the next one is due that much
+ * later on the timeline, block or no block. 0 at the end of the song.
+ */
+static uint8_t engine_nextNote(Engine* e)
+{
+  if (e->planCount < 2)
+    engine_plan(e);  // the length of the head depends on the next note
+  if (!e->planCount) {
+    e->songFinished = 1;
+    return 0;
+  }
+  uint8_t slot = e->planHead;
+  const PlannedNote* p = &e->plan[slot];
+  e->planHead = (slot + 1) & (ENGINE_PLAN_NOTES - 1);
+  e->planCount--;
+  if (e->planLast == slot)
+    e->planLast = BLOCK_NONE;  // taken: no longer shortened
+
+  if (!p->length)
+    engine_drop(e, ENGINE_DROP_SPACING);
+  else if (e->blockFreeHead == BLOCK_NONE)
+    engine_drop(e, ENGINE_DROP_POOL);
+  else  // x = 32 on the due date, less if the tick came after a move
+    engine_spawn(e, (int16_t)(p->column - e->moves), pgm_read_byte(&noteRows[p->note]), p->length, p->note);
+  return p->duration;
+}
+#endif
+
+
+#if CHART_MODE
+// ===== PRECOMPUTED CHARTS =====
+// charts.h comes from tools/midi2chart: lane, length and spacing of the blocks are
+// decided at compile time, only the events are read here at their tick.
+
+/*
+ * engine_chartCurrent
+ * current event, moving to the next parts; false at the end of the chart.
+ */
+static bool engine_chartCurrent(Engine* e, uint16_t* event)
+{
+  uint8_t level = e->level - 1;
+  while (e->chartPos >= pgm_read_word(&chartSizes[level][e->chartPart])) {
+    e->chartPos = 0;
+    if (++e->chartPart >= CHART_PARTS)
+      return false;
+  }
+  const uint16_t* part = (const uint16_t*)pgm_read_ptr(&chartParts[level][e->chartPart]);
+  *event = pgm_read_word(&part[e->chartPos]);
+  return true;
+}
+
+
+/*
+ * engine_chartDelay
+ * chart ticks (thirty-seconds at CHART_BPM) from the previous event.
+ */
+static uint16_t engine_chartDelay(uint16_t event)
+{
+  return CHART_LANE(event) == CHART_WAIT_LANE ? CHART_WAIT_TICKS(event) : CHART_DELTA(event);
+}
+
+
+/*
+ * engine_chartStart
+ * after tempoStart().
+ */
+static void engine_chartStart(Engine* e)
+{
+  uint16_t event;
+  e->chartPart = 0;
+  e->chartPos = 0;
+  e->tempo.nextSpawn = engine_chartCurrent(e, &event) ? (uint32_t)engine_chartDelay(event) << TEMPO_FRAC_BITS : 0;
+}
+
+
+/*
+ * engine_chartTick
+ * spawn the blocks due on the timeline.
+ */
+static void engine_chartTick(Engine* e)
+{
+  uint16_t event;
+  while (!e->songFinished && TEMPO_DUE(&e->tempo, e->tempo.nextSpawn)) {
+    if (!engine_chartCurrent(e, &event)) {
+      e->songFinished = 1;  // empty chart
+      return;
+    }
+    uint8_t lane = CHART_LANE(event);
+    if (lane != CHART_WAIT_LANE) {
+      // same note index as song_patterns.h: octave * 7 + lane
+      engine_spawn(e, MATRIX_WIDTH, lane * BLOCK_HEIGHT, CHART_LENGTH(event), CHART_OCTAVE(event) * NOTE_LANES + lane);
+    }
+    e->chartPos++;
+    if (!engine_chartCurrent(e, &event)) {
+      e->songFinished = 1;  // the last blocks scroll out, then the level ends
+      return;
+    }
+    e->tempo.nextSpawn += (uint32_t)engine_chartDelay(event) << TEMPO_FRAC_BITS;  // 0: same due date
+  }
+}
+#endif
+
+
+/*
+ * engine_scroll
+ * move every block one column (at each tempo.nextMove); moveTime is the
+ * exact time of the due date, to judge arrivals on x=3 finer than a tick.
+ */
+static void engine_scroll(Engine* e, uint32_t moveTime)
+{
+  BlockMask playing = 0;   // blocks on x=2 or x=3 before the move
+  BlockMask pending = e->blockActiveMask;
+  if (pending)
+    e->changed = true;
+  while (pending) {
+    uint8_t i = __builtin_ctzl(pending);
+    pending &= pending - 1;
+
+    int16_t xStart = e->blockX[i];
+    int16_t xEnd = xStart + e->blockLength[i];
+    if ((2 >= xStart && 2 < xEnd) || (3 >= xStart && 3 < xEnd))
+      playing |= (BlockMask)1 << i;
+
+    // a block column passing x=3 (column x=4 moving to x=3) adds its 2 pixels to the max
+    bool crossing = xStart <= 4 && 4 < xEnd;
+    if (crossing) {
+      e->score.maxPossible += 2;
+      engine_updateTransformed(e);
+    }
+
+    e->blockX[i]--;
+    if (crossing)
+      engine_judgeArrival(e, i, moveTime);  // each column is judged as it reaches x=3
+
+    if (e->blockX[i] + e->blockLength[i] < -1)
+      engine_blockFree(e, i);  // fully off screen
+  }
+
+  // voices: a block enters or leaves the green columns
+  BlockMask exited = e->blockPlayingMask & ~playing;
+  BlockMask entered = playing & ~e->blockPlayingMask;
+  e->blockPlayingMask = playing;
+  while (exited) {
+    uint8_t i = __builtin_ctzl(exited);
+    exited &= exited - 1;
+    ENGINE_EVENT(e, ENGINE_EVENT_NOTE_OFF, i, 0);
+  }
+  while (entered) {
+    uint8_t i = __builtin_ctzl(entered);
+    entered &= entered - 1;
+    ENGINE_EVENT(e, ENGINE_EVENT_NOTE_ON, i, e->blockNote[i]);
+  }
+
+  engine_boardShift(e);
+}
+
+
+/*
+ * engine_hit
+ * score the block pixels under the cursor (rows row..row+1) not scored
+ * yet (each pixel of a block counts once: boardHits moves with the
+ * blocks). Only when the green columns or the cursor changed since the
+ * last time: otherwise every pixel there is already scored.
+ */
+static void engine_hit(Engine* e, uint8_t row)
+{
+  if (!e->hitDirty)
+    return;
+  e->hitDirty = false;
+  uint8_t count = 0;
+  for (uint8_t dy = 0; dy < CURSOR_HEIGHT; dy++) {
+    uint8_t y = row + dy;
+    if (y >= MATRIX_HEIGHT)
+      break;
+    uint32_t newHits = e->boardBlocks[y] & BOARD_CURSOR_MASK & ~e->boardHits[y];
+    e->boardHits[y] |= newHits;
+    count += __builtin_popcountl(newHits);
+  }
+  if (!count)
+    return;
+  e->score.current += count;
+  engine_updateTransformed(e);
+  ENGINE_EVENT(e, ENGINE_EVENT_HIT, BLOCK_NONE, count);
+}
+
+
+/*
+ * engine_record
+ */
+static inline void engine_record(Engine* e, uint8_t kind, uint32_t time, uint8_t cursor, bool hit)
+{
+  EngineTrace* trace = e->trace;
+  if (!trace)
+    return;
+  if (trace->count >= trace->capacity) {
+    trace->lost++;
+    return;
+  }
+  EngineTraceStep* step = &trace->steps[trace->count++];
+  step->time = time;
+  step->kind = kind;
+  step->cursor = cursor;
+  step->hit = hit;
+}
+
+
+/*
+ * engine_begin
+ */
+void engine_begin(Engine* e, uint8_t level)
+{
+  if (level < MIN_DIFFICULTY_LEVEL || level > MAX_DIFFICULTY_LEVEL)
+    level = MIN_DIFFICULTY_LEVEL;
+  e->level = level;
+  e->tempo.bpm = engine_levelBpm(level);
+  e->tempo.column = engine_levelColumn(level);
+  tempoStart(&e->tempo);
+  e->moves = 0;
+  e->dropped = 0;
+  e->songFinished = 0;
+#if CHART_MODE
+  songStart(&e->song, level);
+  engine_chartStart(e);
+#else
+  e->chartPart = 0;
+  e->chartPos = 0;
+  engine_planStart(e);
+#endif
+  engine_poolReset(e);
+  e->score.current = 0;
+  e->score.maxPossible = 0;
+  e->score.transformed = 0;
+  e->judge.perfect = 0;
+  e->judge.good = 0;
+  e->judge.miss = 0;
+  e->judgeBlock = BLOCK_NONE;
+  e->judgeTime = 0;
+  e->lastPressTime = 0;
+  e->lastPressPending = false;
+  e->changed = true;
+  e->hitDirty = true;
+  if (e->trace) {
+    e->trace->count = 0;
+    e->trace->lost = 0;
+    e->trace->level = level;
+    e->trace->cursor = e->cursorY;
+  }
+}
+
+
+/*
+ * engine_setTempo
+ * the notes already read are placed again with the new column.
+ */
+void engine_setTempo(Engine* e, uint16_t bpm, uint16_t column)
+{
+  uint32_t firstSpawn = e->tempo.nextSpawn;  // CHART_MODE: first event of the chart
+  e->tempo.bpm = bpm < 1 ? 1 : bpm > TEMPO_MAX_BPM ? TEMPO_MAX_BPM : bpm;
+  e->tempo.column = column < 1 ? 1 : column;
+  tempoStart(&e->tempo);
+  e->tempo.nextSpawn = firstSpawn;
+#if !CHART_MODE
+  engine_planStart(e);
+#endif
+}
+
+
+/*
+ * engine_press
+ */
+void engine_press(Engine* e, uint32_t time)
+{
+  engine_record(e, ENGINE_TRACE_PRESS, time, 0, false);
+  engine_judgePress(e, time);
+}
+
+
+/*
+ * engine_tick
+ * blocks only move on ticks, so a short press between two ticks hits
+ * exactly the pixels that were there during the press.
+ */
+void engine_tick(Engine* e, uint32_t now, uint8_t target, bool hit)
+{
+  engine_record(e, ENGINE_TRACE_TICK, now, target, hit);
+  uint8_t hitRow = e->cursorY;  // where the cursor was during the tick
+  if (hit)
+    engine_hit(e, hitRow);
+  engine_judgeExpire(e, now);
+
+  // the cursor glides one row per tick
+  if (e->cursorY < target) {
+    e->cursorY++;
+    e->changed = true;
+    e->hitDirty = true;
+  } else if (e->cursorY > target) {
+    e->cursorY--;
+    e->changed = true;
+    e->hitDirty = true;
+  }
+
+  // one column at each due date (several per tick if a column is shorter than a tick: the
+  // board between two of them was on screen during the tick, its pixels count too)
+  tempoAdvance(&e->tempo);
+  bool moved = false;
+  while (TEMPO_DUE(&e->tempo, e->tempo.nextMove)) {
+    if (moved && hit)
+      engine_hit(e, hitRow);
+    moved = true;
+    engine_scroll(e, now - tempoLateMicros(&e->tempo, e->tempo.nextMove));
+    e->tempo.nextMove += e->tempo.column;
+    e->moves++;
+    ENGINE_EVENT(e, ENGINE_EVENT_MOVE, BLOCK_NONE, e->blockLiveCount);
+  }
+#if CHART_MODE
+  engine_chartTick(e);
+#else
+  // each note at its due date, the next one a note duration later
+  while (!e->songFinished && TEMPO_DUE(&e->tempo, e->tempo.nextSpawn)) {
+    uint8_t duration = engine_nextNote(e);
+    e->tempo.nextSpawn += (uint32_t)duration << TEMPO_FRAC_BITS;
+    e->changed = true;
+  }
+  engine_plan(e);  // one note read ahead per tick
+#endif
+}
+
+
+/*
+ * engine_finished
+ */
+bool engine_finished(const Engine* e)
+{
+  return e->songFinished && e->blockLiveCount == 0;
+}
+
+
+/*
+ * engine_run
+ */
+uint32_t engine_run(Engine* e, const EngineTrace* trace)
+{
+  uint32_t ticks = 0;
+  e->cursorY = trace->cursor;
+  engine_begin(e, trace->level);
+  for (uint32_t i = 0; i < trace->count; i++) {
+    const EngineTraceStep* step = &trace->steps[i];
+    if (step->kind == ENGINE_TRACE_PRESS) {
+      engine_press(e, step->time);
+    } else {
+      engine_tick(e, step->time, step->cursor, step->hit);
+      ticks++;
+    }
+  }
+  return ticks;
+}
@@ -0,0 +1,316 @@
+/*
+ * engine.h
+ * the rules of a level, with no hardware: blocks, musical timeline, cursor
+ * collisions, judgement and score, all held in one Engine instance.
+ *
+ * The firmware owns one Engine and drives it from the Timer1 tick: button
+ * edges go to engine_press() with their time stamp, then engine_tick()
+ * gets the tick time, the cursor row read from the pot and whether the
+ * button was down. Everything the hardware has to do (voices, debug
+ * prints) comes back through the event callback; the screen is composed
+ * from the engine bitboards. Nothing here touches a pin, a timer or
+ * Serial, so the host can run as many engines as it wants, as fast as it
+ * can.
+ *
+ * An optional EngineTrace records the inputs of a level (start cursor,
+ * ticks and presses); engine_run() replays it and ends in the same state,
+ * score and judgement.
+ */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <Arduino.h>
+#include "notes_frequencies.h"
+#include "song_patterns.h"
+
+// ===== PLAYFIELD =====
+#define MATRIX_WIDTH 32
+#define MATRIX_HEIGHT 16
+#define BLOCK_HEIGHT 2
+#define MAX_BLOCKS 32
+#define CURSOR_HEIGHT 2
+#define CURSOR_COLUMN_START 2     // green columns x=2 and x=3
+
+// note lanes (notes_frequencies.h) fit in the matrix
+static_assert(NOTE_LANE_HEIGHT == BLOCK_HEIGHT && NOTE_LANES * NOTE_LANE_HEIGHT <= MATRIX_HEIGHT,
+              "note lanes outside the matrix");
+
+#if !defined(TIMER_PERIOD)
+#define TIMER_PERIOD 25000  // tick, us (12500 or 10000: smoother moves)
+#endif
+
+#if !defined(CHART_MODE)
+#define CHART_MODE 0  // 1 = blocks read from charts.h (made by tools/midi2chart) instead of song_data.h
+#endif
+
+// ===== LEVELS =====
+#define MIN_DIFFICULTY_LEVEL 1
+#define MAX_DIFFICULTY_LEVEL 9
+
+// Tempo of each level (beats per minute, quarter = 8 thirty-seconds) and one scroll column
+// in thirty-seconds. Notes appear at the pace of their durations: tempos keep the mean rate
+// of the old NOTE_CREATION_CYCLES, columns keep the speed of the old BLOCK_MOVE_CYCLES
+// (~1 s at level 1, ~200 ms at level 9)
+#define LEVEL_1_BPM 136
+#define LEVEL_1_COLUMN 18.0
+#define LEVEL_2_BPM 121
+#define LEVEL_2_COLUMN 14.1
+#define LEVEL_3_BPM 100
+#define LEVEL_3_COLUMN 10.0
+#define LEVEL_4_BPM 76
+#define LEVEL_4_COLUMN 6.35
+#define LEVEL_5_BPM 58
+#define LEVEL_5_COLUMN 3.85
+#define LEVEL_6_BPM 41
+#define LEVEL_6_COLUMN 2.05
+#define LEVEL_7_BPM 35
+#define LEVEL_7_COLUMN 1.4
+#define LEVEL_8_BPM 32
+#define LEVEL_8_COLUMN 1.05
+#define LEVEL_9_BPM 44
+#define LEVEL_9_COLUMN 1.15
+
+// Precomputed charts (CHART_MODE): tools/midi2chart counts 25 ms ticks with a move every
+// BLOCK_MOVE_CYCLES ticks. At 300 bpm a thirty-second lasts 25 ms: one chart tick = one
+// thirty-second, one column = BLOCK_MOVE_CYCLES thirty-seconds
+#define CHART_BPM 300
+#define BLOCK_MOVE_CYCLES_LEVEL_1 40
+#define BLOCK_MOVE_CYCLES_LEVEL_2 35
+#define BLOCK_MOVE_CYCLES_LEVEL_3 30
+#define BLOCK_MOVE_CYCLES_LEVEL_4 25
+#define BLOCK_MOVE_CYCLES_LEVEL_5 20
+#define BLOCK_MOVE_CYCLES_LEVEL_6 15
+#define BLOCK_MOVE_CYCLES_LEVEL_7 12
+#define BLOCK_MOVE_CYCLES_LEVEL_8 10
+#define BLOCK_MOVE_CYCLES_LEVEL_9 8
+
+// ===== MUSICAL TIMELINE =====
+// One timeline per level, in thirty-seconds with TEMPO_FRAC_BITS fraction bits. Each tick
+// adds TIMER_PERIOD us at the level tempo: TIMER_PERIOD * bpm * 8 / TEMPO_DENOMINATOR units,
+// divided once (whole part + accumulated remainder), so it never drifts. Moves (one column
+// every tempo.column units) and spawns (one note every note duration) are due dates on the
+// same line: the fractional position of the blocks is the distance to tempo.nextMove.
+#define TEMPO_FRAC_BITS 8
+#define TEMPO_ONE (1UL << TEMPO_FRAC_BITS)                   // one thirty-second
+#define TEMPO_DENOMINATOR (60000000UL >> TEMPO_FRAC_BITS)    // us * bpm * 8 per unit
+#define TEMPO_FIXED(x) ((uint16_t)((x) * TEMPO_ONE + 0.5))   // thirty-seconds -> units
+#define TEMPO_MAX_BPM 1000
+// due date t of timeline tp reached (modulo 2^32)
+#define TEMPO_DUE(tp, t) ((int32_t)((tp)->now - (t)) >= 0)
+static_assert(TEMPO_DENOMINATOR * TEMPO_ONE == 60000000UL, "minute divisible by TEMPO_ONE");
+static_assert((uint64_t)TIMER_PERIOD * TEMPO_MAX_BPM * 8 < 0x100000000ULL, "step per tick in 32 bits");
+static_assert(60000000UL % (CHART_BPM * 8UL) == 0 && 60000000UL / (CHART_BPM * 8UL) == 25000,
+              "CHART_BPM thirty-second = 25 ms midi2chart tick");
+
+typedef struct {
+  uint32_t now;        // position on the timeline (units since the level start)
+  uint32_t whole;      // step per tick, whole part
+  uint32_t fraction;   // step per tick, remainder (over TEMPO_DENOMINATOR)
+  uint32_t remainder;  // accumulated remainder (< TEMPO_DENOMINATOR)
+  uint32_t nextMove;   // due date of the next one-column move
+  uint32_t nextSpawn;  // due date of the next note
+  uint16_t column;     // one column (units)
+  uint16_t bpm;        // level tempo
+} Tempo;
+
+// ===== SONG READER =====
+// song_data.h (made by tools/songpack): level sections -> dictionary phrases.
+// 16-bit positions: a section or a song can be longer than 255 notes.
+typedef struct {
+  uint16_t section;    // next section of the level in songSections
+  uint16_t sectionEnd; // first section of the next level
+  uint16_t start;      // start of the current phrase in songPhrases
+  uint16_t pos;        // next byte of the phrase
+  uint16_t end;        // end of the phrase
+  uint8_t repeat;      // plays of the phrase left after this one
+  int8_t transpose;    // note index offset of the section
+  uint8_t level;       // row of songDurations
+} SongReader;
+
+// ===== BLOCK POOL =====
+// A block = an index 0..MAX_BLOCKS-1 into separate arrays (structure of arrays). Flags
+// (active, note playing) are bits of masks indexed by block: only live blocks are visited,
+// with __builtin_ctzl().
+typedef uint32_t BlockMask;
+static_assert(MAX_BLOCKS <= 32, "one bit per block in BlockMask");
+#define BLOCK_NONE 0xFF     // end of the free list / no block
+#define BLOCK_MAX_LENGTH 8  // longest block (duration 32)
+
+// ===== SPAWN PLANNER =====
+// Song mode: the next notes are read ahead into a ring and placed before they are due. All
+// blocks move together, so a column counted from the level start (moves + x) never changes:
+// the head of each note gets the column where its due date falls, and the block before it is
+// shortened to keep ENGINE_PLAN_GAP free columns when both are in the same lane (two blocks
+// in a row would read as one), none otherwise. A note too close to the previous block has
+// no block. The tick only takes the note at the head of the ring.
+#if !defined(ENGINE_PLAN_NOTES)
+#define ENGINE_PLAN_NOTES 8   // notes read ahead (power of two, >= 2)
+#endif
+#define ENGINE_PLAN_GAP 1     // free columns between two blocks of the same lane
+static_assert(ENGINE_PLAN_NOTES >= 2 && (ENGINE_PLAN_NOTES & (ENGINE_PLAN_NOTES - 1)) == 0,
+              "ring index wraps with a mask, the head needs the next note");
+
+typedef struct {
+  uint16_t column;    // head column counted from the level start (x = column - moves)
+  uint8_t note;       // note index (notes_frequencies.h)
+  uint8_t duration;   // thirty-seconds to the next note
+  uint8_t length;     // block length, 0 = no block
+} PlannedNote;
+
+// ===== BITBOARDS =====
+// One matrix row = one 32-bit mask, bit x = pixel (x, y). All blocks move together: a move
+// is one shift of each row.
+#define BOARD_SPAWN_WIDTH 8   // columns 32..39: blocks created off screen on the right (length <= 8)
+#define BOARD_GREEN_MASK ((1UL << CURSOR_COLUMN_START) | (1UL << (CURSOR_COLUMN_START + 1)))
+#define BOARD_CURSOR_MASK BOARD_GREEN_MASK  // the cursor sits on the green columns
+
+// ===== SCORE AND JUDGEMENT =====
+typedef struct {
+  uint16_t current;         // pixels hit
+  uint16_t maxPossible;     // pixels that could have been hit (columns past the line)
+  uint8_t transformed;      // current / maxPossible in percent (0-100)
+} Score;
+
+// A press (stamped by button.h) against the nearest crossing of x=3 by a column of the block,
+// cursor aligned; one judgement per block
+#define JUDGE_PERFECT_US 60000UL    // within 60 ms: perfect
+#define JUDGE_GOOD_US 150000UL      // within 150 ms: good; no press in the window: miss
+typedef struct {
+  uint16_t perfect;
+  uint16_t good;
+  uint16_t miss;
+} Judgement;
+
+// ===== EVENTS =====
+enum {
+  ENGINE_EVENT_SPAWN,     // block created (block)
+  ENGINE_EVENT_DROP,      // note with no block (value = ENGINE_DROP_*)
+  ENGINE_EVENT_NOTE_ON,   // block entered the green columns (block, value = note)
+  ENGINE_EVENT_NOTE_OFF,  // block left them (block)
+  ENGINE_EVENT_HIT,       // pixels hit under the cursor (value = pixels)
+  ENGINE_EVENT_JUDGE,     // press judged (block, value = ENGINE_JUDGE_*)
+  ENGINE_EVENT_MOVE       // blocks moved one column (value = live blocks)
+};
+
+enum {
+  ENGINE_DROP_SPACING,    // head on the column of the previous one (+ ENGINE_PLAN_GAP same lane)
+  ENGINE_DROP_POOL        // no free block
+};
+
+enum {
+  ENGINE_JUDGE_PERFECT,
+  ENGINE_JUDGE_GOOD,
+  ENGINE_JUDGE_MISS
+};
+
+typedef struct Engine Engine;
+typedef void (*EngineEventFn)(Engine* engine, uint8_t event, uint8_t block, uint8_t value);
+
+// ===== TRACE =====
+enum {
+  ENGINE_TRACE_TICK,      // engine_tick(time, cursor, hit)
+  ENGINE_TRACE_PRESS      // engine_press(time)
+};
+
+typedef struct {
+  uint32_t time;    // us
+  uint8_t kind;     // ENGINE_TRACE_*
+  uint8_t cursor;   // tick: target row
+  uint8_t hit;      // tick: button down during the tick
+} EngineTraceStep;
+
+typedef struct {
+  EngineTraceStep* steps;
+  uint32_t capacity;
+  uint32_t count;    // steps recorded
+  uint32_t lost;     // steps past the capacity
+  uint8_t level;
+  uint8_t cursor;    // displayed cursor row at engine_begin()
+} EngineTrace;
+
+// ===== ENGINE =====
+struct Engine {
+  uint8_t level;
+  Tempo tempo;
+
+  // song (or chart) reading
+  SongReader song;
+  uint8_t songFinished;    // last note read: the level ends once the blocks are gone
+  uint8_t chartPart;       // CHART_MODE: part (0 intro, 1 verse, 2 chorus, 3 hook)
+  uint16_t chartPos;       // CHART_MODE: event in the part (due: tempo.nextSpawn), 16 bits like chartSizes
+#if !CHART_MODE
+  PlannedNote plan[ENGINE_PLAN_NOTES];  // notes read ahead, the head is due at tempo.nextSpawn
+  uint8_t planHead;
+  uint8_t planCount;
+  uint8_t planLast;        // ring slot of the last note with a block, BLOCK_NONE once taken
+  uint8_t planRead;        // every note of the song is in the ring or gone
+  uint8_t planLastRow;     // row of the last block placed
+  uint16_t planColumn;     // column of the next note read (MATRIX_WIDTH + moves before it)
+  uint16_t planLastEnd;    // column after the last block placed
+  uint32_t planTime;       // due date of the next note read
+  uint32_t planMove;       // first move due after it
+#endif
+  uint16_t moves;          // columns scrolled since engine_begin()
+  uint16_t dropped;        // notes with no block this level
+
+  // block pool (the colour is always the same, the old position is x + 1 after a move,
+  // pixels already hit are in boardHits)
+  int8_t blockX[MAX_BLOCKS];         // head column (-10..39)
+  uint8_t blockY[MAX_BLOCKS];        // top row
+  uint8_t blockLength[MAX_BLOCKS];   // 1..BLOCK_MAX_LENGTH
+  uint8_t blockNote[MAX_BLOCKS];     // note index (notes_frequencies.h)
+  uint8_t blockNextFree[MAX_BLOCKS]; // free list
+  uint8_t blockFreeHead;
+  uint8_t blockLiveCount;
+  BlockMask blockActiveMask;
+  BlockMask blockPlayingMask;        // blocks on the green columns, note playing
+  BlockMask judgedMask;              // blocks whose press was judged (or missed)
+
+  // bitboards
+  uint32_t boardBlocks[MATRIX_HEIGHT];  // pixels of live blocks (columns 0..31)
+  uint8_t boardSpawn[MATRIX_HEIGHT];    // pixels of live blocks (columns 32..39)
+  uint32_t boardHits[MATRIX_HEIGHT];    // block pixels already scored
+  bool hitDirty;                        // green columns or cursor changed since the last hit check
+
+  uint8_t cursorY;         // displayed cursor row, one row per tick towards the target
+
+  Score score;
+  Judgement judge;
+  uint8_t judgeBlock;      // block crossing x=3, waiting for its press
+  uint32_t judgeTime;      // its last column crossing (time of the move)
+  uint32_t lastPressTime;  // last press not judged yet
+  bool lastPressPending;   // press judged at the next column crossing
+
+  bool changed;            // something visible moved; cleared by the caller
+
+  EngineEventFn onEvent;   // optional
+  void* user;              // for onEvent
+  EngineTrace* trace;      // optional input recorder, restarted by engine_begin()
+};
+
+// start a level (cursorY, onEvent, user and trace are kept)
+void engine_begin(Engine* e, uint8_t level);
+// before the first tick: another tempo and column for the level (tools)
+void engine_setTempo(Engine* e, uint16_t bpm, uint16_t column);
+// button press stamped at time (us)
+void engine_press(Engine* e, uint32_t time);
+// one tick at time now (us): collisions if hit, judgement, cursor towards target, moves, spawns
+void engine_tick(Engine* e, uint32_t now, uint8_t target, bool hit);
+// last note read and every block gone
+bool engine_finished(const Engine* e);
+// replay a trace from engine_begin(); e->trace must not be the trace replayed. Returns the ticks
+uint32_t engine_run(Engine* e, const EngineTrace* trace);
+
+// building blocks, for tools that study the timeline or the songs
+uint16_t engine_levelBpm(uint8_t level);
+uint16_t engine_levelColumn(uint8_t level);
+void tempoStart(Tempo* tempo);
+void tempoAdvance(Tempo* tempo);
+// lateness of the current tick on a passed due date, in us
+uint32_t tempoLateMicros(const Tempo* tempo, uint32_t due);
+void songStart(SongReader* song, uint8_t level);
+// next note of the song; false at the end
+bool songRead(SongReader* song, MusicNote* note);
+
+#endif // ENGINE_H
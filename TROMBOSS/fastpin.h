@@ -0,0 +1,41 @@
+/*
+ * fastpin.h
+ * compile-time pin access for the bit-banged buses.
+ * FastPin<6>::high() compiles to a single "sbi" on the Arduino Uno instead of
+ * a digitalWrite() call (pin -> port lookup, timer check, interrupt guard).
+ */
+
+#ifndef FASTPIN_H
+#define FASTPIN_H
+
+#include <Arduino.h>
+
+#if !defined(HT1632_FASTPINS)
+#define HT1632_FASTPINS 1   // 0 = go back to digitalWrite() (for comparison)
+#endif
+
+template <byte PIN>
+struct FastPin
+{
+#if HT1632_FASTPINS && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__))
+  // Uno mapping: D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 (14-19) = PORTC;
+  // PORTB/C/D are in the low I/O space, so |= and &= with a constant mask
+  // become sbi/cbi, which are atomic (safe against interrupts touching the same port)
+  static inline volatile byte& port() { return PIN < 8 ? PORTD : (PIN < 14 ? PORTB : PORTC); }
+  static const byte mask = 1 << (PIN < 8 ? PIN : (PIN < 14 ? PIN - 8 : PIN - 14));
+
+  static inline void high() { port() |= mask; }
+  static inline void low()  { port() &= (byte)~mask; }
+#else
+  static inline void high() { digitalWrite(PIN, HIGH); }
+  static inline void low()  { digitalWrite(PIN, LOW); }
+#endif
+
+  static inline void write(bool level)
+  {
+    if (level) high();
+    else low();
+  }
+};
+
+#endif // FASTPIN_H
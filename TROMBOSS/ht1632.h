@@ -43,25 +43,197 @@
 #define RED    2
 #define ORANGE 3
 
-#define X_MAX 32
-#define Y_MAX 16
-#define CHIP_MAX 4 //Four HT1632Cs on one board
+/*
+ * display geometry, resolved at compile time: a board type gives its size
+ * and the chip / nibble address of each of its pixels, HT1632Chain puts
+ * several boards together. Boards are chained through their 74164 (the
+ * last output of one board feeds pin A of the next), so the chip select
+ * shift register is CHIP_MAX stages long and chip k+1 is output Qk of the
+ * chain; chips are numbered board by board, boards row by row.
+ */
+
+// Sure Electronics 3216 board: four 16x8 chips, top left, top right,
+// bottom left, bottom right; in a chip, 2 nibbles per column (green plane,
+// red plane 32 addresses further), top pixel in bit 3
+struct HT1632Board3216
+{
+  enum { width = 32, height = 16, chips = 4 };
+
+  // chip (0-3) of pixel (x, y)
+  static constexpr byte chip(byte x, byte y) { return x / 16 + (y / 8) * 2; }
+  // green nibble address of pixel (x, y) in its chip
+  static constexpr byte addr(byte x, byte y) { return ((x % 16) << 1) + ((y % 8) >> 2); }
+  // bit of pixel (x, y) in its nibble
+  static constexpr byte bit(byte y) { return 8 >> (y & 3); }
+  // top pixel of nibble addr (0-63) of chip
+  static constexpr byte nibblex(byte chip, byte addr) { return (chip & 1) * 16 + ((addr & 31) >> 1); }
+  static constexpr byte nibbley(byte chip, byte addr) { return (chip >> 1) * 8 + (addr & 1) * 4; }
+};
+
+// smallest unsigned type with one bit per chip
+template <byte CHIPS, bool BYTE = (CHIPS <= 8), bool WORD = (CHIPS <= 16)>
+struct HT1632Mask { typedef uint32_t type; };
+template <byte CHIPS, bool WORD>
+struct HT1632Mask<CHIPS, true, WORD> { typedef uint8_t type; };
+template <byte CHIPS>
+struct HT1632Mask<CHIPS, false, true> { typedef uint16_t type; };
+
+// BOARDS_X x BOARDS_Y boards of type BOARD
+template <class BOARD, byte BOARDS_X, byte BOARDS_Y>
+struct HT1632Chain
+{
+  typedef BOARD Board;
+  enum {
+    boards = BOARDS_X * BOARDS_Y,
+    width = BOARD::width * BOARDS_X,
+    height = BOARD::height * BOARDS_Y,
+    chips = BOARD::chips * BOARDS_X * BOARDS_Y
+  };
+  typedef typename HT1632Mask<chips>::type Mask;   // one bit per chip, chip k+1 in bit k
+
+  // chip (0 to chips-1) of pixel (x, y)
+  static constexpr byte chip(byte x, byte y)
+  {
+    return ((y / BOARD::height) * BOARDS_X + x / BOARD::width) * BOARD::chips +
+           BOARD::chip(x % BOARD::width, y % BOARD::height);
+  }
+  static constexpr byte addr(byte x, byte y) { return BOARD::addr(x % BOARD::width, y % BOARD::height); }
+  static constexpr byte bit(byte y) { return BOARD::bit(y % BOARD::height); }
+  static constexpr Mask chipbit(byte chip) { return (Mask)((Mask)1 << chip); }
+  static constexpr Mask all() { return (Mask)((2UL << (chips - 1)) - 1); }
+};
+
+#if !defined(HT1632_BOARDS_X)
+#define HT1632_BOARDS_X 1   // boards side by side
+#endif
+#if !defined(HT1632_BOARDS_Y)
+#define HT1632_BOARDS_Y 1   // rows of boards
+#endif
+typedef HT1632Chain<HT1632Board3216, HT1632_BOARDS_X, HT1632_BOARDS_Y> HT1632Panel;
+typedef HT1632Panel::Board HT1632Board;
+
+static_assert(HT1632Panel::chips <= 32, "at most 32 chips on the chip select chain");
+static_assert(HT1632Panel::width <= 255 && HT1632Panel::height <= 255, "coordinates fit in a byte");
+
+#define X_MAX HT1632Panel::width
+#define Y_MAX HT1632Panel::height
+#define CHIP_MAX HT1632Panel::chips
 #define CLK_DELAY
+// HT1632_FASTPINS (fastpin.h): direct port writes for the bus pins, -DHT1632_FASTPINS=0 = digitalWrite()
+#define HT1632_BENCHMARK 0 // run ht1632_benchmark() from setup() and print the results
+#define HT1632_FLUSH_GAP 2 // clean nibbles resent by ht1632_flush() to merge two dirty runs
 
 
 #define plot(x,y,v)  ht1632_plot(x,y,v)
 #define cls          ht1632_clear
 
 
-// our own copy of the "video" memory; 64 bytes for each of the 4 screen quarters;
+// our own copy of the "video" memory; 64 bytes for each chip (screen quarter of a board);
 // each 64-element array maps 2 planes:
 // indexes from 0 to 31 are allocated for green plane;
 // indexes from 32 to 63 are allocated for red plane;
 // when a bit is 1 in both planes, it is displayed as orange (green + red);
-extern byte ht1632_shadowram[64][4];
+extern byte ht1632_shadowram[64][CHIP_MAX];
+// dirty nibbles of the shadow memory waiting for ht1632_flush() (frame mode only);
+extern byte ht1632_dirty[CHIP_MAX][8];
+extern byte ht1632_framemode;
+// clock pulses sent on the bus since power up (WR clock + 74164 clock);
+extern unsigned long ht1632_busbits;
 extern unsigned char Tab7Segts[];
 
 
+/*
+ * full screen images: for each chip, its 64 nibbles (green plane at
+ * addresses 0-31, red plane at 32-63) packed two per byte, first address in
+ * the high nibble, which is the order they are clocked out in a
+ * successive-address write. HT1632_IMAGE_SIZE bytes, stored in PROGMEM.
+ * HT1632_IMAGE(coords, count, in, out) builds one at compile time from a
+ * list of "count" x,y pairs: listed pixels get color "in", the others "out".
+ * An image covers the first board (HT1632Board3216), the other boards of a
+ * chain are cleared by ht1632_image().
+ */
+#define HT1632_IMAGE_SIZE (HT1632Board::chips * 32)
+static_assert(HT1632Board::chips == 4, "HT1632_IMAGE() lists the nibbles of 4 chips");
+
+// is (x, y) one of the "count" x,y pairs of coords?
+constexpr bool ht1632_incoords(const byte* coords, unsigned count, byte x, byte y)
+{
+  return count && ((coords[2*count-2] == x && coords[2*count-1] == y) ||
+                   ht1632_incoords(coords, count - 1, x, y));
+}
+
+// bit "bitval" of a nibble: pixel (x, y) present in the plane (GREEN or RED)?
+constexpr byte ht1632_imagebit(const byte* coords, unsigned count, byte in, byte out,
+                               byte plane, byte x, byte y, byte bitval)
+{
+  return ((ht1632_incoords(coords, count, x, y) ? in : out) & plane) ? bitval : 0;
+}
+
+// nibble at address addr of chip (0-3), same mapping as ht1632_plot()
+constexpr byte ht1632_imagenibble(const byte* coords, unsigned count, byte in, byte out,
+                                  byte chip, byte addr)
+{
+  return ht1632_imagebit(coords, count, in, out, addr < 32 ? GREEN : RED, HT1632Board::nibblex(chip, addr),
+                         HT1632Board::nibbley(chip, addr) + 0, 8) |
+         ht1632_imagebit(coords, count, in, out, addr < 32 ? GREEN : RED, HT1632Board::nibblex(chip, addr),
+                         HT1632Board::nibbley(chip, addr) + 1, 4) |
+         ht1632_imagebit(coords, count, in, out, addr < 32 ? GREEN : RED, HT1632Board::nibblex(chip, addr),
+                         HT1632Board::nibbley(chip, addr) + 2, 2) |
+         ht1632_imagebit(coords, count, in, out, addr < 32 ? GREEN : RED, HT1632Board::nibblex(chip, addr),
+                         HT1632Board::nibbley(chip, addr) + 3, 1);
+}
+
+#define HT1632_IMAGE_BYTE(c, n, in, out, i) \
+  (byte)(ht1632_imagenibble(c, n, in, out, (i) >> 5, ((i) & 31) * 2) << 4 | \
+         ht1632_imagenibble(c, n, in, out, (i) >> 5, ((i) & 31) * 2 + 1))
+#define HT1632_IMAGE_4(c, n, in, out, i) \
+  HT1632_IMAGE_BYTE(c, n, in, out, i), HT1632_IMAGE_BYTE(c, n, in, out, (i) + 1), \
+  HT1632_IMAGE_BYTE(c, n, in, out, (i) + 2), HT1632_IMAGE_BYTE(c, n, in, out, (i) + 3)
+#define HT1632_IMAGE_32(c, n, in, out, i) \
+  HT1632_IMAGE_4(c, n, in, out, i), HT1632_IMAGE_4(c, n, in, out, (i) + 4), \
+  HT1632_IMAGE_4(c, n, in, out, (i) + 8), HT1632_IMAGE_4(c, n, in, out, (i) + 12), \
+  HT1632_IMAGE_4(c, n, in, out, (i) + 16), HT1632_IMAGE_4(c, n, in, out, (i) + 20), \
+  HT1632_IMAGE_4(c, n, in, out, (i) + 24), HT1632_IMAGE_4(c, n, in, out, (i) + 28)
+#define HT1632_IMAGE(c, n, in, out) { \
+  HT1632_IMAGE_32(c, n, in, out, 0), HT1632_IMAGE_32(c, n, in, out, 32), \
+  HT1632_IMAGE_32(c, n, in, out, 64), HT1632_IMAGE_32(c, n, in, out, 96) }
+
+
+/*
+ * glyphs: 1 bit per pixel, stored as whole nibbles of the chip memory so the
+ * blitter never has to shift bits. In PROGMEM: width, number of nibble rows
+ * (4 pixels high each), then the nibbles column by column (top to bottom),
+ * two per byte, high nibble first; in a nibble the top pixel is bit 3, like
+ * in the chip. HT1632_GLYPH_4x8() and HT1632_GLYPH_8x12() build one at
+ * compile time from a list of "count" x,y pairs, (x, y) being the top left
+ * corner of the glyph; y must be a multiple of 4.
+ */
+#define HT1632_GLYPH_HEADER 2
+
+// nibble of the glyph for column x, pixels y to y+3
+constexpr byte ht1632_glyphnibble(const byte* coords, unsigned count, byte x, byte y)
+{
+  return (ht1632_incoords(coords, count, x, y) ? 8 : 0) |
+         (ht1632_incoords(coords, count, x, y + 1) ? 4 : 0) |
+         (ht1632_incoords(coords, count, x, y + 2) ? 2 : 0) |
+         (ht1632_incoords(coords, count, x, y + 3) ? 1 : 0);
+}
+
+#define HT1632_GLYPH_NIBBLE(c, n, x, y, rows, k) \
+  ht1632_glyphnibble(c, n, (x) + (k) / (rows), (y) + ((k) % (rows)) * 4)
+#define HT1632_GLYPH_BYTE(c, n, x, y, rows, i) \
+  (byte)(HT1632_GLYPH_NIBBLE(c, n, x, y, rows, 2 * (i)) << 4 | \
+         HT1632_GLYPH_NIBBLE(c, n, x, y, rows, 2 * (i) + 1))
+#define HT1632_GLYPH_4(c, n, x, y, rows, i) \
+  HT1632_GLYPH_BYTE(c, n, x, y, rows, i), HT1632_GLYPH_BYTE(c, n, x, y, rows, (i) + 1), \
+  HT1632_GLYPH_BYTE(c, n, x, y, rows, (i) + 2), HT1632_GLYPH_BYTE(c, n, x, y, rows, (i) + 3)
+#define HT1632_GLYPH_4x8(c, n, x, y) { 4, 2, HT1632_GLYPH_4(c, n, x, y, 2, 0) }
+#define HT1632_GLYPH_8x12(c, n, x, y) { 8, 3, \
+  HT1632_GLYPH_4(c, n, x, y, 3, 0), HT1632_GLYPH_4(c, n, x, y, 3, 4), \
+  HT1632_GLYPH_4(c, n, x, y, 3, 8) }
+#define HT1632_GLYPH_4x8_SIZE (HT1632_GLYPH_HEADER + 4)
+#define HT1632_GLYPH_8x12_SIZE (HT1632_GLYPH_HEADER + 12)
+
 /*
  * Set these constants to the values of the pins connected to the SureElectronics Module
  */
@@ -80,9 +252,16 @@ void OutputA_74164(unsigned char x);
 void ChipSelect(int select);
 void ht1632_writebits (byte bits, byte firstbit);
 void ht1632_sendcmd (byte chipNo, byte command);
-static void ht1632_senddata (byte chipNo, byte address, byte data);
 void ht1632_setup();
 void ht1632_plot (byte x, byte y, byte color);
 void ht1632_clear();
+void ht1632_fill(byte color);
+void ht1632_image(const byte* image);
+void ht1632_blit(const byte* glyph, byte x, byte y, byte color);
+void ht1632_beginframe();
+void ht1632_flush();
 void setup7Seg(void);
+#if HT1632_BENCHMARK
+void ht1632_benchmark();
+#endif
 
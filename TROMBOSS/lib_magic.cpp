@@ -1,9 +1,33 @@
-#include <Wire.h>
 #include <Arduino.h>
 #include "ht1632.h"
+#include "seg7.h"
+#include "fastpin.h"
 #include <avr/pgmspace.h>
 
-byte ht1632_shadowram[64][4] = {0};
+byte ht1632_shadowram[64][CHIP_MAX] = {0};
+
+// frame mode: ht1632_plot() only updates the shadow ram and marks the modified
+// nibbles as dirty; ht1632_flush() then sends them with successive-address writes.
+// one bit per shadow ram address (64 addresses = 8 bytes) for each chip;
+// frames nest: ht1632_framemode counts the ht1632_beginframe() calls not yet
+// flushed, only the outermost ht1632_flush() sends;
+byte ht1632_dirty[CHIP_MAX][8] = {0};
+byte ht1632_framemode = 0;
+// chips with at least one dirty nibble (bit k = chip k+1), so that
+// ht1632_flush() does not scan the clean ones
+static HT1632Panel::Mask ht1632_dirtychips = 0;
+
+// number of clock pulses sent on the bus (HT1632 WR clock + 74164 clock);
+// read it before and after a drawing sequence to measure its cost;
+unsigned long ht1632_busbits = 0;
+
+// outputs of the 74164 chain currently low (bit k = output Qk, i.e. chip k+1 selected);
+// unknown at power up, so assume they are all low: the first ChipSelect()
+// then shifts everything out like the original code did;
+static HT1632Panel::Mask ht1632_cszeros = HT1632Panel::all();
+// level currently on pin A of the 74164 (2 = unknown);
+static byte ht1632_cslevel = 2;
+
 unsigned char Tab7Segts[]={0x7E,0x06,0xDA,0x9E,0xA6,0xBC,0xFC,0x0E,0xFE,0xBE};
 
 
@@ -17,8 +41,9 @@ unsigned char Tab7Segts[]={0x7E,0x06,0xDA,0x9E,0xA6,0xBC,0xFC,0x0E,0xFE,0xBE};
 //**************************************************************************************************
 void OutputCLK_Pulse(void) //Output a clock pulse
 {
-  digitalWrite(ht1632_clk, HIGH);
-  digitalWrite(ht1632_clk, LOW);
+  FastPin<ht1632_clk>::high();
+  FastPin<ht1632_clk>::low();
+  ht1632_busbits++;
 }
 
 
@@ -30,7 +55,45 @@ void OutputCLK_Pulse(void) //Output a clock pulse
 //**************************************************************************************************
 void OutputA_74164(unsigned char x) //Input a digital level to 74164
 {
-  digitalWrite(ht1632_cs, (x==1 ? HIGH : LOW));
+  x = (x==1 ? HIGH : LOW);
+  if (x == ht1632_cslevel)
+    return;
+  FastPin<ht1632_cs>::write(x);
+  ht1632_cslevel = x;
+}
+
+
+/*
+ * ht1632_csshift
+ * clock "clocks" bits into the 74164: all ones, except the one that ends
+ * up on output Q<zeropos> (zeropos >= CHIP_MAX: no zero at all).
+ */
+static void ht1632_csshift(byte clocks, byte zeropos)
+{
+  for (byte c = 1; c <= clocks; c++)
+  {
+    OutputA_74164(clocks - c == zeropos ? 0 : 1);
+    CLK_DELAY;
+    OutputCLK_Pulse();
+  }
+  ht1632_cszeros = clocks < CHIP_MAX ? (HT1632Panel::Mask)(ht1632_cszeros << clocks) & HT1632Panel::all() : 0;
+  if (zeropos < CHIP_MAX)
+    ht1632_cszeros |= HT1632Panel::chipbit(zeropos);
+}
+
+
+/*
+ * ht1632_csclear
+ * number of clocks needed to shift every low output out of the 74164.
+ */
+static byte ht1632_csclear()
+{
+  for (byte k = 0; k < CHIP_MAX; k++)
+  {
+    if (ht1632_cszeros & HT1632Panel::chipbit(k))
+      return CHIP_MAX - k;
+  }
+  return 0;
 }
 
 
@@ -42,45 +105,51 @@ void OutputA_74164(unsigned char x) //Input a digital level to 74164
 // If s<0, select all.
 //Output Argument: void
 //**************************************************************************************************
+// The state of the 74164 is tracked in ht1632_cszeros, so only the clocks
+// needed to go from the current selection to the new one are sent:
+// - chip n selected -> chip m > n: m-n clocks, the zero just moves forward;
+// - otherwise the old zero is shifted out while the new one is shifted in.
+// A chip selected again gets its CS back high for at least one clock, which
+// ends its previous command. The chips crossed on the way are briefly selected
+// without any WR clock, which the HT1632 ignores.
+// The last chip can stay selected after a write: the next ChipSelect() ends it.
 void ChipSelect(int select)
 {
   unsigned char tmp = 0;
   if(select<0) //Enable all HT1632Cs
   {
+    ht1632_csshift(ht1632_csclear(), CHIP_MAX); // end the current command first
     OutputA_74164(0);
     CLK_DELAY;
     for(tmp=0; tmp<CHIP_MAX; tmp++)
     {
       OutputCLK_Pulse();
     }
+    ht1632_cszeros = HT1632Panel::all();
   }
   else if(select==0) //Disable all HT1632Cs
   {
-    OutputA_74164(1);
-    CLK_DELAY;
-    for(tmp=0; tmp<CHIP_MAX; tmp++)
-    {
-      OutputCLK_Pulse();
-    }
+    ht1632_csshift(ht1632_csclear(), CHIP_MAX);
   }
   else
   {
-    OutputA_74164(1);
-    CLK_DELAY;
-    for(tmp=0; tmp<CHIP_MAX; tmp++)
+    HT1632Panel::Mask target = HT1632Panel::chipbit(select-1);
+    if (ht1632_cszeros && !(ht1632_cszeros & (ht1632_cszeros-1)) && ht1632_cszeros < target)
     {
-      OutputCLK_Pulse();
+      // a single chip before this one is selected: move its zero forward
+      for (tmp = 0; (HT1632Panel::Mask)(ht1632_cszeros<<tmp) != target; tmp++)
+        ;
+      ht1632_csshift(tmp, CHIP_MAX);
     }
-    OutputA_74164(0);
-    CLK_DELAY;
-    OutputCLK_Pulse();
-    CLK_DELAY;
-    OutputA_74164(1);
-    CLK_DELAY;
-    tmp = 1;
-    for( ; tmp<select; tmp++)
+    else
     {
-      OutputCLK_Pulse();
+      tmp = ht1632_csclear();
+      // the new zero needs "select" clocks to reach its output, one more if
+      // this output is low already (it must go high between two commands)
+      byte minclocks = (ht1632_cszeros & target) ? select + 1 : select;
+      if (tmp < minclocks)
+        tmp = minclocks;
+      ht1632_csshift(tmp, select - 1);
     }
   }
 }
@@ -97,15 +166,11 @@ void ht1632_writebits (byte bits, byte firstbit)
 {
   DEBUGPRINT(" ");
   while (firstbit) {
+    ht1632_busbits++;
     DEBUGPRINT((bits&firstbit ? "1" : "0"));
-    digitalWrite(ht1632_wrclk, LOW);
-    if (bits & firstbit) {
-      digitalWrite(ht1632_data, HIGH);
-    } 
-    else {
-      digitalWrite(ht1632_data, LOW);
-    }
-    digitalWrite(ht1632_wrclk, HIGH);
+    FastPin<ht1632_wrclk>::low();
+    FastPin<ht1632_data>::write(bits & firstbit);
+    FastPin<ht1632_wrclk>::high();
     firstbit >>= 1;
   }
 }
@@ -115,7 +180,7 @@ void ht1632_writebits (byte bits, byte firstbit)
  * ht1632_sendcmd
  * Send a command to the ht1632 chip.
  */
-static void ht1632_sendcmd (byte chipNo, byte command)
+void ht1632_sendcmd (byte chipNo, byte command)
 {
   ChipSelect(chipNo);
   ht1632_writebits(HT1632_ID_CMD, 1<<2);  // send 3 bits of id: COMMMAND
@@ -133,6 +198,7 @@ static void ht1632_sendcmd (byte chipNo, byte command)
  * Note that the address is sent MSB first, while the data is sent LSB first!
  * This means that somewhere a bit reversal will have to be done to get
  * zero-based addressing of words and dots within words.
+ * The chip is left selected: the next ChipSelect() ends the command.
  */
 static void ht1632_senddata (byte chipNo, byte address, byte data)
 {
@@ -140,7 +206,6 @@ static void ht1632_senddata (byte chipNo, byte address, byte data)
   ht1632_writebits(HT1632_ID_WR, 1<<2);  // send ID: WRITE to RAM
   ht1632_writebits(address, 1<<6); // Send address
   ht1632_writebits(data, 1<<3); // send 4 bits of data
-  ChipSelect(0);
 }
 
 
@@ -152,7 +217,7 @@ void ht1632_setup()
   pinMode(ht1632_data, OUTPUT);
   pinMode(ht1632_clk, OUTPUT);
 
-  for (int j=1; j<5; j++)
+  for (int j=1; j<=CHIP_MAX; j++)
   {
     ht1632_sendcmd(j, HT1632_CMD_SYSDIS);  // Disable system
     ht1632_sendcmd(j, HT1632_CMD_COMS00);
@@ -164,120 +229,400 @@ void ht1632_setup()
   
   for (byte i=0; i<96; i++)
   {
-    ht1632_senddata(1, i, 0);  // clear the display!
-    ht1632_senddata(2, i, 0);  // clear the display!
-    ht1632_senddata(3, i, 0);  // clear the display!
-    ht1632_senddata(4, i, 0);  // clear the display!
+    for (byte j=1; j<=CHIP_MAX; j++)
+      ht1632_senddata(j, i, 0);  // clear the display!
   }
   delay(LONGDELAY);
 }
 
 
+/*
+ * ht1632_writenibble
+ * update one nibble of the shadow memory; in frame mode the nibble is only
+ * marked dirty (if its value changed), otherwise it is sent right away.
+ */
+static void ht1632_writenibble (byte chipNo, byte addr, byte data)
+{
+  if (ht1632_framemode) {
+    if (ht1632_shadowram[addr][chipNo-1] != data) {
+      ht1632_shadowram[addr][chipNo-1] = data;
+      ht1632_dirty[chipNo-1][addr>>3] |= 1<<(addr&7);
+      ht1632_dirtychips |= HT1632Panel::chipbit(chipNo-1);
+    }
+    return;
+  }
+  ht1632_shadowram[addr][chipNo-1] = data;
+  ht1632_senddata(chipNo, addr, data);
+}
+
+
 /*
  * plot a point on the display, with the upper left hand corner
- * being (0,0), and the lower right hand corner being (31, 15);
+ * being (0,0), and the lower right hand corner being (X_MAX-1, Y_MAX-1);
  * parameter "color" could have one of the 4 values:
  * black (off), red, green or yellow;
  */
 void ht1632_plot (byte x, byte y, byte color)
 {
-  if (x<0 || x>X_MAX || y<0 || y>Y_MAX)
+  if (x>=X_MAX || y>=Y_MAX)
     return;
   
   if (color != BLACK && color != GREEN && color != RED && color != ORANGE)
     return;
   
-  byte nChip = 1 + x/16 + (y>7?2:0) ;
-  x = x % 16;
-  y = y % 8;
-  byte addr = (x<<1) + (y>>2);
-  byte bitval = 8>>(y&3);  // compute which bit will need set
+  byte nChip = 1 + HT1632Panel::chip(x, y);
+  byte addr = HT1632Panel::addr(x, y);
+  byte bitval = HT1632Panel::bit(y);  // compute which bit will need set
+  byte green = ht1632_shadowram[addr][nChip-1];
+  byte red = ht1632_shadowram[addr+32][nChip-1];
   switch (color)
   {
     case BLACK:
       // clear the bit in both planes;
-      ht1632_shadowram[addr][nChip-1] &= ~bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
-      addr = addr + 32;
-      ht1632_shadowram[addr][nChip-1] &= ~bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
+      green &= ~bitval;
+      red &= ~bitval;
       break;
     case GREEN:
       // set the bit in the green plane and clear the bit in the red plane;
-      ht1632_shadowram[addr][nChip-1] |= bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
-      addr = addr + 32;
-      ht1632_shadowram[addr][nChip-1] &= ~bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
+      green |= bitval;
+      red &= ~bitval;
       break;
     case RED:
       // clear the bit in green plane and set the bit in the red plane;
-      ht1632_shadowram[addr][nChip-1] &= ~bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
-      addr = addr + 32;
-      ht1632_shadowram[addr][nChip-1] |= bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
+      green &= ~bitval;
+      red |= bitval;
       break;
     case ORANGE:
       // set the bit in both the green and red planes;
-      ht1632_shadowram[addr][nChip-1] |= bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
-      addr = addr + 32;
-      ht1632_shadowram[addr][nChip-1] |= bitval;
-      ht1632_senddata(nChip, addr, ht1632_shadowram[addr][nChip-1]);
+      green |= bitval;
+      red |= bitval;
       break;
   }
+  ht1632_writenibble(nChip, addr, green);
+  ht1632_writenibble(nChip, addr + 32, red);
+}
+
+
+/*
+ * ht1632_beginframe
+ * enter frame mode: following ht1632_plot() calls only update the shadow
+ * memory, nothing is sent until ht1632_flush() is called.
+ * Can be nested (a glyph drawn inside a frame, an interrupt drawing while
+ * loop() is building one): the outermost ht1632_flush() sends everything.
+ */
+void ht1632_beginframe()
+{
+  ht1632_framemode++;
+}
+
+
+/*
+ * ht1632_nextrun
+ * next run of dirty nibbles of chip from *addr: its first and last
+ * addresses, false if the chip has no dirty nibble left after *addr.
+ * Two runs separated by a small gap are merged: resending a clean nibble
+ * (4 bits) is cheaper than a new chip select + ID + address (>= 10 bits).
+ */
+static bool ht1632_nextrun(byte chip, byte* addr, byte* end)
+{
+  byte a = *addr;
+  while (a < 64)
+  {
+    // skip 8 clean nibbles at once
+    if (!(a & 7) && !ht1632_dirty[chip][a>>3]) {
+      a += 8;
+      continue;
+    }
+    // look for the start of a dirty run
+    if (!(ht1632_dirty[chip][a>>3] & (1<<(a&7)))) {
+      a++;
+      continue;
+    }
+    // extend the run while the next dirty nibble is close enough
+    *addr = a;
+    *end = a;
+    for (byte next = a + 1; next < 64 && next <= *end + HT1632_FLUSH_GAP + 1; next++)
+    {
+      if (ht1632_dirty[chip][next>>3] & (1<<(next&7)))
+        *end = next;
+    }
+    return true;
+  }
+  return false;
+}
+
+
+/*
+ * ht1632_flush
+ * send the dirty nibbles of each chip and leave frame mode.
+ * Consecutive dirty addresses are sent in a single successive-address write
+ * (ID + start address, then one nibble per address, like ht1632_clear()).
+ * A chip selected again must first have the zero of the 74164 chain shifted
+ * out, up to CHIP_MAX clocks, so its runs are not sent back to back: each
+ * pass sends the next run of every dirty chip in chain order, the zero only
+ * walks forward, and a pass costs about CHIP_MAX select clocks whatever the
+ * number of runs. Clean chips are skipped: the cost of a frame grows linearly
+ * with the number of chips it touches.
+ */
+void ht1632_flush()
+{
+  if (ht1632_framemode > 1) {
+    ht1632_framemode--;
+    return;
+  }
+  byte resume[CHIP_MAX];   // next address to look at, for each chip
+  for (byte chip = 0; chip < CHIP_MAX; chip++)
+    resume[chip] = 0;
+  while (ht1632_dirtychips)
+  {
+    for (byte chip = 0; chip < CHIP_MAX; chip++)
+    {
+      if (!(ht1632_dirtychips & HT1632Panel::chipbit(chip)))
+        continue;
+      byte start = resume[chip];
+      byte end;
+      if (!ht1632_nextrun(chip, &start, &end)) {
+        for (byte i = 0; i < 8; i++)
+          ht1632_dirty[chip][i] = 0;
+        ht1632_dirtychips &= ~HT1632Panel::chipbit(chip);
+        continue;
+      }
+      ChipSelect(chip + 1);
+      ht1632_writebits(HT1632_ID_WR, 1<<2);  // send ID: WRITE to RAM
+      ht1632_writebits(start, 1<<6); // Send start address
+      for (byte addr = start; addr <= end; addr++)
+        ht1632_writebits(ht1632_shadowram[addr][chip], 1<<3); // send 4 bits of data
+      resume[chip] = end + 1;
+    }
+  }
+  ChipSelect(0);
+  ht1632_framemode = 0;
+}
+
+
+/*
+ * ht1632_burst
+ * one successive-address write of a whole chip memory: ID + address 0, then
+ * the 64 nibbles, two per byte (high nibble first); "select" is passed to
+ * ChipSelect(), so -1 writes the same data to every chip at once.
+ * "data" is in PROGMEM, or null for a uniform green / red plane fill.
+ */
+static void ht1632_burst(int select, const byte* data, byte green, byte red)
+{
+  ChipSelect(select);
+  ht1632_writebits(HT1632_ID_WR, 1<<2);  // send ID: WRITE to RAM
+  ht1632_writebits(0, 1<<6); // Send address
+  for (byte i = 0; i < 32; i++)
+    ht1632_writebits(data ? pgm_read_byte(&data[i]) : (i < 16 ? green : red), 1<<7); // send 8 bits of data
+}
+
+
+/*
+ * ht1632_fill
+ * fill the whole display with one color: a single write broadcast to all
+ * the chips (ChipSelect(-1)), then the same values in the shadow memory.
+ * In frame mode nothing is sent: only the nibbles that change are marked
+ * dirty, so a screen cleared and redrawn in one frame costs the nibbles
+ * that differ from the previous screen, in one ht1632_flush().
+ */
+void ht1632_fill(byte color)
+{
+  byte green = (color & GREEN) ? 0xF : 0;
+  byte red = (color & RED) ? 0xF : 0;
+  if (ht1632_framemode)
+  {
+    for (byte chip = 0; chip < CHIP_MAX; chip++)
+    {
+      for (byte addr = 0; addr < 64; addr++)
+      {
+        byte data = addr < 32 ? green : red;
+        if (ht1632_shadowram[addr][chip] != data) {
+          ht1632_shadowram[addr][chip] = data;
+          ht1632_dirty[chip][addr>>3] |= 1<<(addr&7);
+          ht1632_dirtychips |= HT1632Panel::chipbit(chip);
+        }
+      }
+    }
+    return;
+  }
+  ht1632_burst(-1, 0, green * 0x11, red * 0x11);
+  ChipSelect(0);
+
+  for (byte chip = 0; chip < CHIP_MAX; chip++)
+  {
+    for (byte j = 0; j < 32; j++)
+    {
+      ht1632_shadowram[j][chip] = green;
+      ht1632_shadowram[j+32][chip] = red;
+    }
+    for (byte j = 0; j < 8; j++)
+      ht1632_dirty[chip][j] = 0;
+  }
+  ht1632_dirtychips = 0;
 }
 
 
 /*
  * ht1632_clear
- * clear the display, and the shadow memory, and the snapshot
- * memory.  This uses the "write multiple words" capability of
- * the chipset by writing all 96 words of memory without raising
- * the chipselect signal.
+ * clear the display and the shadow memory with one broadcast write
+ * (all 64 addresses of every chip without raising the chip select);
+ * in frame mode, clear the shadow memory only (see ht1632_fill()).
  */
 void ht1632_clear()
 {
-  char i;
-  for (int i=1; i< 5; i++)
+  ht1632_fill(BLACK);
+}
+
+
+/*
+ * ht1632_image
+ * show a full screen image (HT1632_IMAGE_SIZE bytes in PROGMEM, built with
+ * HT1632_IMAGE()) on the first board and clear the others: one
+ * successive-address write per chip, or a single broadcast write when the
+ * display is one board and its four quarters are identical.
+ * In frame mode nothing is sent: the whole shadow memory is marked dirty, so
+ * ht1632_flush() sends each chip in one run as well, after the other plots.
+ */
+void ht1632_image(const byte* image)
+{
+  bool same = HT1632Panel::boards == 1;
+  for (byte chip = 0; chip < CHIP_MAX; chip++)
+  {
+    bool drawn = chip < HT1632Board::chips;
+    for (byte j = 0; j < 32; j++)
+    {
+      byte b = drawn ? pgm_read_byte(&image[chip*32 + j]) : 0;
+      ht1632_shadowram[2*j][chip] = b >> 4;
+      ht1632_shadowram[2*j+1][chip] = b & 0xF;
+      if (chip && b != pgm_read_byte(&image[j]))
+        same = false;
+    }
+    for (byte j = 0; j < 8; j++)
+      ht1632_dirty[chip][j] = ht1632_framemode ? 0xFF : 0;
+  }
+  ht1632_dirtychips = ht1632_framemode ? HT1632Panel::all() : 0;
+  if (ht1632_framemode)
+    return;
+
+  if (same)
+    ht1632_burst(-1, image, 0, 0);
+  else
+  {
+    for (byte chip = 0; chip < CHIP_MAX; chip++)
+      ht1632_burst(chip + 1, chip < HT1632Board::chips ? image + chip*32 : 0, 0, 0);
+  }
+  ChipSelect(0);
+}
+
+
+/*
+ * ht1632_blit
+ * draw a glyph (PROGMEM, built with HT1632_GLYPH_*()) with its top left
+ * corner at (x, y), y being a multiple of 4: each glyph nibble is a whole
+ * nibble of the chip memory, updated with a mask instead of pixel by pixel.
+ * Lit pixels of the glyph get "color" (BLACK erases them), the others are
+ * left untouched. The changed nibbles are sent by ht1632_flush(), right
+ * away or with the rest of the frame when called in frame mode.
+ */
+void ht1632_blit(const byte* glyph, byte x, byte y, byte color)
+{
+  byte width = pgm_read_byte(&glyph[0]);
+  byte rows = pgm_read_byte(&glyph[1]);
+  const byte* bits = glyph + HT1632_GLYPH_HEADER;
+  ht1632_beginframe();
+
+  byte k = 0;
+  for (byte col = 0; col < width; col++)
+  {
+    for (byte row = 0; row < rows; row++, k++)
+    {
+      byte b = pgm_read_byte(&bits[k>>1]);
+      byte mask = (k & 1) ? (b & 0xF) : (b >> 4);
+      byte px = x + col;
+      byte py = y + row*4;
+      if (!mask || px >= X_MAX || py >= Y_MAX)
+        continue;
+
+      byte nChip = 1 + HT1632Panel::chip(px, py);
+      byte addr = HT1632Panel::addr(px, py);
+      byte green = ht1632_shadowram[addr][nChip-1];
+      byte red = ht1632_shadowram[addr+32][nChip-1];
+      green = (color & GREEN) ? (green | mask) : (green & ~mask);
+      red = (color & RED) ? (red | mask) : (red & ~mask);
+      ht1632_writenibble(nChip, addr, green);
+      ht1632_writenibble(nChip, addr + 32, red);
+    }
+  }
+
+  ht1632_flush();
+}
+
+#if HT1632_BENCHMARK
+/*
+ * ht1632_benchmark
+ * micro-benchmark of ht1632_plot(): 64 immediate writes with the 74164 forced
+ * back to an unknown state before each one (full shift, as the original
+ * ChipSelect() did), then 64 writes with the cached chip select state.
+ * Build once with -DHT1632_FASTPINS=0 to get the digitalWrite() figures.
+ * Then the frame time: 16 pixels lit or erased on every board per
+ * ht1632_flush(); build with HT1632_BOARDS_X / HT1632_BOARDS_Y to compare
+ * chains of boards.
+ */
+void ht1632_benchmark()
+{
+  for (byte pass = 0; pass < 2; pass++)
   {
-    ChipSelect(-1);
-    ht1632_writebits(HT1632_ID_WR, 1<<2);  // send ID: WRITE to RAM
-    ht1632_writebits(0, 1<<6); // Send address
-    for (i = 0; i < 96/2; i++) // Clear entire display
-      ht1632_writebits(0, 1<<7); // send 8 bits of data
-    ChipSelect(0);
-
-    for (int j=0; j < 64; j++)
-      ht1632_shadowram[j][i-1] = 0;
+    unsigned long bits = ht1632_busbits;
+    unsigned long t = micros();
+    for (byte i = 0; i < 64; i++)
+    {
+      if (pass == 0)
+        ht1632_cszeros = HT1632Panel::all();
+      ht1632_plot(i & 31, (i>>5)*8 + (i&7), ORANGE);
+    }
+    t = micros() - t;
+    bits = ht1632_busbits - bits;
+    Serial.print(pass == 0 ? "cs full  " : "cs cached ");
+    Serial.print(bits / 64);
+    Serial.print(" clk/plot ");
+    Serial.print(t / 64);
+    Serial.println(" us/plot");
+  }
+
+  unsigned long bits = ht1632_busbits;
+  unsigned long t = micros();
+  for (byte frame = 0; frame < 32; frame++)
+  {
+    ht1632_beginframe();
+    for (byte board = 0; board < HT1632Panel::boards; board++)
+    {
+      for (byte i = 0; i < 16; i++)
+      {
+        byte k = i + (frame >> 1) * 16;
+        ht1632_plot((board % HT1632_BOARDS_X) * HT1632Board::width + (k * 7) % HT1632Board::width,
+                    (board / HT1632_BOARDS_X) * HT1632Board::height + (k * 5 + (k >> 5)) % HT1632Board::height,
+                    (frame & 1) ? BLACK : ORANGE);
+      }
+    }
+    ht1632_flush();
   }
+  t = micros() - t;
+  bits = ht1632_busbits - bits;
+  Serial.print(HT1632Panel::boards);
+  Serial.print(" board(s) ");
+  Serial.print(bits / 32);
+  Serial.print(" clk/frame ");
+  Serial.print(t / 32);
+  Serial.println(" us/frame");
+  ht1632_clear();
 }
+#endif
 
 
 void setup7Seg(void)
 {
-    Wire.beginTransmission(0x20);      // start talking to the device
-    Wire.write(0x00);                   // select the GPIO register
-    Wire.write(0x00);                   // set register value-all high
-    Wire.endTransmission();            // stop talking to the device
-
-    // dizaine
-    Wire.beginTransmission(0x21);      // start talking to the device
-    Wire.write(0x00);                   // select the GPIO register
-    Wire.write(0x00);                   // set register value-all high
-    Wire.endTransmission();            // stop talking to the device
-
-    // Centaine
-    Wire.beginTransmission(0x22);      // start talking to the device
-    Wire.write(0x00);                   // select the GPIO register
-    Wire.write(0x00);                   // set register value-all high
-    Wire.endTransmission();            // stop talking to the device
-
-    // Millier
-    Wire.beginTransmission(0x23);      // start talking to the device
-    Wire.write(0x00);                   // select the GPIO register
-    Wire.write(0x00);                   // set register value-all high
-    Wire.endTransmission();            // stop talking to the device
+    // port direction of the four expanders (register 0x00 = 0x00, all outputs),
+    // queued and sent by the TWI interrupt
+    seg7_begin();
 }
 
@@ -47,4 +47,81 @@
 #define NOTE_A9  14080
 #define NOTE_B9  15804
 
+// ===== INDEX DE NOTES =====
+// Une note tient sur 1 octet : (octave - 4) * 7 + couloir (do = 0 ... si = 6).
+// Les tables ci-dessous sont calculées à la compilation (constexpr) et lues en PROGMEM :
+// couloir, fréquence et registres du Timer2 coûtent une lecture de table.
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+#define NOTE_LANES 7            // do, ré, mi, fa, sol, la, si
+#define NOTE_LANE_HEIGHT 2      // lignes par couloir (= BLOCK_HEIGHT)
+#define NOTE_MAX_DURATION 32    // ronde (durées en triples croches)
+
+// X-macro : toutes les notes jouables, dans l'ordre des index
+#define NOTE_TABLE(X) \
+  X(C4) X(D4) X(E4) X(F4) X(G4) X(A4) X(B4) \
+  X(C5) X(D5) X(E5) X(F5) X(G5) X(A5) X(B5) \
+  X(C6) X(D6) X(E6) X(F6) X(G6) X(A6) X(B6) \
+  X(C7) X(D7) X(E7) X(F7) X(G7) X(A7) X(B7) \
+  X(C8) X(D8) X(E8) X(F8) X(G8) X(A8) X(B8) \
+  X(C9) X(D9) X(E9) X(F9) X(G9) X(A9) X(B9)
+
+#define NOTE_ENUM(n) N_##n,
+enum : uint8_t { NOTE_TABLE(NOTE_ENUM) NOTE_COUNT };
+#undef NOTE_ENUM
+
+// Ligne du haut du couloir d'une note
+constexpr uint8_t noteRow(uint8_t note) { return note % NOTE_LANES * NOTE_LANE_HEIGHT; }
+
+// Timer2 en mode CTC, OC2B (broche 3) basculée à chaque période :
+// f = F_CPU / (2 * N * (OCR2A + 1)), avec le plus petit diviseur N qui tient sur 8 bits
+constexpr uint16_t timer2Divider(uint8_t cs) {
+  return cs == 1 ? 1 : cs == 2 ? 8 : cs == 3 ? 32 : cs == 4 ? 64 : cs == 5 ? 128 : cs == 6 ? 256 : 1024;
+}
+constexpr uint32_t timer2Top(uint16_t frequency, uint8_t cs) {
+  return (F_CPU / timer2Divider(cs) / frequency + 1) / 2 - 1;
+}
+constexpr uint8_t timer2Prescaler(uint16_t frequency, uint8_t cs = 1) {
+  return cs >= 7 || timer2Top(frequency, cs) <= 255 ? cs : timer2Prescaler(frequency, cs + 1);
+}
+constexpr uint8_t timer2Compare(uint16_t frequency) {
+  return timer2Top(frequency, timer2Prescaler(frequency));
+}
+
+// Longueur affichée (pixels) selon la durée (1-32), même barème que l'ancien createNewBlock()
+constexpr uint8_t noteLengthFromDuration(uint8_t duration) {
+  return duration >= 32 ? 8 : duration >= 24 ? 6 : duration >= 16 ? 5 : duration >= 12 ? 4 :
+         duration >= 6 ? 3 : duration >= 3 ? 2 : 1;
+}
+
+#define NOTE_FREQUENCY(n) NOTE_##n,
+#define NOTE_ROW(n) noteRow(N_##n),
+#define NOTE_PRESCALER(n) timer2Prescaler(NOTE_##n),
+#define NOTE_COMPARE(n) timer2Compare(NOTE_##n),
+const PROGMEM uint16_t noteFrequencies[] = { NOTE_TABLE(NOTE_FREQUENCY) };
+const PROGMEM uint8_t noteRows[] = { NOTE_TABLE(NOTE_ROW) };
+const PROGMEM uint8_t noteTimerPrescalers[] = { NOTE_TABLE(NOTE_PRESCALER) };  // TCCR2B (CS22:0)
+const PROGMEM uint8_t noteTimerCompares[] = { NOTE_TABLE(NOTE_COMPARE) };      // OCR2A
+#undef NOTE_FREQUENCY
+#undef NOTE_ROW
+#undef NOTE_PRESCALER
+#undef NOTE_COMPARE
+
+#define DURATION_LENGTHS_4(d) noteLengthFromDuration(d), noteLengthFromDuration(d + 1), \
+                              noteLengthFromDuration(d + 2), noteLengthFromDuration(d + 3)
+const PROGMEM uint8_t durationLengths[NOTE_MAX_DURATION + 1] = {
+  DURATION_LENGTHS_4(0), DURATION_LENGTHS_4(4), DURATION_LENGTHS_4(8), DURATION_LENGTHS_4(12),
+  DURATION_LENGTHS_4(16), DURATION_LENGTHS_4(20), DURATION_LENGTHS_4(24), DURATION_LENGTHS_4(28),
+  noteLengthFromDuration(32)
+};
+#undef DURATION_LENGTHS_4
+
+static_assert(NOTE_COUNT == 6 * NOTE_LANES, "octaves 4 à 9, sept notes naturelles");
+static_assert(sizeof(noteFrequencies) == NOTE_COUNT * sizeof(uint16_t), "une fréquence par note");
+static_assert(noteRow(N_C4) == 0 && noteRow(N_E6) == 4 && noteRow(N_B9) == 12, "couloir = note naturelle");
+static_assert(timer2Prescaler(NOTE_C4) < 7 && timer2Prescaler(NOTE_B9) >= 1, "notes extrêmes sur 8 bits");
+
 #endif // NOTES_FREQUENCIES_H
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include "pot.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#endif
+
+volatile PotState pot_state;
+
+static uint16_t pot_sum = 0;                  // conversions of the current decimated sample
+static uint8_t pot_count = 0;
+static uint16_t pot_ring[POT_RING];           // decimated samples, 12 bits
+static uint16_t pot_ringSum = 0;
+static uint8_t pot_ringPos = 0;
+static bool pot_primed = false;               // ring filled with the first sample
+
+typedef struct {
+  uint16_t low;    // the zone is kept while low <= value < high
+  uint16_t high;
+} PotBounds;
+static PotBounds pot_cursorBounds = { 0, 0 };   // empty: first sample computes the zone
+static PotBounds pot_menuBounds = { 0, 0 };
+
+static_assert(POT_OVERSAMPLE * 1023UL <= 0xFFFF, "decimation to 12 bits in 16 bits");
+static_assert(POT_CURSOR_ZONES * (1023UL + POT_HYSTERESIS) <= 0xFFFF, "zones in 16 bits");
+static_assert(POT_RING * 4095UL <= 0xFFFF, "ring sum in 16 bits, value = sum >> (POT_RING_SHIFT + 2)");
+
+
+/*
+ * pot_zone
+ * zone of value among "zones" equal zones of 0..1023. Moving to a
+ * neighbouring zone needs value POT_HYSTERESIS past the boundary; a jump
+ * over several zones is taken at once. bounds holds the values that keep
+ * the current zone, hysteresis included: inside them (nearly every
+ * sample) two compares, the multiply and divide only on a zone change.
+ */
+static uint8_t pot_zone(uint16_t value, uint8_t zones, uint8_t current, PotBounds* bounds)
+{
+  if (value >= bounds->low && value < bounds->high)
+    return current;
+  uint8_t zone = (value * zones) >> 10;    // 1023 * 15 fits in 16 bits
+  uint16_t start = ((uint16_t)zone * 1024 + zones - 1) / zones;        // first value of the zone
+  uint16_t end = ((uint16_t)(zone + 1) * 1024 + zones - 1) / zones;    // first value of the next one
+  bounds->low = start > POT_HYSTERESIS ? start - POT_HYSTERESIS : 0;
+  bounds->high = end + POT_HYSTERESIS;
+  return zone;
+}
+
+
+/*
+ * pot_convert
+ * accumulate one conversion; every POT_OVERSAMPLE conversions, publish the
+ * moving average and its zones. Inlined in the ADC interrupt: no call, and
+ * no call-clobbered registers saved on top of the ones it uses.
+ */
+static inline __attribute__((always_inline)) void pot_convert(uint16_t raw)
+{
+  pot_sum += raw;
+  if (++pot_count < POT_OVERSAMPLE)
+    return;
+#if POT_OVERSAMPLE_SHIFT >= 2
+  uint16_t sample = pot_sum >> (POT_OVERSAMPLE_SHIFT - 2);
+#else
+  uint16_t sample = pot_sum << (2 - POT_OVERSAMPLE_SHIFT);
+#endif
+  pot_sum = 0;
+  pot_count = 0;
+
+  if (!pot_primed) {
+    for (uint8_t i = 0; i < POT_RING; i++)
+      pot_ring[i] = sample;
+    pot_ringSum = sample * POT_RING;
+    pot_primed = true;
+  } else {
+    pot_ringSum += sample - pot_ring[pot_ringPos];
+    pot_ring[pot_ringPos] = sample;
+    pot_ringPos = (pot_ringPos + 1) % POT_RING;
+  }
+
+  uint16_t value = pot_ringSum >> (POT_RING_SHIFT + 2);
+  pot_state.value = value;
+  pot_state.cursor = pot_zone(value, POT_CURSOR_ZONES, pot_state.cursor, &pot_cursorBounds);
+  pot_state.menu = pot_zone(value, POT_MENU_ZONES, pot_state.menu, &pot_menuBounds);
+  pot_state.updates++;
+}
+
+
+void pot_sample(uint16_t raw)
+{
+  pot_convert(raw);
+}
+
+
+/*
+ * pot_read
+ */
+PotState pot_read()
+{
+  PotState copy;
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+#else
+  noInterrupts();
+#endif
+  copy.value = pot_state.value;
+  copy.cursor = pot_state.cursor;
+  copy.menu = pot_state.menu;
+  copy.updates = pot_state.updates;
+#if defined(__AVR__)
+  SREG = sreg;
+#else
+  interrupts();
+#endif
+  return copy;
+}
+
+
+/*
+ * pot_begin
+ * first sample read at once, then AVcc reference, ADC clock F_CPU / 128,
+ * auto trigger and interrupt on.
+ */
+void pot_begin(uint8_t channel)
+{
+  // blocking conversions while the ADC interrupt is still off: without them
+  // the first tick would read pot_state before any sample (value 0, menu level 9)
+  for (uint8_t i = 0; i < POT_OVERSAMPLE; i++)
+    pot_convert(analogRead(channel));
+
+#if defined(__AVR__)
+  if (channel >= A0)
+    channel -= A0;
+  ADMUX = _BV(REFS0) | (channel & 7);
+#if POT_TRIGGER == POT_TRIGGER_TIMER1
+  ADCSRB = _BV(ADTS2) | _BV(ADTS1);              // Timer1 overflow
+#elif POT_TRIGGER == POT_TRIGGER_TIMER0
+  ADCSRB = _BV(ADTS2);                           // Timer0 overflow
+#else
+  ADCSRB = 0;                                    // free running
+#endif
+  DIDR0 = _BV(channel & 7);                      // digital input buffer off on the pot pin
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+#if POT_TRIGGER != POT_TRIGGER_TIMER1
+  ADCSRA |= _BV(ADSC);                           // first conversion (free running: starts the chain)
+#endif
+#else
+  (void)channel;
+#endif
+}
+
+
+#if defined(__AVR__)
+ISR(ADC_vect)
+{
+#if POT_TRIGGER == POT_TRIGGER_TIMER1 && POT_OVERSAMPLE > 1
+  // rest of the burst: start the next conversion by hand, the result
+  // register keeps this one until it completes (~104 us)
+  if (pot_count + 1 < POT_OVERSAMPLE)
+    ADCSRA |= _BV(ADSC);
+#endif
+  pot_convert(ADC);
+}
+#endif
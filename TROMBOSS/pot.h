@@ -0,0 +1,76 @@
+/*
+ * pot.h
+ * interrupt driven potentiometer reading: the ADC converts on its own and
+ * its conversion complete interrupt filters the samples, so the game reads
+ * a ready value instead of waiting ~104 us in analogRead().
+ *
+ * Conversions are auto-triggered on the pot channel. By default the Timer1
+ * overflow (the game tick) starts POT_OVERSAMPLE conversions (one: a single
+ * ADC interrupt per tick, cheaper than the analogRead() it replaces; more
+ * are chained back to back, each started by the interrupt of the previous
+ * one); the sample is ready ~0.1 ms later and read by the next tick.
+ * POT_TRIGGER can select one conversion per Timer0 overflow (976 Hz) or free
+ * running mode (9615 Hz) instead, for more samples at more interrupts.
+ * POT_OVERSAMPLE conversions are summed and decimated into one 12-bit
+ * sample, the last POT_RING of them are averaged into pot_state.value, and
+ * the value is quantized into the cursor rows and the menu levels with a
+ * small hysteresis so a zone does not flicker on its boundary.
+ *
+ * pot_sample() is the whole interrupt body; the host bench feeds it with
+ * simulated conversions.
+ */
+
+#ifndef POT_H
+#define POT_H
+
+#include <Arduino.h>
+
+#define POT_TRIGGER_TIMER1 0   // POT_OVERSAMPLE conversions per Timer1 overflow (game tick)
+#define POT_TRIGGER_TIMER0 1   // one conversion per Timer0 overflow
+#define POT_TRIGGER_FREE 2     // back to back conversions
+#if !defined(POT_TRIGGER)
+#define POT_TRIGGER POT_TRIGGER_TIMER1
+#endif
+
+#if !defined(F_CPU)
+#define F_CPU 16000000UL
+#endif
+
+#define POT_CONVERSION_RATE (F_CPU / 128 / 13.0)   // ADC clock 125 kHz, 13 clocks per conversion
+#if POT_TRIGGER == POT_TRIGGER_FREE
+#define POT_ADC_RATE POT_CONVERSION_RATE
+#define POT_OVERSAMPLE_SHIFT 5                  // 32 conversions per decimated sample (300 Hz)
+#define POT_RING_SHIFT 3
+#elif POT_TRIGGER == POT_TRIGGER_TIMER0
+#define POT_ADC_RATE (F_CPU / 64 / 256.0)       // one conversion per Timer0 overflow
+#define POT_OVERSAMPLE_SHIFT 2                  // 4 conversions per decimated sample (244 Hz)
+#define POT_RING_SHIFT 3
+#else
+#if !defined(POT_OVERSAMPLE_SHIFT)
+#define POT_OVERSAMPLE_SHIFT 0                  // 1 conversion per tick, one sample per tick
+#endif
+#define POT_RING_SHIFT 1                        // the 2-tick moving average does the smoothing
+#endif
+#define POT_OVERSAMPLE (1 << POT_OVERSAMPLE_SHIFT)
+#define POT_RING (1 << POT_RING_SHIFT)          // decimated samples in the moving average
+#define POT_HYSTERESIS 12                       // LSB past a zone boundary before the zone changes (rows: 68 LSB)
+#define POT_CURSOR_ZONES 15                     // cursor rows 0..14
+#define POT_MENU_ZONES 9                        // menu levels, zone 0 = value 0..113
+
+typedef struct {
+  uint16_t value;     // filtered value, 0..1023
+  uint8_t cursor;     // zone of value among POT_CURSOR_ZONES
+  uint8_t menu;       // zone of value among POT_MENU_ZONES
+  uint16_t updates;   // decimated samples published (wraps)
+} PotState;
+
+extern volatile PotState pot_state;
+
+// start the conversions on this analog channel (0..7 or A0..A7)
+void pot_begin(uint8_t channel);
+// one conversion result (the ADC interrupt)
+void pot_sample(uint16_t raw);
+// consistent copy of pot_state
+PotState pot_read();
+
+#endif // POT_H
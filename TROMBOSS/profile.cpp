@@ -0,0 +1,220 @@
+/*
+ * profile.cpp
+ * section counters of profile.h.
+ */
+
+#include "profile.h"
+
+#if PROFILING
+
+// counters are shared with the Timer1 interrupt
+#if defined(__AVR__)
+#define PROF_LOCK()   uint8_t prof_sreg = SREG; cli()
+#define PROF_UNLOCK() SREG = prof_sreg
+#else
+#define PROF_LOCK()   noInterrupts()
+#define PROF_UNLOCK() interrupts()
+#endif
+
+ProfSection prof_sections[PROF_SECTIONS];
+uint16_t prof_overruns = 0;
+uint16_t prof_missed = 0;
+
+static uint16_t prof_period = 0xFFFF;   // Timer1 period, in ticks
+static uint16_t prof_lastTick = 0;      // start of the previous Timer1 tick
+static bool prof_ticking = false;       // prof_lastTick is valid
+
+// section names, space separated, in the order of the enum
+static const char prof_names[] PROGMEM = "tick pot engine loop frame seg7";
+
+
+void prof_begin(unsigned long periodMicros)
+{
+  prof_period = periodMicros * 16 / PROF_CYCLES_PER_TICK;
+  prof_reset();
+}
+
+
+/*
+ * prof_record
+ * histogram bucket = bit length of ticks/2, so the first bucket holds
+ * [0,2) ticks and the last one everything from 2^PROF_BUCKETS ticks on.
+ */
+void prof_record(uint8_t section, uint16_t ticks)
+{
+  PROF_LOCK();
+  ProfSection& s = prof_sections[section];
+  s.count++;
+  s.total += ticks;
+  if (ticks < s.min)
+    s.min = ticks;
+  if (ticks > s.max)
+    s.max = ticks;
+
+  uint8_t bucket = 0;
+  for (uint16_t t = ticks >> 1; t && bucket < PROF_BUCKETS - 1; t >>= 1)
+    bucket++;
+  if (s.histogram[bucket] != 0xFFFF)
+    s.histogram[bucket]++;
+  PROF_UNLOCK();
+}
+
+
+#if defined(__AVR__)
+/*
+ * prof_isrNow
+ * TimerOne runs Timer1 in phase and frequency correct mode: it counts up to
+ * ICR1, back down to 0, and sets TOV1 at the bottom, once per period. The
+ * slope is found by waiting for the next count (one Timer1 clock, 8 cycles
+ * with the 25 ms period), and a pending TOV1 adds one period: the Timer1
+ * interrupt cleared it on entry, so it means the next period has begun.
+ */
+uint16_t prof_isrNow()
+{
+  static const uint8_t prescalerShift[8] = { 0, 0, 3, 6, 8, 10, 0, 0 };   // CS12:0
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t pendingBefore = TIFR1 & _BV(TOV1);
+  uint16_t top = ICR1;
+  uint16_t first = TCNT1;
+  uint16_t count;
+  while ((count = TCNT1) == first)
+    ;
+  uint8_t pending = TIFR1 & _BV(TOV1);
+  uint8_t shift = prescalerShift[TCCR1B & 0x07];
+  SREG = sreg;
+
+  uint32_t position;
+  if (pending != pendingBefore)
+    position = 2UL * top;   // bottom reached between the reads
+  else
+    position = (count > first ? count : 2UL * top - count) + (pending ? 2UL * top : 0);
+  return (uint16_t)((position << shift) / PROF_CYCLES_PER_TICK);
+}
+#endif
+
+
+/*
+ * prof_tickStart
+ * called first thing in the Timer1 interrupt: more than 1.5 periods since
+ * the previous tick means periods were lost (the flag only keeps one).
+ * The gap is read on Timer0, still exact when the interrupt starts; the
+ * duration of the tick on Timer1 (prof_isrNow()).
+ */
+uint16_t prof_tickStart()
+{
+  uint16_t now = prof_now();
+  if (prof_ticking)
+  {
+    uint16_t gap = now - prof_lastTick;
+    if (gap > prof_period + prof_period / 2)
+      prof_missed += (gap + prof_period / 2) / prof_period - 1;
+  }
+  prof_lastTick = now;
+  prof_ticking = true;
+  return prof_isrNow();
+}
+
+
+void prof_tickEnd(uint16_t start)
+{
+  uint16_t ticks = prof_isrNow() - start;
+#if defined(__AVR__)
+  if (TIFR1 & _BV(TOV1))   // the next period began during the tick
+#else
+  if (ticks > prof_period)
+#endif
+    prof_overruns++;
+  prof_record(PROF_TICK, ticks);
+}
+
+
+void prof_reset()
+{
+  PROF_LOCK();
+  for (uint8_t i = 0; i < PROF_SECTIONS; i++)
+  {
+    ProfSection& s = prof_sections[i];
+    s.count = 0;
+    s.total = 0;
+    s.min = 0xFFFF;
+    s.max = 0;
+    for (uint8_t b = 0; b < PROF_BUCKETS; b++)
+      s.histogram[b] = 0;
+  }
+  prof_overruns = 0;
+  prof_missed = 0;
+  prof_ticking = false;
+  PROF_UNLOCK();
+}
+
+
+/*
+ * prof_dump
+ * one header line, then one line per section that ran:
+ *   P us/tick=4 overruns=<n> missed=<n>
+ *   <name> <count> <min> <mean> <max> <h0>,<h1>,...   (durations in ticks)
+ * the counters are copied with interrupts off, then printed with them on.
+ */
+void prof_dump()
+{
+  Serial.print("P us/tick=");
+  Serial.print(PROF_CYCLES_PER_TICK / 16);
+  Serial.print(" overruns=");
+  Serial.print(prof_overruns);
+  Serial.print(" missed=");
+  Serial.println(prof_missed);
+
+  const char* name = prof_names;
+  for (uint8_t i = 0; i < PROF_SECTIONS; i++)
+  {
+    ProfSection s;
+    {
+      PROF_LOCK();
+      s = prof_sections[i];
+      PROF_UNLOCK();
+    }
+
+    char c;
+    while ((c = pgm_read_byte(name)) && c != ' ')
+    {
+      if (s.count)
+        Serial.print(c);
+      name++;
+    }
+    if (c)
+      name++;
+    if (!s.count)
+      continue;
+
+    Serial.print(' ');
+    Serial.print(s.count);
+    Serial.print(' ');
+    Serial.print(s.min);
+    Serial.print(' ');
+    Serial.print(s.total / s.count);
+    Serial.print(' ');
+    Serial.print(s.max);
+    for (uint8_t b = 0; b < PROF_BUCKETS; b++)
+    {
+      Serial.print(b ? ',' : ' ');
+      Serial.print(s.histogram[b]);
+    }
+    Serial.println();
+  }
+}
+
+
+void prof_poll()
+{
+  while (Serial.available())
+  {
+    int c = Serial.read();
+    if (c == 'p')
+      prof_dump();
+    else if (c == 'r')
+      prof_reset();
+  }
+}
+
+#endif // PROFILING
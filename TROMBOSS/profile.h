@@ -0,0 +1,128 @@
+/*
+ * profile.h
+ * execution time counters for named code sections (Timer1 tick, main loop,
+ * pot reading, block creation...).
+ *
+ * Durations are read on Timer0, which already runs for millis() (prescaler
+ * 64): one profiler tick = 64 CPU cycles = 4 us at 16 MHz, no extra timer
+ * and no interrupt of our own. Inside the Timer1 interrupt Timer0 overflows
+ * are not counted, so those sections are read on Timer1 instead (same unit,
+ * valid up to two periods). Each section keeps count, min, max, total and
+ * a log2 histogram; the Timer1 tick also counts budget overruns and missed
+ * periods. prof_dump() prints everything on Serial, one line per section.
+ *
+ * With PROFILING 0 the macros expand to nothing and nothing is linked in.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+
+#if !defined(PROFILING)
+#define PROFILING 0   // 1 = record the sections below, dump them with 'p' on Serial ('r' = reset)
+#endif
+
+#define PROF_CYCLES_PER_TICK 64   // Timer0 prescaler
+#define PROF_BUCKETS 8            // histogram: [0,2) [2,4) [4,8) ... [128,inf) ticks
+
+// profiled sections (names in prof_names, same order)
+enum {
+  PROF_TICK,        // periodicFunction(), the whole Timer1 interrupt
+  PROF_POT,         // pot_read() of the filtered pot in the interrupt
+  PROF_ENGINE,      // engine_tick(): hits, judgement, moves and block creation in the interrupt
+  PROF_LOOP,        // one loop() iteration
+  PROF_FRAME,       // handleLevelLoop() composition + ht1632_flush()
+  PROF_SEG7,        // 7-segment refresh in loop() (seg7_poll() + update7SegDisplay())
+  PROF_SECTIONS
+};
+
+#if PROFILING
+
+typedef struct {
+  uint32_t count;
+  uint32_t total;                     // sum of the durations, in ticks
+  uint16_t min;
+  uint16_t max;
+  uint16_t histogram[PROF_BUCKETS];   // saturating counters
+} ProfSection;
+
+extern ProfSection prof_sections[PROF_SECTIONS];
+extern uint16_t prof_overruns;        // Timer1 ticks longer than the period
+extern uint16_t prof_missed;          // Timer1 periods that never got their tick
+
+#if defined(__AVR__)
+extern volatile unsigned long timer0_overflow_count;  // wiring.c
+
+// Timer0 count extended to 16 bits with its overflow counter (wraps every 262 ms);
+// outside interrupts only: with interrupts off the counter stands still
+static inline uint16_t prof_now()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t low = TCNT0;
+  uint8_t high = (uint8_t)timer0_overflow_count;
+  if ((TIFR0 & _BV(TOV0)) && low < 255)
+    high++;   // overflow pending, not yet counted by the Timer0 interrupt
+  SREG = sreg;
+  return ((uint16_t)high << 8) | low;
+}
+
+// time since the start of the current Timer1 period, same unit, for the
+// sections timed inside the Timer1 interrupt (see profile.cpp)
+uint16_t prof_isrNow();
+#else
+// same unit elsewhere (host build): 4 us
+static inline uint16_t prof_now() { return (uint16_t)(micros() / (PROF_CYCLES_PER_TICK / 16)); }
+static inline uint16_t prof_isrNow() { return prof_now(); }
+#endif
+
+// set the Timer1 period used for the overrun / missed tick checks
+void prof_begin(unsigned long periodMicros);
+// add one duration (ticks) to a section
+void prof_record(uint8_t section, uint16_t ticks);
+// start / end of the Timer1 tick: overrun and missed period detection
+uint16_t prof_tickStart();
+void prof_tickEnd(uint16_t start);
+// forget everything recorded so far
+void prof_reset();
+// print every section on Serial
+void prof_dump();
+// 'p' on Serial -> prof_dump(), 'r' -> prof_reset(); call it from loop()
+void prof_poll();
+
+// records the time spent until the end of the enclosing block (early returns included)
+struct ProfScope {
+  uint8_t section;
+  uint16_t start;
+  ProfScope(uint8_t s) : section(s), start(prof_now()) {}
+  ~ProfScope() { prof_record(section, prof_now() - start); }
+};
+
+// same for the whole Timer1 tick, with the overrun / missed period checks
+struct ProfTickScope {
+  uint16_t start;
+  ProfTickScope() : start(prof_tickStart()) {}
+  ~ProfTickScope() { prof_tickEnd(start); }
+};
+
+#define PROF_BEGIN(s)  uint16_t prof_start_##s = prof_now()
+#define PROF_END(s)    prof_record(s, prof_now() - prof_start_##s)
+#define PROF_SCOPE(s)  ProfScope prof_scope_##s(s)
+#define PROF_TICK_SCOPE() ProfTickScope prof_tick_scope
+// PROF_BEGIN / PROF_END for sections inside the Timer1 interrupt
+#define PROF_ISR_BEGIN(s)  uint16_t prof_start_##s = prof_isrNow()
+#define PROF_ISR_END(s)    prof_record(s, prof_isrNow() - prof_start_##s)
+
+#else
+
+#define PROF_BEGIN(s)
+#define PROF_END(s)
+#define PROF_SCOPE(s)
+#define PROF_TICK_SCOPE()
+#define PROF_ISR_BEGIN(s)
+#define PROF_ISR_END(s)
+
+#endif // PROFILING
+
+#endif // PROFILE_H
@@ -0,0 +1,226 @@
+#include <Arduino.h>
+#include "seg7.h"
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#include <util/twi.h>
+#else
+#include <Wire.h>
+#endif
+
+volatile Seg7Stats seg7_stats;
+
+// queue entries: display index, or display index | SEG7_CONFIG for the
+// port direction write done once at start-up
+#define SEG7_CONFIG 0x80
+
+static uint8_t seg7_wanted[SEG7_DISPLAYS];          // latest requested pattern
+static uint8_t seg7_shown[SEG7_DISPLAYS];           // pattern acknowledged by the display
+static uint8_t seg7_known = 0;                      // displays whose seg7_shown is valid
+static uint8_t seg7_retry[SEG7_DISPLAYS];
+static volatile uint8_t seg7_queue[SEG7_DISPLAYS * 2];
+static volatile uint8_t seg7_head = 0;
+static volatile uint8_t seg7_count = 0;
+static volatile uint8_t seg7_queued = 0;            // bit n: display n has a GPIO write queued
+static volatile uint8_t seg7_busy = 0;              // a transaction is on the bus
+static uint8_t seg7_entry;                          // entry on the bus while seg7_busy
+static uint8_t seg7_data[2];                        // its register, value
+
+
+/*
+ * seg7_push / seg7_pop
+ * ring of queue entries; called with interrupts disabled.
+ */
+static void seg7_push(uint8_t entry)
+{
+  if (seg7_count >= sizeof(seg7_queue))
+    return;
+  seg7_queue[(seg7_head + seg7_count) % sizeof(seg7_queue)] = entry;
+  seg7_count++;
+  if (!(entry & SEG7_CONFIG))
+    seg7_queued |= 1 << entry;
+  seg7_stats.pending = seg7_count;
+  if (seg7_count > seg7_stats.maxPending)
+    seg7_stats.maxPending = seg7_count;
+}
+
+static uint8_t seg7_pop()
+{
+  uint8_t entry = seg7_queue[seg7_head];
+  seg7_head = (seg7_head + 1) % sizeof(seg7_queue);
+  seg7_count--;
+  if (!(entry & SEG7_CONFIG))
+    seg7_queued &= ~(1 << entry);
+  seg7_stats.pending = seg7_count;
+  return entry;
+}
+
+
+/*
+ * seg7_done
+ * end of the transaction of "entry": remember what the display shows,
+ * or queue it again after a failure.
+ */
+static void seg7_done(uint8_t entry, uint8_t pattern, bool ok)
+{
+  uint8_t display = entry & ~SEG7_CONFIG;
+  if (ok) {
+    seg7_stats.sent++;
+    seg7_retry[display] = 0;
+    if (!(entry & SEG7_CONFIG)) {
+      seg7_shown[display] = pattern;
+      seg7_known |= 1 << display;
+    }
+    return;
+  }
+  seg7_known &= ~(1 << display);
+  if (++seg7_retry[display] < SEG7_MAX_RETRIES) {
+    seg7_stats.retries++;
+    if (!(seg7_queued & (1 << display)) || (entry & SEG7_CONFIG))
+      seg7_push(entry);
+  } else {
+    seg7_stats.dropped++;
+    seg7_retry[display] = 0;
+  }
+}
+
+
+#if defined(__AVR__)
+
+static uint8_t seg7_index;
+
+/*
+ * seg7_start
+ * take the next queued entry and send a START (after a STOP if "stop").
+ * called with interrupts disabled or from the TWI interrupt.
+ */
+static void seg7_start(bool stop)
+{
+  if (!seg7_count) {
+    seg7_busy = 0;
+    if (stop)
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+    return;
+  }
+  seg7_entry = seg7_pop();
+  uint8_t display = seg7_entry & ~SEG7_CONFIG;
+  seg7_data[0] = (seg7_entry & SEG7_CONFIG) ? SEG7_REG_IODIR : SEG7_REG_GPIO;
+  seg7_data[1] = (seg7_entry & SEG7_CONFIG) ? 0x00 : seg7_wanted[display];
+  seg7_index = 0;
+  seg7_busy = 1;
+  TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE) | _BV(TWSTA) | (stop ? _BV(TWSTO) : 0);
+}
+
+ISR(TWI_vect)
+{
+  switch (TW_STATUS)
+  {
+    case TW_START:
+    case TW_REP_START:
+      TWDR = ((SEG7_BASE_ADDR + (seg7_entry & ~SEG7_CONFIG)) << 1) | TW_WRITE;
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+      break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+      if (seg7_index < sizeof(seg7_data)) {
+        TWDR = seg7_data[seg7_index++];
+        TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWIE);
+      } else {
+        seg7_done(seg7_entry, seg7_data[1], true);
+        seg7_start(true);   // STOP, then START of the next entry if any
+      }
+      break;
+    case TW_MT_SLA_NACK:
+    case TW_MT_DATA_NACK:
+      seg7_done(seg7_entry, seg7_data[1], false);
+      seg7_start(true);
+      break;
+    default:                // arbitration lost, bus error
+      seg7_done(seg7_entry, seg7_data[1], false);
+      TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWSTO);
+      seg7_busy = 0;        // restarted by seg7_poll()
+      break;
+  }
+}
+
+void seg7_begin()
+{
+  // internal pull-ups on SDA/SCL (A4/A5), like Wire.begin()
+  PORTC |= _BV(4) | _BV(5);
+  TWSR = 0;                                       // prescaler 1
+  TWBR = ((F_CPU / SEG7_I2C_FREQ) - 16) / 2;
+  TWCR = _BV(TWEN);
+  cli();
+  for (uint8_t display = 0; display < SEG7_DISPLAYS; display++)
+    seg7_push(display | SEG7_CONFIG);
+  seg7_start(false);
+  sei();
+}
+
+void seg7_poll()
+{
+  uint8_t sreg = SREG;
+  cli();
+  // the STOP of the previous transaction must be out before a new START
+  if (!seg7_busy && seg7_count && !(TWCR & _BV(TWSTO)))
+    seg7_start(false);
+  SREG = sreg;
+}
+
+#else
+
+void seg7_begin()
+{
+  Wire.begin();
+  Wire.setClock(SEG7_I2C_FREQ);
+  for (uint8_t display = 0; display < SEG7_DISPLAYS; display++)
+    seg7_push(display | SEG7_CONFIG);
+}
+
+void seg7_poll()
+{
+  if (!seg7_count)
+    return;
+  uint8_t entry = seg7_pop();
+  uint8_t display = entry & ~SEG7_CONFIG;
+  uint8_t pattern = (entry & SEG7_CONFIG) ? 0x00 : seg7_wanted[display];
+  Wire.beginTransmission(SEG7_BASE_ADDR + display);
+  Wire.write((entry & SEG7_CONFIG) ? SEG7_REG_IODIR : SEG7_REG_GPIO);
+  Wire.write(pattern);
+  seg7_done(entry, pattern, Wire.endTransmission() == 0);
+}
+
+#endif
+
+
+void seg7_set(uint8_t display, uint8_t pattern)
+{
+  if (display >= SEG7_DISPLAYS)
+    return;
+  noInterrupts();
+  seg7_wanted[display] = pattern;
+  if (seg7_queued & (1 << display)) {
+    seg7_stats.coalesced++;       // the queued write will send this value instead
+  } else if (seg7_busy && seg7_entry == display) {
+    // on the bus: the display will show the pattern in flight, not seg7_shown
+    if (seg7_data[1] == pattern)
+      seg7_stats.cached++;
+    else
+      seg7_push(display);
+  } else if ((seg7_known & (1 << display)) && seg7_shown[display] == pattern) {
+    seg7_stats.cached++;
+  } else {
+    seg7_push(display);
+  }
+  interrupts();
+#if defined(__AVR__)
+  seg7_poll();
+#endif
+}
+
+void seg7_invalidate()
+{
+  noInterrupts();
+  seg7_known = 0;
+  interrupts();
+}
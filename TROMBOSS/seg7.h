@@ -0,0 +1,48 @@
+/*
+ * seg7.h
+ * non-blocking driver for the four 7-segment displays (I2C port expanders
+ * at 0x20..0x23, register 0x09 = GPIO = segment pattern).
+ *
+ * seg7_set() never touches the bus: it records the wanted pattern and queues
+ * the display if its pattern differs from the one already shown (or, while
+ * the display is on the bus, from the one in flight). The queue
+ * holds each display at most once, so a newer value replaces a pending one
+ * (latest value wins) and the depth is bounded by SEG7_DISPLAYS.
+ * On AVR the queue is drained by the TWI interrupt; on other targets (host
+ * build) seg7_poll() sends at most one transaction per call through Wire.
+ */
+
+#ifndef SEG7_H
+#define SEG7_H
+
+#include <Arduino.h>
+
+#define SEG7_DISPLAYS 4
+#define SEG7_BASE_ADDR 0x20     // display n is at SEG7_BASE_ADDR + n (A4 = 0 ... A1 = 3)
+#define SEG7_REG_IODIR 0x00     // port direction register of the expander
+#define SEG7_REG_GPIO 0x09      // port register of the expander
+#define SEG7_I2C_FREQ 400000L   // bus clock
+#define SEG7_MAX_RETRIES 3      // transmissions tried before a pattern is dropped
+
+typedef struct {
+  uint8_t pending;      // transactions currently queued
+  uint8_t maxPending;   // deepest the queue has been
+  uint16_t sent;        // transactions acknowledged by an expander
+  uint16_t cached;      // seg7_set() calls skipped, pattern already shown
+  uint16_t coalesced;   // seg7_set() calls that replaced a queued pattern
+  uint16_t retries;     // transactions sent again after a NACK / bus error
+  uint16_t dropped;     // patterns given up after SEG7_MAX_RETRIES
+} Seg7Stats;
+
+extern volatile Seg7Stats seg7_stats;
+
+// configure the bus and queue the port direction of every expander
+void seg7_begin();
+// request a pattern on a display (0..SEG7_DISPLAYS-1), never blocks
+void seg7_set(uint8_t display, uint8_t pattern);
+// forget the shown patterns: the next seg7_set() of each display is sent
+void seg7_invalidate();
+// restart the drain if needed; without TWI interrupt, send one transaction
+void seg7_poll();
+
+#endif // SEG7_H
@@ -0,0 +1,126 @@
+/*
+ * song_data.h
+ * Chansons compressées - généré par tools/songpack à partir de song_patterns.h,
+ * ne pas modifier à la main.
+ * Dictionnaire de phrases partagé par les niveaux, un octet par note :
+ *   octet = code de durée x NOTE_COUNT + note, durée = songDurations[niveau][code]
+ * Sections de chaque niveau : phrase, transposition (index de note), répétitions.
+ * 836 notes : 935 octets (tableaux MusicNote : 1820 octets).
+ */
+
+#ifndef SONG_DATA_H
+#define SONG_DATA_H
+
+#include "notes_frequencies.h"
+
+#define SONG_LEVELS 9
+#define SONG_CODES 6
+#define SONG_PHRASES 11
+#define SONG_NOTE(b) ((b) % NOTE_COUNT)
+#define SONG_CODE(b) ((b) / NOTE_COUNT)
+
+typedef struct {
+  uint8_t phrase;      // index dans songPhraseStart
+  int8_t transpose;    // ajouté à l'index de chaque note
+  uint8_t repeat;      // lectures de suite (1..255)
+} SongSection;
+
+const uint8_t songDurations[SONG_LEVELS][SONG_CODES] PROGMEM = {
+    {32, 24, 16, 0, 0, 0},
+    {24, 16, 20, 0, 0, 0},
+    {16, 12, 14, 10, 0, 0},
+    {12, 8, 10, 6, 0, 0},
+    {4, 8, 6, 2, 1, 0},
+    {6, 2, 3, 4, 1, 0},
+    {4, 1, 2, 0, 0, 0},
+    {2, 1, 3, 0, 0, 0},
+    {1, 3, 2, 0, 0, 0}
+};
+
+const uint8_t songPhrases[] PROGMEM = {
+    9, 48, 49, 8, 49, 48, 5, 47, 49, 9, 50, 49, 90, 49, 8, 9,
+    7, 5, 131, 8, 52, 12, 53, 52, 93, 49, 9, 50, 49, 90, 49, 8,
+    9, 7, 5,
+    0, 43, 2, 45, 4, 47, 6, 49, 8, 51, 0, 44, 4, 49, 9, 95,
+    49, 4, 44, 0, 43, 3, 47, 8, 94, 54, 4, 47, 6, 49, 8, 93,
+    52, 11, 52, 9, 50, 7, 7, 46, 2, 42, 2, 88, 49, 4,
+    0, 44, 4, 91, 47, 3, 85, 46, 6, 50, 94, 12, 0, 46, 9, 91,
+    45, 5, 50, 94, 4, 48, 11, 92, 47, 7, 51, 96, 10, 50, 90, 4,
+    86, 49, 11, 93, 45, 8, 54, 94, 4, 51, 97, 11, 47, 94, 14, 54,
+    7, 44, 95, 0, 52, 5, 92, 46, 13, 85,
+    0, 45, 5, 92, 46, 6, 93, 54, 1, 88, 49, 10, 90, 51, 12, 99,
+    0, 47, 10, 92, 46, 9, 140, 96, 3, 50, 13, 95, 44, 7, 96, 52,
+    1, 90, 53, 9, 89, 52, 15, 97, 88, 50, 13, 94, 49, 12, 142, 98,
+    3, 49, 96, 17, 50, 97, 18, 57, 9, 42, 96, 3, 141, 88, 13, 44,
+    98, 5, 52, 85,
+    0, 53, 2, 97, 45, 15, 89, 59, 1, 54, 88, 16, 48, 102, 7, 61,
+    0, 142, 88, 56, 3, 145, 50, 101, 6, 57, 137, 104, 2, 60, 131, 105,
+    52, 12, 126, 100, 1, 55, 130, 106, 86, 147, 5, 59, 134, 104, 4, 65,
+    133, 103, 3, 148, 48, 109, 9, 140, 54, 108, 1, 139, 88, 149, 7, 61,
+    129, 106, 13, 144, 44, 105, 5, 143,
+    131,
+    173,
+    0, 67, 2, 105, 47, 24, 127, 69, 3, 64, 132, 26, 46, 149, 7, 67,
+    138, 0, 52, 153, 8, 45, 139, 23, 2, 195, 131, 64, 0, 193, 136, 68,
+    4, 189, 139, 65, 1, 192, 138, 69, 3, 191, 140, 67, 6, 190, 137, 68,
+    9, 168, 145, 66, 15, 172, 146, 65, 129, 196, 12, 64, 126, 195, 18, 65,
+    127, 194, 17, 63, 132, 193, 16, 66, 131, 197, 7, 69, 130, 198, 10, 68,
+    128, 196, 13, 66, 130, 197, 12, 65, 126, 195, 17, 67, 127, 201, 16, 63,
+    0, 75, 3, 113, 48, 32, 86, 70, 5, 73, 85, 34, 46, 114, 7, 75,
+    94, 0, 55, 116, 9, 43, 103, 31, 57, 90, 18, 72, 0, 76, 95, 30,
+    45, 28, 103, 73, 1, 75, 104, 32, 44, 113, 21, 75, 89, 31, 64, 118,
+    6, 74, 107, 28, 49, 117, 24, 71, 88, 30, 68, 115, 10, 42, 111, 32,
+    58, 85, 25, 75, 85, 77, 12, 115, 44, 34, 98, 74, 3, 75, 99, 30,
+    46, 112, 16, 71, 89, 80, 17, 118, 48, 39, 102, 75, 7, 79, 103, 28,
+    86, 81, 20, 113, 45, 40, 105, 72, 4, 80, 106, 34, 47, 119, 23, 74,
+    84, 83, 24, 117, 43, 37, 109, 73,
+    0, 83, 86, 82, 4, 80, 84, 81, 3, 78, 89, 79, 1, 77, 90, 80,
+    4, 82, 86, 83, 7, 81, 89, 78, 10, 79, 85, 77, 13, 80, 88, 82,
+    16, 83, 84, 81, 45, 39, 63, 120, 5, 80, 64, 40, 48, 121, 23, 83,
+    42, 35, 66, 121, 4, 82, 67, 38, 43, 125, 26, 81, 44, 36, 69, 124,
+    10, 79, 70, 41, 54, 122, 29, 77, 55, 39, 72, 120, 14, 82, 73, 37,
+    60, 125, 32, 80, 43, 40, 75, 123, 2, 83, 76, 40, 45, 119, 35, 83,
+    46, 36, 78, 119, 5, 79, 79, 36, 48, 122, 38, 79, 49, 39, 81, 122,
+    8, 82, 82, 39, 51, 41, 83, 124, 10, 77, 77, 41, 53, 120, 36, 77,
+    54, 37, 79, 120, 13, 80, 80, 37, 56, 123, 39, 80,
+    0, 81, 2, 125, 33, 43, 38, 88, 35, 48, 40, 86, 36, 52, 39, 89,
+    37, 56, 41, 85, 38, 60, 40, 97, 35, 65, 36, 87, 39, 68, 37, 91,
+    41, 71, 38, 95, 40, 114, 0, 83, 31, 85, 39, 75, 2, 119, 34, 45,
+    36, 88, 35, 47, 37, 113, 38, 48, 32, 91, 40, 72, 41, 94, 28, 53,
+    36, 117, 37, 55, 31, 98, 39, 71, 40, 100, 34, 59, 35, 116, 36, 61,
+    30, 104, 38, 63, 32, 106, 40, 65, 34, 108, 35, 67, 36, 110, 30, 69,
+    38, 112, 32, 71, 40, 114, 34, 73, 35, 116, 29, 75, 37, 118, 31, 77,
+    39, 120, 33, 79, 41, 122, 28, 81, 40, 121, 29, 83, 38, 119, 32, 82,
+    37, 120, 34, 80, 39, 70, 33, 121, 41, 71, 28, 122, 36, 74, 30, 124,
+    38, 76, 32, 119, 40, 71, 34, 121, 35, 73, 29, 123, 37, 75, 31, 125,
+    39, 70, 33, 120
+};
+
+const uint16_t songPhraseStart[SONG_PHRASES + 1] PROGMEM = {
+    0, 35, 81, 139, 207, 279, 280, 281, 377, 497, 637, 801
+};
+
+const SongSection songSections[] PROGMEM = {
+    // niveau 1
+    {1, 0, 1},
+    // niveau 2
+    {2, 0, 1},
+    // niveau 3
+    {3, 0, 1},
+    // niveau 4
+    {4, 0, 1},
+    // niveau 5
+    {0, 0, 1}, {5, 0, 1}, {0, 0, 1}, {6, 0, 1},
+    // niveau 6
+    {7, 0, 1},
+    // niveau 7
+    {8, 0, 1},
+    // niveau 8
+    {9, 0, 1},
+    // niveau 9
+    {10, 0, 1}
+};
+
+const uint16_t songLevelStart[SONG_LEVELS + 1] PROGMEM = {0, 1, 2, 3, 4, 8, 9, 10, 11, 12};
+
+#endif // SONG_DATA_H
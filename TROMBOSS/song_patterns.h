@@ -1,6 +1,8 @@
 /*
  * song_patterns.h
  * Définition des séquences de notes pour la musique - Optimisé pour mémoire
+ * Source des chansons : le jeu lit song_data.h, compressé à partir de ce fichier
+ * par tools/songpack (à relancer après chaque modification).
  */
 
 #ifndef SONG_PATTERNS_H
@@ -10,452 +12,506 @@
 
 // Structure pour stocker une note et sa durée - optimisée
 typedef struct {
-    uint16_t frequency;  // Fréquence de la note (réduit de int à uint16_t)
-    uint8_t duration;    // Durée de la note (réduit de int à uint8_t)
+    uint8_t note;        // Index de la note (N_C4 ... N_B9, cf. notes_frequencies.h)
+    uint8_t duration;    // Durée de la note en triples croches (1-32)
 } MusicNote;
 
 // Séquences de notes avec leurs durées - stockées en mémoire PROGMEM
 
 // ===== NIVEAU 1 - TRÈS FACILE =====
 // Notes principalement longues avec quelques variations, pas de sauts, octaves basses
-const PROGMEM MusicNote level1_intro[] = {
-    {NOTE_C4, 32}, {NOTE_D4, 24}, {NOTE_E4, 32}, {NOTE_F4, 24},
-    {NOTE_G4, 32}, {NOTE_A4, 24}, {NOTE_B4, 32}, {NOTE_C5, 24},
-    {NOTE_D5, 32}, {NOTE_E5, 24}
+constexpr PROGMEM MusicNote level1_intro[] = {
+    {N_C4, 32}, {N_D4, 24}, {N_E4, 32}, {N_F4, 24},
+    {N_G4, 32}, {N_A4, 24}, {N_B4, 32}, {N_C5, 24},
+    {N_D5, 32}, {N_E5, 24}
 };
 
-const PROGMEM MusicNote level1_verse[] = {
-    {NOTE_C4, 32}, {NOTE_E4, 24}, {NOTE_G4, 32}, {NOTE_C5, 24},
-    {NOTE_E5, 32}, {NOTE_G5, 16}, {NOTE_C5, 24}, {NOTE_G4, 32},
-    {NOTE_E4, 24}, {NOTE_C4, 32}, {NOTE_D4, 24}, {NOTE_F4, 32},
-    {NOTE_A4, 24}, {NOTE_D5, 32}, {NOTE_F5, 16}, {NOTE_A5, 24}
+constexpr PROGMEM MusicNote level1_verse[] = {
+    {N_C4, 32}, {N_E4, 24}, {N_G4, 32}, {N_C5, 24},
+    {N_E5, 32}, {N_G5, 16}, {N_C5, 24}, {N_G4, 32},
+    {N_E4, 24}, {N_C4, 32}, {N_D4, 24}, {N_F4, 32},
+    {N_A4, 24}, {N_D5, 32}, {N_F5, 16}, {N_A5, 24}
 };
 
-const PROGMEM MusicNote level1_chorus[] = {
-    {NOTE_G4, 32}, {NOTE_A4, 24}, {NOTE_B4, 32}, {NOTE_C5, 24},
-    {NOTE_D5, 32}, {NOTE_E5, 16}, {NOTE_F5, 24}, {NOTE_G5, 32},
-    {NOTE_F5, 24}, {NOTE_E5, 32}, {NOTE_D5, 24}, {NOTE_C5, 32}
+constexpr PROGMEM MusicNote level1_chorus[] = {
+    {N_G4, 32}, {N_A4, 24}, {N_B4, 32}, {N_C5, 24},
+    {N_D5, 32}, {N_E5, 16}, {N_F5, 24}, {N_G5, 32},
+    {N_F5, 24}, {N_E5, 32}, {N_D5, 24}, {N_C5, 32}
 };
 
-const PROGMEM MusicNote level1_hook[] = {
-    {NOTE_C5, 32}, {NOTE_G4, 24}, {NOTE_E4, 32}, {NOTE_C4, 24},
-    {NOTE_E4, 32}, {NOTE_G4, 16}, {NOTE_C5, 24}, {NOTE_G4, 32}
+constexpr PROGMEM MusicNote level1_hook[] = {
+    {N_C5, 32}, {N_G4, 24}, {N_E4, 32}, {N_C4, 24},
+    {N_E4, 32}, {N_G4, 16}, {N_C5, 24}, {N_G4, 32}
 };
 
 // ===== NIVEAU 2 - FACILE =====
 // Mix de notes moyennes à longues, petits sauts
-const PROGMEM MusicNote level2_intro[] = {
-    {NOTE_C4, 24}, {NOTE_E4, 16}, {NOTE_G4, 24}, {NOTE_C5, 20},
-    {NOTE_A4, 16}, {NOTE_F4, 24}, {NOTE_D4, 20}, {NOTE_G4, 16},
-    {NOTE_B4, 24}, {NOTE_D5, 16}, {NOTE_F5, 20}, {NOTE_A5, 24}
+constexpr PROGMEM MusicNote level2_intro[] = {
+    {N_C4, 24}, {N_E4, 16}, {N_G4, 24}, {N_C5, 20},
+    {N_A4, 16}, {N_F4, 24}, {N_D4, 20}, {N_G4, 16},
+    {N_B4, 24}, {N_D5, 16}, {N_F5, 20}, {N_A5, 24}
 };
 
-const PROGMEM MusicNote level2_verse[] = {
-    {NOTE_C4, 24}, {NOTE_G4, 16}, {NOTE_E5, 24}, {NOTE_C5, 20},
-    {NOTE_F4, 16}, {NOTE_A4, 24}, {NOTE_D5, 16}, {NOTE_F5, 20},
-    {NOTE_G4, 24}, {NOTE_B4, 16}, {NOTE_G5, 24}, {NOTE_D5, 20},
-    {NOTE_A4, 16}, {NOTE_C5, 24}, {NOTE_E5, 16}, {NOTE_A5, 20},
-    {NOTE_F5, 24}, {NOTE_D5, 16}, {NOTE_B4, 20}, {NOTE_G4, 24}
+constexpr PROGMEM MusicNote level2_verse[] = {
+    {N_C4, 24}, {N_G4, 16}, {N_E5, 24}, {N_C5, 20},
+    {N_F4, 16}, {N_A4, 24}, {N_D5, 16}, {N_F5, 20},
+    {N_G4, 24}, {N_B4, 16}, {N_G5, 24}, {N_D5, 20},
+    {N_A4, 16}, {N_C5, 24}, {N_E5, 16}, {N_A5, 20},
+    {N_F5, 24}, {N_D5, 16}, {N_B4, 20}, {N_G4, 24}
 };
 
-const PROGMEM MusicNote level2_chorus[] = {
-    {NOTE_E4, 20}, {NOTE_C5, 16}, {NOTE_G5, 24}, {NOTE_E5, 20},
-    {NOTE_F4, 16}, {NOTE_D5, 24}, {NOTE_A5, 16}, {NOTE_F5, 20},
-    {NOTE_G4, 24}, {NOTE_E5, 16}, {NOTE_B5, 20}, {NOTE_G5, 24},
-    {NOTE_A4, 16}, {NOTE_F5, 20}, {NOTE_C6, 24}, {NOTE_A5, 16}
+constexpr PROGMEM MusicNote level2_chorus[] = {
+    {N_E4, 20}, {N_C5, 16}, {N_G5, 24}, {N_E5, 20},
+    {N_F4, 16}, {N_D5, 24}, {N_A5, 16}, {N_F5, 20},
+    {N_G4, 24}, {N_E5, 16}, {N_B5, 20}, {N_G5, 24},
+    {N_A4, 16}, {N_F5, 20}, {N_C6, 24}, {N_A5, 16}
 };
 
-const PROGMEM MusicNote level2_hook[] = {
-    {NOTE_C5, 24}, {NOTE_E4, 16}, {NOTE_G5, 20}, {NOTE_C4, 24},
-    {NOTE_F5, 16}, {NOTE_A4, 24}, {NOTE_D5, 20}, {NOTE_G4, 16},
-    {NOTE_B5, 24}, {NOTE_D4, 20}
+constexpr PROGMEM MusicNote level2_hook[] = {
+    {N_C5, 24}, {N_E4, 16}, {N_G5, 20}, {N_C4, 24},
+    {N_F5, 16}, {N_A4, 24}, {N_D5, 20}, {N_G4, 16},
+    {N_B5, 24}, {N_D4, 20}
 };
 
 // ===== NIVEAU 3 - FACILE-MOYEN =====
 // Notes moyennes avec plus de variété rythmique
-const PROGMEM MusicNote level3_intro[] = {
-    {NOTE_C4, 16}, {NOTE_F4, 12}, {NOTE_A4, 16}, {NOTE_D5, 14},
-    {NOTE_G4, 12}, {NOTE_B4, 16}, {NOTE_E5, 14}, {NOTE_A5, 12},
-    {NOTE_D4, 16}, {NOTE_G4, 14}, {NOTE_C5, 12}, {NOTE_F5, 16},
-    {NOTE_B4, 14}, {NOTE_E5, 12}, {NOTE_A5, 16}, {NOTE_D6, 14}
+constexpr PROGMEM MusicNote level3_intro[] = {
+    {N_C4, 16}, {N_F4, 12}, {N_A4, 16}, {N_D5, 14},
+    {N_G4, 12}, {N_B4, 16}, {N_E5, 14}, {N_A5, 12},
+    {N_D4, 16}, {N_G4, 14}, {N_C5, 12}, {N_F5, 16},
+    {N_B4, 14}, {N_E5, 12}, {N_A5, 16}, {N_D6, 14}
 };
 
-const PROGMEM MusicNote level3_verse[] = {
-    {NOTE_C4, 16}, {NOTE_A4, 12}, {NOTE_F5, 16}, {NOTE_D5, 14},
-    {NOTE_G4, 12}, {NOTE_E5, 16}, {NOTE_C6, 10}, {NOTE_A5, 14},
-    {NOTE_F4, 16}, {NOTE_D5, 12}, {NOTE_B5, 16}, {NOTE_G5, 14},
-    {NOTE_E4, 12}, {NOTE_C5, 16}, {NOTE_A5, 14}, {NOTE_F5, 12},
-    {NOTE_D4, 16}, {NOTE_B4, 14}, {NOTE_G5, 12}, {NOTE_E5, 16},
-    {NOTE_A4, 14}, {NOTE_F5, 12}, {NOTE_D6, 16}, {NOTE_B5, 14}
+constexpr PROGMEM MusicNote level3_verse[] = {
+    {N_C4, 16}, {N_A4, 12}, {N_F5, 16}, {N_D5, 14},
+    {N_G4, 12}, {N_E5, 16}, {N_C6, 10}, {N_A5, 14},
+    {N_F4, 16}, {N_D5, 12}, {N_B5, 16}, {N_G5, 14},
+    {N_E4, 12}, {N_C5, 16}, {N_A5, 14}, {N_F5, 12},
+    {N_D4, 16}, {N_B4, 14}, {N_G5, 12}, {N_E5, 16},
+    {N_A4, 14}, {N_F5, 12}, {N_D6, 16}, {N_B5, 14}
 };
 
-const PROGMEM MusicNote level3_chorus[] = {
-    {NOTE_G4, 14}, {NOTE_D5, 12}, {NOTE_B5, 16}, {NOTE_F5, 14},
-    {NOTE_C5, 12}, {NOTE_A5, 16}, {NOTE_E6, 10}, {NOTE_C6, 14},
-    {NOTE_F4, 16}, {NOTE_C5, 12}, {NOTE_A5, 14}, {NOTE_F6, 16},
-    {NOTE_D5, 12}, {NOTE_B5, 14}, {NOTE_G6, 16}, {NOTE_D6, 12}
+constexpr PROGMEM MusicNote level3_chorus[] = {
+    {N_G4, 14}, {N_D5, 12}, {N_B5, 16}, {N_F5, 14},
+    {N_C5, 12}, {N_A5, 16}, {N_E6, 10}, {N_C6, 14},
+    {N_F4, 16}, {N_C5, 12}, {N_A5, 14}, {N_F6, 16},
+    {N_D5, 12}, {N_B5, 14}, {N_G6, 16}, {N_D6, 12}
 };
 
-const PROGMEM MusicNote level3_hook[] = {
-    {NOTE_E5, 16}, {NOTE_C4, 12}, {NOTE_A5, 14}, {NOTE_F4, 16},
-    {NOTE_D6, 10}, {NOTE_G4, 14}, {NOTE_B5, 16}, {NOTE_E4, 12},
-    {NOTE_C6, 14}, {NOTE_A4, 16}, {NOTE_F5, 12}, {NOTE_D4, 14}
+constexpr PROGMEM MusicNote level3_hook[] = {
+    {N_E5, 16}, {N_C4, 12}, {N_A5, 14}, {N_F4, 16},
+    {N_D6, 10}, {N_G4, 14}, {N_B5, 16}, {N_E4, 12},
+    {N_C6, 14}, {N_A4, 16}, {N_F5, 12}, {N_D4, 14}
 };
 
 // ===== NIVEAU 4 - MOYEN =====
 // Notes moyennes à rapides, sauts plus grands, rythmes variés
-const PROGMEM MusicNote level4_intro[] = {
-    {NOTE_C4, 12}, {NOTE_G5, 8}, {NOTE_E4, 12}, {NOTE_B5, 10},
-    {NOTE_F4, 8}, {NOTE_D6, 12}, {NOTE_A4, 10}, {NOTE_F6, 8},
-    {NOTE_D4, 12}, {NOTE_A5, 8}, {NOTE_G4, 10}, {NOTE_E6, 12},
-    {NOTE_B4, 8}, {NOTE_G6, 10}, {NOTE_C5, 12}, {NOTE_A6, 8}
+constexpr PROGMEM MusicNote level4_intro[] = {
+    {N_C4, 12}, {N_G5, 8}, {N_E4, 12}, {N_B5, 10},
+    {N_F4, 8}, {N_D6, 12}, {N_A4, 10}, {N_F6, 8},
+    {N_D4, 12}, {N_A5, 8}, {N_G4, 10}, {N_E6, 12},
+    {N_B4, 8}, {N_G6, 10}, {N_C5, 12}, {N_A6, 8}
 };
 
-const PROGMEM MusicNote level4_verse[] = {
-    {NOTE_C4, 12}, {NOTE_E6, 6}, {NOTE_G4, 10}, {NOTE_C6, 8},
-    {NOTE_F4, 12}, {NOTE_A6, 6}, {NOTE_D5, 8}, {NOTE_F6, 10},
-    {NOTE_B4, 12}, {NOTE_D6, 8}, {NOTE_G5, 6}, {NOTE_B6, 10},
-    {NOTE_E4, 12}, {NOTE_G6, 8}, {NOTE_A4, 6}, {NOTE_C7, 10},
-    {NOTE_F5, 8}, {NOTE_A5, 12}, {NOTE_C4, 6}, {NOTE_E6, 10},
-    {NOTE_D4, 12}, {NOTE_B5, 8}, {NOTE_G4, 6}, {NOTE_D7, 10}
+constexpr PROGMEM MusicNote level4_verse[] = {
+    {N_C4, 12}, {N_E6, 6}, {N_G4, 10}, {N_C6, 8},
+    {N_F4, 12}, {N_A6, 6}, {N_D5, 8}, {N_F6, 10},
+    {N_B4, 12}, {N_D6, 8}, {N_G5, 6}, {N_B6, 10},
+    {N_E4, 12}, {N_G6, 8}, {N_A4, 6}, {N_C7, 10},
+    {N_F5, 8}, {N_A5, 12}, {N_C4, 6}, {N_E6, 10},
+    {N_D4, 12}, {N_B5, 8}, {N_G4, 6}, {N_D7, 10}
 };
 
-const PROGMEM MusicNote level4_chorus[] = {
-    {NOTE_E4, 10}, {NOTE_C7, 6}, {NOTE_A4, 12}, {NOTE_F6, 8},
-    {NOTE_D5, 6}, {NOTE_B6, 10}, {NOTE_G4, 12}, {NOTE_E7, 8},
-    {NOTE_C5, 6}, {NOTE_A6, 10}, {NOTE_F4, 12}, {NOTE_D7, 6},
-    {NOTE_B4, 8}, {NOTE_G7, 10}, {NOTE_E5, 12}, {NOTE_C6, 6},
-    {NOTE_A5, 8}, {NOTE_F7, 10}, {NOTE_D4, 12}, {NOTE_B5, 6}
+constexpr PROGMEM MusicNote level4_chorus[] = {
+    {N_E4, 10}, {N_C7, 6}, {N_A4, 12}, {N_F6, 8},
+    {N_D5, 6}, {N_B6, 10}, {N_G4, 12}, {N_E7, 8},
+    {N_C5, 6}, {N_A6, 10}, {N_F4, 12}, {N_D7, 6},
+    {N_B4, 8}, {N_G7, 10}, {N_E5, 12}, {N_C6, 6},
+    {N_A5, 8}, {N_F7, 10}, {N_D4, 12}, {N_B5, 6}
 };
 
-const PROGMEM MusicNote level4_hook[] = {
-    {NOTE_G4, 10}, {NOTE_E7, 6}, {NOTE_C5, 12}, {NOTE_A6, 8},
-    {NOTE_F4, 6}, {NOTE_D7, 10}, {NOTE_B5, 12}, {NOTE_G6, 6},
-    {NOTE_E4, 8}, {NOTE_C7, 10}, {NOTE_A4, 12}, {NOTE_F6, 6}
+constexpr PROGMEM MusicNote level4_hook[] = {
+    {N_G4, 10}, {N_E7, 6}, {N_C5, 12}, {N_A6, 8},
+    {N_F4, 6}, {N_D7, 10}, {N_B5, 12}, {N_G6, 6},
+    {N_E4, 8}, {N_C7, 10}, {N_A4, 12}, {N_F6, 6}
 };
 
 // ===== NIVEAU 5 - MOYEN-DIFFICILE =====
 // Notes rapides avec contrastes marqués, sauts moyens
-const PROGMEM MusicNote level5_intro[] = {
-     {NOTE_E5, 4}, {NOTE_B4, 8}, {NOTE_C5, 8}, {NOTE_D5, 4}, 
-     {NOTE_C5, 8}, {NOTE_B4, 8}, {NOTE_A4, 4}, {NOTE_A4, 8}, 
-     {NOTE_C5, 8}, {NOTE_E5, 4}, {NOTE_D5, 8}, {NOTE_C5, 8},
-     {NOTE_B4, 6}, {NOTE_C5, 8}, {NOTE_D5, 4}, {NOTE_E5, 4},
-     {NOTE_C5, 4}, {NOTE_A4, 4}, {NOTE_A4, 2}
-};
-
-const PROGMEM MusicNote level5_verse[] = {
-     {NOTE_D5, 4}, {NOTE_F5, 8}, {NOTE_A5, 4}, {NOTE_G5, 8}, 
-     {NOTE_F5, 8}, {NOTE_E5, 6}, {NOTE_C5, 8}, {NOTE_E5, 4}, 
-     {NOTE_D5, 8}, {NOTE_C5, 8}, {NOTE_B4, 6}, {NOTE_C5, 8}, 
-     {NOTE_D5, 4}, {NOTE_E5, 4}, {NOTE_C5, 4}, {NOTE_A4, 4}, 
-     {NOTE_A4, 2}
-};
-
-const PROGMEM MusicNote level5_chorus[] = {
-    {NOTE_E5, 4}, {NOTE_B4, 8}, {NOTE_C5, 8}, {NOTE_D5, 4}, 
-    {NOTE_C5, 8}, {NOTE_B4, 8}, {NOTE_A4, 4}, {NOTE_A4, 8}, 
-    {NOTE_C5, 8}, {NOTE_E5, 4}, {NOTE_D5, 8}, {NOTE_C5, 8},
-    {NOTE_B4, 6}, {NOTE_C5, 8}, {NOTE_D5, 4}, {NOTE_E5, 4},
-    {NOTE_C5, 4}, {NOTE_A4, 4}, {NOTE_A4, 2}, {NOTE_D5, 4}, 
-    {NOTE_F5, 8}, {NOTE_A5, 4}, {NOTE_G5, 8}, {NOTE_F5, 8}
+constexpr PROGMEM MusicNote level5_intro[] = {
+     {N_E5, 4}, {N_B4, 8}, {N_C5, 8}, {N_D5, 4}, 
+     {N_C5, 8}, {N_B4, 8}, {N_A4, 4}, {N_A4, 8}, 
+     {N_C5, 8}, {N_E5, 4}, {N_D5, 8}, {N_C5, 8},
+     {N_B4, 6}, {N_C5, 8}, {N_D5, 4}, {N_E5, 4},
+     {N_C5, 4}, {N_A4, 4}, {N_A4, 2}
+};
+
+constexpr PROGMEM MusicNote level5_verse[] = {
+     {N_D5, 4}, {N_F5, 8}, {N_A5, 4}, {N_G5, 8}, 
+     {N_F5, 8}, {N_E5, 6}, {N_C5, 8}, {N_E5, 4}, 
+     {N_D5, 8}, {N_C5, 8}, {N_B4, 6}, {N_C5, 8}, 
+     {N_D5, 4}, {N_E5, 4}, {N_C5, 4}, {N_A4, 4}, 
+     {N_A4, 2}
+};
+
+constexpr PROGMEM MusicNote level5_chorus[] = {
+    {N_E5, 4}, {N_B4, 8}, {N_C5, 8}, {N_D5, 4}, 
+    {N_C5, 8}, {N_B4, 8}, {N_A4, 4}, {N_A4, 8}, 
+    {N_C5, 8}, {N_E5, 4}, {N_D5, 8}, {N_C5, 8},
+    {N_B4, 6}, {N_C5, 8}, {N_D5, 4}, {N_E5, 4},
+    {N_C5, 4}, {N_A4, 4}, {N_A4, 2}, {N_D5, 4}, 
+    {N_F5, 8}, {N_A5, 4}, {N_G5, 8}, {N_F5, 8}
  };
 
-const PROGMEM MusicNote level5_hook[] = {
-    {NOTE_E5, 6}, {NOTE_C5, 8}, {NOTE_E5, 4}, {NOTE_D5, 8}, 
-    {NOTE_C5, 8}, {NOTE_B4, 6}, {NOTE_C5, 8}, {NOTE_D5, 4}, 
-    {NOTE_E5, 4}, {NOTE_C5, 4}, {NOTE_A4, 4}, {NOTE_A4, 1}
+constexpr PROGMEM MusicNote level5_hook[] = {
+    {N_E5, 6}, {N_C5, 8}, {N_E5, 4}, {N_D5, 8}, 
+    {N_C5, 8}, {N_B4, 6}, {N_C5, 8}, {N_D5, 4}, 
+    {N_E5, 4}, {N_C5, 4}, {N_A4, 4}, {N_A4, 1}
 };
 
 // ===== NIVEAU 6 - DIFFICILE =====
 // Notes très rapides avec grands contrastes, grands sauts
-const PROGMEM MusicNote level6_intro[] = {
-    {NOTE_C4, 6}, {NOTE_G7, 2}, {NOTE_E4, 6}, {NOTE_C7, 3},
-    {NOTE_A4, 2}, {NOTE_F7, 6}, {NOTE_D4, 4}, {NOTE_B7, 2},
-    {NOTE_F4, 6}, {NOTE_D7, 2}, {NOTE_B4, 4}, {NOTE_A7, 6},
-    {NOTE_G4, 2}, {NOTE_E7, 4}, {NOTE_C5, 6}, {NOTE_G7, 2},
-    {NOTE_A5, 4}, {NOTE_C4, 6}, {NOTE_F5, 2}, {NOTE_B7, 4},
-    {NOTE_D5, 6}, {NOTE_F4, 2}, {NOTE_B5, 4}, {NOTE_E7, 6}
-};
-
-const PROGMEM MusicNote level6_verse[] = {
-    {NOTE_E4, 6}, {NOTE_B7, 1}, {NOTE_A4, 4}, {NOTE_D7, 2},
-    {NOTE_C4, 6}, {NOTE_G7, 1}, {NOTE_F5, 4}, {NOTE_A7, 2},
-    {NOTE_G4, 6}, {NOTE_C7, 1}, {NOTE_B5, 4}, {NOTE_E7, 2},
-    {NOTE_D4, 6}, {NOTE_F7, 1}, {NOTE_A5, 4}, {NOTE_B7, 2},
-    {NOTE_F4, 6}, {NOTE_E7, 1}, {NOTE_C6, 4}, {NOTE_G7, 2},
-    {NOTE_B4, 6}, {NOTE_D7, 1}, {NOTE_G5, 4}, {NOTE_A7, 2},
-    {NOTE_E5, 6}, {NOTE_C4, 1}, {NOTE_A6, 4}, {NOTE_F7, 2},
-    {NOTE_D6, 6}, {NOTE_G4, 1}, {NOTE_B6, 4}, {NOTE_E7, 2}
-};
-
-const PROGMEM MusicNote level6_chorus[] = {
-    {NOTE_F4, 4}, {NOTE_C8, 1}, {NOTE_A5, 6}, {NOTE_D7, 2},
-    {NOTE_C4, 4}, {NOTE_B7, 1}, {NOTE_G6, 6}, {NOTE_E7, 2},
-    {NOTE_D4, 4}, {NOTE_A7, 1}, {NOTE_F6, 6}, {NOTE_C7, 2},
-    {NOTE_B4, 4}, {NOTE_G7, 1}, {NOTE_E6, 6}, {NOTE_F7, 2},
-    {NOTE_A4, 4}, {NOTE_D8, 1}, {NOTE_C5, 6}, {NOTE_B7, 2},
-    {NOTE_G4, 4}, {NOTE_E8, 1}, {NOTE_F5, 6}, {NOTE_A7, 2}
-};
-
-const PROGMEM MusicNote level6_hook[] = {
-    {NOTE_E4, 4}, {NOTE_C8, 1}, {NOTE_B5, 6}, {NOTE_F7, 2},
-    {NOTE_G4, 4}, {NOTE_D8, 1}, {NOTE_A5, 6}, {NOTE_E7, 2},
-    {NOTE_C4, 4}, {NOTE_B7, 1}, {NOTE_F6, 6}, {NOTE_G7, 2},
-    {NOTE_D4, 4}, {NOTE_A8, 1}, {NOTE_E6, 6}, {NOTE_C7, 2}
+constexpr PROGMEM MusicNote level6_intro[] = {
+    {N_C4, 6}, {N_G7, 2}, {N_E4, 6}, {N_C7, 3},
+    {N_A4, 2}, {N_F7, 6}, {N_D4, 4}, {N_B7, 2},
+    {N_F4, 6}, {N_D7, 2}, {N_B4, 4}, {N_A7, 6},
+    {N_G4, 2}, {N_E7, 4}, {N_C5, 6}, {N_G7, 2},
+    {N_A5, 4}, {N_C4, 6}, {N_F5, 2}, {N_B7, 4},
+    {N_D5, 6}, {N_F4, 2}, {N_B5, 4}, {N_E7, 6}
+};
+
+constexpr PROGMEM MusicNote level6_verse[] = {
+    {N_E4, 6}, {N_B7, 1}, {N_A4, 4}, {N_D7, 2},
+    {N_C4, 6}, {N_G7, 1}, {N_F5, 4}, {N_A7, 2},
+    {N_G4, 6}, {N_C7, 1}, {N_B5, 4}, {N_E7, 2},
+    {N_D4, 6}, {N_F7, 1}, {N_A5, 4}, {N_B7, 2},
+    {N_F4, 6}, {N_E7, 1}, {N_C6, 4}, {N_G7, 2},
+    {N_B4, 6}, {N_D7, 1}, {N_G5, 4}, {N_A7, 2},
+    {N_E5, 6}, {N_C4, 1}, {N_A6, 4}, {N_F7, 2},
+    {N_D6, 6}, {N_G4, 1}, {N_B6, 4}, {N_E7, 2}
+};
+
+constexpr PROGMEM MusicNote level6_chorus[] = {
+    {N_F4, 4}, {N_C8, 1}, {N_A5, 6}, {N_D7, 2},
+    {N_C4, 4}, {N_B7, 1}, {N_G6, 6}, {N_E7, 2},
+    {N_D4, 4}, {N_A7, 1}, {N_F6, 6}, {N_C7, 2},
+    {N_B4, 4}, {N_G7, 1}, {N_E6, 6}, {N_F7, 2},
+    {N_A4, 4}, {N_D8, 1}, {N_C5, 6}, {N_B7, 2},
+    {N_G4, 4}, {N_E8, 1}, {N_F5, 6}, {N_A7, 2}
+};
+
+constexpr PROGMEM MusicNote level6_hook[] = {
+    {N_E4, 4}, {N_C8, 1}, {N_B5, 6}, {N_F7, 2},
+    {N_G4, 4}, {N_D8, 1}, {N_A5, 6}, {N_E7, 2},
+    {N_C4, 4}, {N_B7, 1}, {N_F6, 6}, {N_G7, 2},
+    {N_D4, 4}, {N_A8, 1}, {N_E6, 6}, {N_C7, 2}
 };
 
 // ===== NIVEAU 7 - TRÈS DIFFICILE =====
 // Notes ultra-rapides avec patterns complexes, très grands sauts
-const PROGMEM MusicNote level7_intro[] = {
-    {NOTE_C4, 4}, {NOTE_A8, 1}, {NOTE_F4, 4}, {NOTE_D8, 2},
-    {NOTE_B4, 1}, {NOTE_G8, 4}, {NOTE_E4, 2}, {NOTE_C8, 1},
-    {NOTE_A4, 4}, {NOTE_F8, 1}, {NOTE_D4, 2}, {NOTE_B8, 4},
-    {NOTE_G4, 1}, {NOTE_E8, 2}, {NOTE_C5, 4}, {NOTE_A8, 1},
-    {NOTE_F5, 2}, {NOTE_C4, 4}, {NOTE_B5, 1}, {NOTE_G8, 2},
-    {NOTE_E5, 4}, {NOTE_D4, 1}, {NOTE_A6, 2}, {NOTE_F8, 4},
-    {NOTE_D6, 1}, {NOTE_B4, 2}, {NOTE_G6, 4}, {NOTE_E8, 1}
-};
-
-const PROGMEM MusicNote level7_verse[] = {
-    {NOTE_C4, 4}, {NOTE_B8, 1}, {NOTE_G5, 2}, {NOTE_E8, 4},
-    {NOTE_F4, 1}, {NOTE_C8, 4}, {NOTE_A6, 2}, {NOTE_F8, 1},
-    {NOTE_D4, 4}, {NOTE_A8, 1}, {NOTE_B6, 2}, {NOTE_G8, 4},
-    {NOTE_E4, 1}, {NOTE_D8, 2}, {NOTE_C7, 4}, {NOTE_A8, 1},
-    {NOTE_A4, 2}, {NOTE_F8, 4}, {NOTE_D7, 1}, {NOTE_B8, 2},
-    {NOTE_B4, 4}, {NOTE_G8, 1}, {NOTE_E7, 2}, {NOTE_C8, 4},
-    {NOTE_C5, 1}, {NOTE_A8, 2}, {NOTE_F7, 4}, {NOTE_D8, 1},
-    {NOTE_G4, 2}, {NOTE_E8, 4}, {NOTE_A7, 1}, {NOTE_F8, 2},
-    {NOTE_F5, 4}, {NOTE_C4, 1}, {NOTE_B7, 2}, {NOTE_G8, 4},
-    {NOTE_E6, 1}, {NOTE_D4, 2}, {NOTE_G7, 4}, {NOTE_A8, 1}
-};
-
-const PROGMEM MusicNote level7_chorus[] = {
-    {NOTE_D4, 2}, {NOTE_C9, 1}, {NOTE_A5, 4}, {NOTE_F8, 2},
-    {NOTE_E4, 1}, {NOTE_B8, 4}, {NOTE_C6, 2}, {NOTE_G8, 1},
-    {NOTE_F4, 4}, {NOTE_A8, 1}, {NOTE_D6, 2}, {NOTE_E8, 4},
-    {NOTE_G4, 1}, {NOTE_C8, 2}, {NOTE_E6, 4}, {NOTE_D8, 1},
-    {NOTE_A4, 2}, {NOTE_F9, 1}, {NOTE_F6, 4}, {NOTE_B8, 2},
-    {NOTE_B4, 1}, {NOTE_G9, 4}, {NOTE_G6, 2}, {NOTE_A8, 1},
-    {NOTE_C5, 4}, {NOTE_E9, 1}, {NOTE_A6, 2}, {NOTE_C8, 4}
-};
-
-const PROGMEM MusicNote level7_hook[] = {
-    {NOTE_E4, 2}, {NOTE_G9, 1}, {NOTE_B6, 4}, {NOTE_D8, 2},
-    {NOTE_F4, 1}, {NOTE_A9, 4}, {NOTE_C7, 2}, {NOTE_E8, 1},
-    {NOTE_G4, 4}, {NOTE_F9, 1}, {NOTE_D7, 2}, {NOTE_B8, 4},
-    {NOTE_A4, 1}, {NOTE_C9, 2}, {NOTE_E7, 4}, {NOTE_G8, 1},
-    {NOTE_C4, 2}, {NOTE_B9, 1}, {NOTE_F7, 4}, {NOTE_A8, 2},
-    {NOTE_D4, 1}, {NOTE_E9, 4}, {NOTE_G7, 2}, {NOTE_F8, 1}
+constexpr PROGMEM MusicNote level7_intro[] = {
+    {N_C4, 4}, {N_A8, 1}, {N_F4, 4}, {N_D8, 2},
+    {N_B4, 1}, {N_G8, 4}, {N_E4, 2}, {N_C8, 1},
+    {N_A4, 4}, {N_F8, 1}, {N_D4, 2}, {N_B8, 4},
+    {N_G4, 1}, {N_E8, 2}, {N_C5, 4}, {N_A8, 1},
+    {N_F5, 2}, {N_C4, 4}, {N_B5, 1}, {N_G8, 2},
+    {N_E5, 4}, {N_D4, 1}, {N_A6, 2}, {N_F8, 4},
+    {N_D6, 1}, {N_B4, 2}, {N_G6, 4}, {N_E8, 1}
+};
+
+constexpr PROGMEM MusicNote level7_verse[] = {
+    {N_C4, 4}, {N_B8, 1}, {N_G5, 2}, {N_E8, 4},
+    {N_F4, 1}, {N_C8, 4}, {N_A6, 2}, {N_F8, 1},
+    {N_D4, 4}, {N_A8, 1}, {N_B6, 2}, {N_G8, 4},
+    {N_E4, 1}, {N_D8, 2}, {N_C7, 4}, {N_A8, 1},
+    {N_A4, 2}, {N_F8, 4}, {N_D7, 1}, {N_B8, 2},
+    {N_B4, 4}, {N_G8, 1}, {N_E7, 2}, {N_C8, 4},
+    {N_C5, 1}, {N_A8, 2}, {N_F7, 4}, {N_D8, 1},
+    {N_G4, 2}, {N_E8, 4}, {N_A7, 1}, {N_F8, 2},
+    {N_F5, 4}, {N_C4, 1}, {N_B7, 2}, {N_G8, 4},
+    {N_E6, 1}, {N_D4, 2}, {N_G7, 4}, {N_A8, 1}
+};
+
+constexpr PROGMEM MusicNote level7_chorus[] = {
+    {N_D4, 2}, {N_C9, 1}, {N_A5, 4}, {N_F8, 2},
+    {N_E4, 1}, {N_B8, 4}, {N_C6, 2}, {N_G8, 1},
+    {N_F4, 4}, {N_A8, 1}, {N_D6, 2}, {N_E8, 4},
+    {N_G4, 1}, {N_C8, 2}, {N_E6, 4}, {N_D8, 1},
+    {N_A4, 2}, {N_F9, 1}, {N_F6, 4}, {N_B8, 2},
+    {N_B4, 1}, {N_G9, 4}, {N_G6, 2}, {N_A8, 1},
+    {N_C5, 4}, {N_E9, 1}, {N_A6, 2}, {N_C8, 4}
+};
+
+constexpr PROGMEM MusicNote level7_hook[] = {
+    {N_E4, 2}, {N_G9, 1}, {N_B6, 4}, {N_D8, 2},
+    {N_F4, 1}, {N_A9, 4}, {N_C7, 2}, {N_E8, 1},
+    {N_G4, 4}, {N_F9, 1}, {N_D7, 2}, {N_B8, 4},
+    {N_A4, 1}, {N_C9, 2}, {N_E7, 4}, {N_G8, 1},
+    {N_C4, 2}, {N_B9, 1}, {N_F7, 4}, {N_A8, 2},
+    {N_D4, 1}, {N_E9, 4}, {N_G7, 2}, {N_F8, 1}
 };
 
 // ===== NIVEAU 8 - EXPERT =====
 // Patterns rythmiques complexes avec contrastes extrêmes
-const PROGMEM MusicNote level8_intro[] = {
-    {NOTE_C4, 2}, {NOTE_B9, 1}, {NOTE_E4, 3}, {NOTE_A9, 1},
-    {NOTE_G4, 2}, {NOTE_F9, 1}, {NOTE_C4, 3}, {NOTE_G9, 1},
-    {NOTE_F4, 2}, {NOTE_D9, 1}, {NOTE_A4, 3}, {NOTE_E9, 1},
-    {NOTE_D4, 2}, {NOTE_C9, 1}, {NOTE_B4, 3}, {NOTE_F9, 1},
-    {NOTE_G4, 2}, {NOTE_A9, 1}, {NOTE_E4, 3}, {NOTE_B9, 1},
-    {NOTE_C5, 2}, {NOTE_G9, 1}, {NOTE_A4, 3}, {NOTE_D9, 1},
-    {NOTE_F5, 2}, {NOTE_E9, 1}, {NOTE_D4, 3}, {NOTE_C9, 1},
-    {NOTE_B5, 2}, {NOTE_F9, 1}, {NOTE_G4, 3}, {NOTE_A9, 1},
-    {NOTE_E6, 2}, {NOTE_B9, 1}, {NOTE_C4, 3}, {NOTE_G9, 1}
-};
-
-const PROGMEM MusicNote level8_verse[] = {
-    {NOTE_F4, 1}, {NOTE_G9, 2}, {NOTE_C7, 1}, {NOTE_D9, 3},
-    {NOTE_A4, 2}, {NOTE_F9, 1}, {NOTE_D7, 1}, {NOTE_A9, 2},
-    {NOTE_B4, 1}, {NOTE_E9, 3}, {NOTE_E7, 2}, {NOTE_B9, 1},
-    {NOTE_C4, 1}, {NOTE_C9, 2}, {NOTE_F7, 1}, {NOTE_E9, 3},
-    {NOTE_G4, 2}, {NOTE_A9, 1}, {NOTE_G7, 1}, {NOTE_F9, 2},
-    {NOTE_D4, 1}, {NOTE_B9, 3}, {NOTE_A7, 2}, {NOTE_G9, 1},
-    {NOTE_E4, 1}, {NOTE_D9, 2}, {NOTE_B7, 1}, {NOTE_A9, 3},
-    {NOTE_F5, 2}, {NOTE_E9, 1}, {NOTE_C8, 1}, {NOTE_B9, 2},
-    {NOTE_A5, 1}, {NOTE_F9, 3}, {NOTE_D8, 2}, {NOTE_C9, 1},
-    {NOTE_B5, 1}, {NOTE_G9, 2}, {NOTE_E8, 1}, {NOTE_D9, 3},
-    {NOTE_C6, 2}, {NOTE_A9, 1}, {NOTE_F8, 1}, {NOTE_E9, 2},
-    {NOTE_G6, 1}, {NOTE_B9, 3}, {NOTE_G8, 2}, {NOTE_F9, 1}
-};
-
-const PROGMEM MusicNote level8_chorus[] = {
-    {NOTE_D4, 1}, {NOTE_A9, 2}, {NOTE_A8, 1}, {NOTE_G9, 3},
-    {NOTE_E4, 2}, {NOTE_B9, 1}, {NOTE_B8, 1}, {NOTE_A9, 2},
-    {NOTE_F4, 1}, {NOTE_C9, 3}, {NOTE_C9, 2}, {NOTE_B9, 1},
-    {NOTE_G4, 1}, {NOTE_D9, 2}, {NOTE_D9, 1}, {NOTE_C9, 3},
-    {NOTE_A4, 2}, {NOTE_E9, 1}, {NOTE_E9, 1}, {NOTE_D9, 2},
-    {NOTE_B4, 1}, {NOTE_F9, 3}, {NOTE_F9, 2}, {NOTE_E9, 1},
-    {NOTE_C5, 1}, {NOTE_G9, 2}, {NOTE_G9, 1}, {NOTE_F9, 3},
-    {NOTE_D5, 2}, {NOTE_A9, 1}, {NOTE_A9, 1}, {NOTE_G9, 2}
-};
-
-const PROGMEM MusicNote level8_hook[] = {
-    {NOTE_E5, 1}, {NOTE_B9, 2}, {NOTE_B9, 1}, {NOTE_A9, 3},
-    {NOTE_F5, 2}, {NOTE_C9, 1}, {NOTE_C9, 1}, {NOTE_B9, 2},
-    {NOTE_G5, 1}, {NOTE_D9, 3}, {NOTE_D9, 2}, {NOTE_C9, 1},
-    {NOTE_A5, 1}, {NOTE_E9, 2}, {NOTE_E9, 1}, {NOTE_D9, 3},
-    {NOTE_B5, 2}, {NOTE_F9, 1}, {NOTE_F9, 1}, {NOTE_E9, 2},
-    {NOTE_C6, 1}, {NOTE_G9, 3}, {NOTE_G9, 2}, {NOTE_F9, 1}
+constexpr PROGMEM MusicNote level8_intro[] = {
+    {N_C4, 2}, {N_B9, 1}, {N_E4, 3}, {N_A9, 1},
+    {N_G4, 2}, {N_F9, 1}, {N_C4, 3}, {N_G9, 1},
+    {N_F4, 2}, {N_D9, 1}, {N_A4, 3}, {N_E9, 1},
+    {N_D4, 2}, {N_C9, 1}, {N_B4, 3}, {N_F9, 1},
+    {N_G4, 2}, {N_A9, 1}, {N_E4, 3}, {N_B9, 1},
+    {N_C5, 2}, {N_G9, 1}, {N_A4, 3}, {N_D9, 1},
+    {N_F5, 2}, {N_E9, 1}, {N_D4, 3}, {N_C9, 1},
+    {N_B5, 2}, {N_F9, 1}, {N_G4, 3}, {N_A9, 1},
+    {N_E6, 2}, {N_B9, 1}, {N_C4, 3}, {N_G9, 1}
+};
+
+constexpr PROGMEM MusicNote level8_verse[] = {
+    {N_F4, 1}, {N_G9, 2}, {N_C7, 1}, {N_D9, 3},
+    {N_A4, 2}, {N_F9, 1}, {N_D7, 1}, {N_A9, 2},
+    {N_B4, 1}, {N_E9, 3}, {N_E7, 2}, {N_B9, 1},
+    {N_C4, 1}, {N_C9, 2}, {N_F7, 1}, {N_E9, 3},
+    {N_G4, 2}, {N_A9, 1}, {N_G7, 1}, {N_F9, 2},
+    {N_D4, 1}, {N_B9, 3}, {N_A7, 2}, {N_G9, 1},
+    {N_E4, 1}, {N_D9, 2}, {N_B7, 1}, {N_A9, 3},
+    {N_F5, 2}, {N_E9, 1}, {N_C8, 1}, {N_B9, 2},
+    {N_A5, 1}, {N_F9, 3}, {N_D8, 2}, {N_C9, 1},
+    {N_B5, 1}, {N_G9, 2}, {N_E8, 1}, {N_D9, 3},
+    {N_C6, 2}, {N_A9, 1}, {N_F8, 1}, {N_E9, 2},
+    {N_G6, 1}, {N_B9, 3}, {N_G8, 2}, {N_F9, 1}
+};
+
+constexpr PROGMEM MusicNote level8_chorus[] = {
+    {N_D4, 1}, {N_A9, 2}, {N_A8, 1}, {N_G9, 3},
+    {N_E4, 2}, {N_B9, 1}, {N_B8, 1}, {N_A9, 2},
+    {N_F4, 1}, {N_C9, 3}, {N_C9, 2}, {N_B9, 1},
+    {N_G4, 1}, {N_D9, 2}, {N_D9, 1}, {N_C9, 3},
+    {N_A4, 2}, {N_E9, 1}, {N_E9, 1}, {N_D9, 2},
+    {N_B4, 1}, {N_F9, 3}, {N_F9, 2}, {N_E9, 1},
+    {N_C5, 1}, {N_G9, 2}, {N_G9, 1}, {N_F9, 3},
+    {N_D5, 2}, {N_A9, 1}, {N_A9, 1}, {N_G9, 2}
+};
+
+constexpr PROGMEM MusicNote level8_hook[] = {
+    {N_E5, 1}, {N_B9, 2}, {N_B9, 1}, {N_A9, 3},
+    {N_F5, 2}, {N_C9, 1}, {N_C9, 1}, {N_B9, 2},
+    {N_G5, 1}, {N_D9, 3}, {N_D9, 2}, {N_C9, 1},
+    {N_A5, 1}, {N_E9, 2}, {N_E9, 1}, {N_D9, 3},
+    {N_B5, 2}, {N_F9, 1}, {N_F9, 1}, {N_E9, 2},
+    {N_C6, 1}, {N_G9, 3}, {N_G9, 2}, {N_F9, 1}
 };
 
 // ===== NIVEAU 9 - IMPOSSIBLE =====
 // Mix de durées courtes, sauts chaotiques
-const PROGMEM MusicNote level9_intro[] = {
-    {NOTE_C4, 1}, {NOTE_G9, 3}, {NOTE_E4, 1}, {NOTE_B9, 2},
-    {NOTE_A8, 1}, {NOTE_D4, 3}, {NOTE_F9, 1}, {NOTE_G4, 2},
-    {NOTE_C9, 1}, {NOTE_B4, 3}, {NOTE_A9, 1}, {NOTE_E4, 2},
-    {NOTE_D9, 1}, {NOTE_F5, 3}, {NOTE_G9, 1}, {NOTE_A4, 2},
-    {NOTE_E9, 1}, {NOTE_C6, 3}, {NOTE_B9, 1}, {NOTE_D4, 2},
-    {NOTE_F9, 1}, {NOTE_G6, 3}, {NOTE_A9, 1}, {NOTE_B5, 2},
-    {NOTE_C9, 1}, {NOTE_E7, 3}, {NOTE_D9, 1}, {NOTE_F4, 2},
-    {NOTE_G9, 1}, {NOTE_A7, 3}, {NOTE_E9, 1}, {NOTE_C5, 2},
-    {NOTE_B9, 1}, {NOTE_D8, 3}, {NOTE_F9, 1}, {NOTE_G5, 2}
-};
-
-const PROGMEM MusicNote level9_verse[] = {
-    {NOTE_A9, 1}, {NOTE_E8, 2}, {NOTE_C4, 1}, {NOTE_B9, 3},
-    {NOTE_F8, 1}, {NOTE_D4, 2}, {NOTE_G9, 1}, {NOTE_A8, 3},
-    {NOTE_E4, 1}, {NOTE_C9, 2}, {NOTE_B8, 1}, {NOTE_F4, 3},
-    {NOTE_D9, 1}, {NOTE_G4, 2}, {NOTE_C9, 1}, {NOTE_A4, 3},
-    {NOTE_E9, 1}, {NOTE_D8, 2}, {NOTE_F9, 1}, {NOTE_B4, 3},
-    {NOTE_G8, 1}, {NOTE_C5, 2}, {NOTE_A9, 1}, {NOTE_E8, 3},
-    {NOTE_B9, 1}, {NOTE_F5, 2}, {NOTE_C8, 1}, {NOTE_G5, 3},
-    {NOTE_D9, 1}, {NOTE_A8, 2}, {NOTE_E9, 1}, {NOTE_B5, 3},
-    {NOTE_F8, 1}, {NOTE_C6, 2}, {NOTE_G9, 1}, {NOTE_D8, 3},
-    {NOTE_A9, 1}, {NOTE_E6, 2}, {NOTE_B8, 1}, {NOTE_F6, 3},
-    {NOTE_C9, 1}, {NOTE_G8, 2}, {NOTE_D9, 1}, {NOTE_A6, 3},
-    {NOTE_E8, 1}, {NOTE_B6, 2}, {NOTE_F9, 1}, {NOTE_C7, 3},
-    {NOTE_G8, 1}, {NOTE_D7, 2}, {NOTE_A9, 1}, {NOTE_E7, 3},
-    {NOTE_B8, 1}, {NOTE_F7, 2}, {NOTE_C9, 1}, {NOTE_G7, 3}
-};
-
-const PROGMEM MusicNote level9_chorus[] = {
-    {NOTE_D9, 1}, {NOTE_A7, 2}, {NOTE_E8, 1}, {NOTE_B7, 3},
-    {NOTE_F9, 1}, {NOTE_C8, 2}, {NOTE_G8, 1}, {NOTE_D8, 3},
-    {NOTE_A9, 1}, {NOTE_E8, 2}, {NOTE_B8, 1}, {NOTE_F8, 3},
-    {NOTE_C9, 1}, {NOTE_G8, 2}, {NOTE_D8, 1}, {NOTE_A8, 3},
-    {NOTE_E9, 1}, {NOTE_B8, 2}, {NOTE_F8, 1}, {NOTE_C9, 3},
-    {NOTE_G9, 1}, {NOTE_D9, 2}, {NOTE_A8, 1}, {NOTE_E9, 3},
-    {NOTE_B9, 1}, {NOTE_F9, 2}, {NOTE_C8, 1}, {NOTE_G9, 3},
-    {NOTE_A9, 1}, {NOTE_E9, 2}, {NOTE_D8, 1}, {NOTE_B9, 3},
-    {NOTE_F9, 1}, {NOTE_C9, 2}, {NOTE_G8, 1}, {NOTE_A9, 3},
-    {NOTE_E9, 1}, {NOTE_D9, 2}, {NOTE_B8, 1}, {NOTE_F9, 3}
-};
-
-const PROGMEM MusicNote level9_hook[] = {
-    {NOTE_G9, 1}, {NOTE_C8, 3}, {NOTE_A8, 1}, {NOTE_E9, 2},
-    {NOTE_B9, 1}, {NOTE_D8, 3}, {NOTE_C8, 1}, {NOTE_F9, 2},
-    {NOTE_D9, 1}, {NOTE_G8, 3}, {NOTE_E8, 1}, {NOTE_A9, 2},
-    {NOTE_F9, 1}, {NOTE_B8, 3}, {NOTE_G8, 1}, {NOTE_C9, 2},
-    {NOTE_A9, 1}, {NOTE_D8, 3}, {NOTE_B8, 1}, {NOTE_E9, 2},
-    {NOTE_C9, 1}, {NOTE_F8, 3}, {NOTE_D8, 1}, {NOTE_G9, 2},
-    {NOTE_E9, 1}, {NOTE_A8, 3}, {NOTE_F8, 1}, {NOTE_B9, 2},
-    {NOTE_G9, 1}, {NOTE_C8, 3}, {NOTE_A8, 1}, {NOTE_D9, 2}
+constexpr PROGMEM MusicNote level9_intro[] = {
+    {N_C4, 1}, {N_G9, 3}, {N_E4, 1}, {N_B9, 2},
+    {N_A8, 1}, {N_D4, 3}, {N_F9, 1}, {N_G4, 2},
+    {N_C9, 1}, {N_B4, 3}, {N_A9, 1}, {N_E4, 2},
+    {N_D9, 1}, {N_F5, 3}, {N_G9, 1}, {N_A4, 2},
+    {N_E9, 1}, {N_C6, 3}, {N_B9, 1}, {N_D4, 2},
+    {N_F9, 1}, {N_G6, 3}, {N_A9, 1}, {N_B5, 2},
+    {N_C9, 1}, {N_E7, 3}, {N_D9, 1}, {N_F4, 2},
+    {N_G9, 1}, {N_A7, 3}, {N_E9, 1}, {N_C5, 2},
+    {N_B9, 1}, {N_D8, 3}, {N_F9, 1}, {N_G5, 2}
+};
+
+constexpr PROGMEM MusicNote level9_verse[] = {
+    {N_A9, 1}, {N_E8, 2}, {N_C4, 1}, {N_B9, 3},
+    {N_F8, 1}, {N_D4, 2}, {N_G9, 1}, {N_A8, 3},
+    {N_E4, 1}, {N_C9, 2}, {N_B8, 1}, {N_F4, 3},
+    {N_D9, 1}, {N_G4, 2}, {N_C9, 1}, {N_A4, 3},
+    {N_E9, 1}, {N_D8, 2}, {N_F9, 1}, {N_B4, 3},
+    {N_G8, 1}, {N_C5, 2}, {N_A9, 1}, {N_E8, 3},
+    {N_B9, 1}, {N_F5, 2}, {N_C8, 1}, {N_G5, 3},
+    {N_D9, 1}, {N_A8, 2}, {N_E9, 1}, {N_B5, 3},
+    {N_F8, 1}, {N_C6, 2}, {N_G9, 1}, {N_D8, 3},
+    {N_A9, 1}, {N_E6, 2}, {N_B8, 1}, {N_F6, 3},
+    {N_C9, 1}, {N_G8, 2}, {N_D9, 1}, {N_A6, 3},
+    {N_E8, 1}, {N_B6, 2}, {N_F9, 1}, {N_C7, 3},
+    {N_G8, 1}, {N_D7, 2}, {N_A9, 1}, {N_E7, 3},
+    {N_B8, 1}, {N_F7, 2}, {N_C9, 1}, {N_G7, 3}
+};
+
+constexpr PROGMEM MusicNote level9_chorus[] = {
+    {N_D9, 1}, {N_A7, 2}, {N_E8, 1}, {N_B7, 3},
+    {N_F9, 1}, {N_C8, 2}, {N_G8, 1}, {N_D8, 3},
+    {N_A9, 1}, {N_E8, 2}, {N_B8, 1}, {N_F8, 3},
+    {N_C9, 1}, {N_G8, 2}, {N_D8, 1}, {N_A8, 3},
+    {N_E9, 1}, {N_B8, 2}, {N_F8, 1}, {N_C9, 3},
+    {N_G9, 1}, {N_D9, 2}, {N_A8, 1}, {N_E9, 3},
+    {N_B9, 1}, {N_F9, 2}, {N_C8, 1}, {N_G9, 3},
+    {N_A9, 1}, {N_E9, 2}, {N_D8, 1}, {N_B9, 3},
+    {N_F9, 1}, {N_C9, 2}, {N_G8, 1}, {N_A9, 3},
+    {N_E9, 1}, {N_D9, 2}, {N_B8, 1}, {N_F9, 3}
+};
+
+constexpr PROGMEM MusicNote level9_hook[] = {
+    {N_G9, 1}, {N_C8, 3}, {N_A8, 1}, {N_E9, 2},
+    {N_B9, 1}, {N_D8, 3}, {N_C8, 1}, {N_F9, 2},
+    {N_D9, 1}, {N_G8, 3}, {N_E8, 1}, {N_A9, 2},
+    {N_F9, 1}, {N_B8, 3}, {N_G8, 1}, {N_C9, 2},
+    {N_A9, 1}, {N_D8, 3}, {N_B8, 1}, {N_E9, 2},
+    {N_C9, 1}, {N_F8, 3}, {N_D8, 1}, {N_G9, 2},
+    {N_E9, 1}, {N_A8, 3}, {N_F8, 1}, {N_B9, 2},
+    {N_G9, 1}, {N_C8, 3}, {N_A8, 1}, {N_D9, 2}
 };
 
 // ===== MUSIQUE ORIGINALE (sera le niveau par défaut si besoin) =====
 // Introduction - notes avec durée 4
-const PROGMEM MusicNote intro[] = {
-    {NOTE_C4, 4}, {NOTE_D4, 4}, {NOTE_E4, 4}, {NOTE_F4, 4},
-    {NOTE_G4, 4}, {NOTE_A4, 4}, {NOTE_B4, 4}, {NOTE_C5, 4},
-    {NOTE_D5, 4}, {NOTE_E5, 4}, {NOTE_F5, 4}, {NOTE_G5, 4},
-    {NOTE_A5, 4}, {NOTE_B5, 4}, {NOTE_C6, 4}, {NOTE_D6, 4},
-    {NOTE_E6, 4}, {NOTE_F6, 4}
+constexpr PROGMEM MusicNote intro[] = {
+    {N_C4, 4}, {N_D4, 4}, {N_E4, 4}, {N_F4, 4},
+    {N_G4, 4}, {N_A4, 4}, {N_B4, 4}, {N_C5, 4},
+    {N_D5, 4}, {N_E5, 4}, {N_F5, 4}, {N_G5, 4},
+    {N_A5, 4}, {N_B5, 4}, {N_C6, 4}, {N_D6, 4},
+    {N_E6, 4}, {N_F6, 4}
 };
 
 // Couplet - notes avec durée 8
-const PROGMEM MusicNote verse[] = {
-    {NOTE_C4, 8}, {NOTE_D4, 8}, {NOTE_E4, 8}, {NOTE_F4, 8},
-    {NOTE_G4, 8}, {NOTE_A4, 8}, {NOTE_B4, 8}, {NOTE_C5, 8},
-    {NOTE_D5, 8}, {NOTE_E5, 8}, {NOTE_F5, 8}, {NOTE_G5, 8},
-    {NOTE_A5, 8}, {NOTE_B5, 8}, {NOTE_C6, 8}, {NOTE_D6, 8},
-    {NOTE_E6, 8}, {NOTE_F6, 8}, {NOTE_G6, 8}, {NOTE_A6, 8},
-    {NOTE_B6, 8}, {NOTE_C7, 8}, {NOTE_D7, 8}, {NOTE_E7, 8},
-    {NOTE_F7, 8}, {NOTE_G7, 8}, {NOTE_A7, 8}, {NOTE_B7, 8}
+constexpr PROGMEM MusicNote verse[] = {
+    {N_C4, 8}, {N_D4, 8}, {N_E4, 8}, {N_F4, 8},
+    {N_G4, 8}, {N_A4, 8}, {N_B4, 8}, {N_C5, 8},
+    {N_D5, 8}, {N_E5, 8}, {N_F5, 8}, {N_G5, 8},
+    {N_A5, 8}, {N_B5, 8}, {N_C6, 8}, {N_D6, 8},
+    {N_E6, 8}, {N_F6, 8}, {N_G6, 8}, {N_A6, 8},
+    {N_B6, 8}, {N_C7, 8}, {N_D7, 8}, {N_E7, 8},
+    {N_F7, 8}, {N_G7, 8}, {N_A7, 8}, {N_B7, 8}
     // Réduction de la taille pour économiser la mémoire
 };
 
 // Refrain - notes avec durée 16
-const PROGMEM MusicNote chorus[] = {
-    {NOTE_C4, 16}, {NOTE_D4, 16}, {NOTE_E4, 16}, {NOTE_F4, 16},
-    {NOTE_G4, 16}, {NOTE_A4, 16}, {NOTE_B4, 16}, {NOTE_C5, 16},
-    {NOTE_D5, 16}, {NOTE_E5, 16}, {NOTE_F5, 16}, {NOTE_G5, 16},
-    {NOTE_A5, 16}, {NOTE_B5, 16}, {NOTE_C6, 16}, {NOTE_D6, 16}
+constexpr PROGMEM MusicNote chorus[] = {
+    {N_C4, 16}, {N_D4, 16}, {N_E4, 16}, {N_F4, 16},
+    {N_G4, 16}, {N_A4, 16}, {N_B4, 16}, {N_C5, 16},
+    {N_D5, 16}, {N_E5, 16}, {N_F5, 16}, {N_G5, 16},
+    {N_A5, 16}, {N_B5, 16}, {N_C6, 16}, {N_D6, 16}
     // Réduction de la taille pour économiser la mémoire
 };
 
 // Hook - notes avec durée 2
-const PROGMEM MusicNote hookPart[] = {
-    {NOTE_C4, 2}, {NOTE_D4, 2}, {NOTE_E4, 2}, {NOTE_F4, 2},
-    {NOTE_G4, 2}, {NOTE_A4, 2}, {NOTE_B4, 2}, {NOTE_C5, 2},
-    {NOTE_D5, 2}, {NOTE_E5, 2}, {NOTE_F5, 2}, {NOTE_G5, 2}
+constexpr PROGMEM MusicNote hookPart[] = {
+    {N_C4, 2}, {N_D4, 2}, {N_E4, 2}, {N_F4, 2},
+    {N_G4, 2}, {N_A4, 2}, {N_B4, 2}, {N_C5, 2},
+    {N_D5, 2}, {N_E5, 2}, {N_F5, 2}, {N_G5, 2}
     // Réduction de la taille pour économiser la mémoire
 };
 
-// Tailles des tableaux - valeurs constantes pour économiser des calculs
-#define INTRO_SIZE 18
-#define VERSE_SIZE 28
-#define CHORUS_SIZE 16
-#define HOOK_SIZE 12
+// Tailles des tableaux - calculées à la compilation (une taille écrite à la main
+// qui dépasse le tableau ferait lire les notes du tableau suivant)
+#define PATTERN_SIZE(a) (sizeof(a) / sizeof(MusicNote))
+#define INTRO_SIZE PATTERN_SIZE(intro)
+#define VERSE_SIZE PATTERN_SIZE(verse)
+#define CHORUS_SIZE PATTERN_SIZE(chorus)
+#define HOOK_SIZE PATTERN_SIZE(hookPart)
 
 // ===== TAILLES DES NOUVEAUX PATTERNS PAR NIVEAU =====
 // Niveau 1 - Très facile
-#define LEVEL1_INTRO_SIZE 10
-#define LEVEL1_VERSE_SIZE 16
-#define LEVEL1_CHORUS_SIZE 12
-#define LEVEL1_HOOK_SIZE 8
+#define LEVEL1_INTRO_SIZE PATTERN_SIZE(level1_intro)
+#define LEVEL1_VERSE_SIZE PATTERN_SIZE(level1_verse)
+#define LEVEL1_CHORUS_SIZE PATTERN_SIZE(level1_chorus)
+#define LEVEL1_HOOK_SIZE PATTERN_SIZE(level1_hook)
 
 // Niveau 2 - Facile
-#define LEVEL2_INTRO_SIZE 12
-#define LEVEL2_VERSE_SIZE 20
-#define LEVEL2_CHORUS_SIZE 16
-#define LEVEL2_HOOK_SIZE 10
+#define LEVEL2_INTRO_SIZE PATTERN_SIZE(level2_intro)
+#define LEVEL2_VERSE_SIZE PATTERN_SIZE(level2_verse)
+#define LEVEL2_CHORUS_SIZE PATTERN_SIZE(level2_chorus)
+#define LEVEL2_HOOK_SIZE PATTERN_SIZE(level2_hook)
 
 // Niveau 3 - Facile-Moyen
-#define LEVEL3_INTRO_SIZE 16
-#define LEVEL3_VERSE_SIZE 24
-#define LEVEL3_CHORUS_SIZE 16
-#define LEVEL3_HOOK_SIZE 12
+#define LEVEL3_INTRO_SIZE PATTERN_SIZE(level3_intro)
+#define LEVEL3_VERSE_SIZE PATTERN_SIZE(level3_verse)
+#define LEVEL3_CHORUS_SIZE PATTERN_SIZE(level3_chorus)
+#define LEVEL3_HOOK_SIZE PATTERN_SIZE(level3_hook)
 
 // Niveau 4 - Moyen
-#define LEVEL4_INTRO_SIZE 16
-#define LEVEL4_VERSE_SIZE 24
-#define LEVEL4_CHORUS_SIZE 20
-#define LEVEL4_HOOK_SIZE 12
+#define LEVEL4_INTRO_SIZE PATTERN_SIZE(level4_intro)
+#define LEVEL4_VERSE_SIZE PATTERN_SIZE(level4_verse)
+#define LEVEL4_CHORUS_SIZE PATTERN_SIZE(level4_chorus)
+#define LEVEL4_HOOK_SIZE PATTERN_SIZE(level4_hook)
 
 // Niveau 5 - Moyen-Difficile
-#define LEVEL5_INTRO_SIZE 20
-#define LEVEL5_VERSE_SIZE 28
-#define LEVEL5_CHORUS_SIZE 20
-#define LEVEL5_HOOK_SIZE 14
+#define LEVEL5_INTRO_SIZE PATTERN_SIZE(level5_intro)
+#define LEVEL5_VERSE_SIZE PATTERN_SIZE(level5_verse)
+#define LEVEL5_CHORUS_SIZE PATTERN_SIZE(level5_chorus)
+#define LEVEL5_HOOK_SIZE PATTERN_SIZE(level5_hook)
 
 // Niveau 6 - Difficile
-#define LEVEL6_INTRO_SIZE 24
-#define LEVEL6_VERSE_SIZE 32
-#define LEVEL6_CHORUS_SIZE 20
-#define LEVEL6_HOOK_SIZE 16
+#define LEVEL6_INTRO_SIZE PATTERN_SIZE(level6_intro)
+#define LEVEL6_VERSE_SIZE PATTERN_SIZE(level6_verse)
+#define LEVEL6_CHORUS_SIZE PATTERN_SIZE(level6_chorus)
+#define LEVEL6_HOOK_SIZE PATTERN_SIZE(level6_hook)
 
 // Niveau 7 - Très Difficile
-#define LEVEL7_INTRO_SIZE 28
-#define LEVEL7_VERSE_SIZE 40
-#define LEVEL7_CHORUS_SIZE 28
-#define LEVEL7_HOOK_SIZE 24
+#define LEVEL7_INTRO_SIZE PATTERN_SIZE(level7_intro)
+#define LEVEL7_VERSE_SIZE PATTERN_SIZE(level7_verse)
+#define LEVEL7_CHORUS_SIZE PATTERN_SIZE(level7_chorus)
+#define LEVEL7_HOOK_SIZE PATTERN_SIZE(level7_hook)
 
 // Niveau 8 - Expert
-#define LEVEL8_INTRO_SIZE 36
-#define LEVEL8_VERSE_SIZE 48
-#define LEVEL8_CHORUS_SIZE 32
-#define LEVEL8_HOOK_SIZE 24
+#define LEVEL8_INTRO_SIZE PATTERN_SIZE(level8_intro)
+#define LEVEL8_VERSE_SIZE PATTERN_SIZE(level8_verse)
+#define LEVEL8_CHORUS_SIZE PATTERN_SIZE(level8_chorus)
+#define LEVEL8_HOOK_SIZE PATTERN_SIZE(level8_hook)
 
 // Niveau 9 - Impossible
-#define LEVEL9_INTRO_SIZE 36
-#define LEVEL9_VERSE_SIZE 56
-#define LEVEL9_CHORUS_SIZE 40
-#define LEVEL9_HOOK_SIZE 32
+#define LEVEL9_INTRO_SIZE PATTERN_SIZE(level9_intro)
+#define LEVEL9_VERSE_SIZE PATTERN_SIZE(level9_verse)
+#define LEVEL9_CHORUS_SIZE PATTERN_SIZE(level9_chorus)
+#define LEVEL9_HOOK_SIZE PATTERN_SIZE(level9_hook)
+
+// ===== VÉRIFICATION DES PATTERNS À LA COMPILATION =====
+// Chaque note doit être dans la table (donc avoir un couloir) et durer de 1 à 32
+constexpr bool patternValid(const MusicNote* notes, uint8_t count) {
+  return count == 0 ||
+         (notes[count - 1].note < NOTE_COUNT && noteRow(notes[count - 1].note) < NOTE_LANES * NOTE_LANE_HEIGHT &&
+          notes[count - 1].duration >= 1 && notes[count - 1].duration <= NOTE_MAX_DURATION &&
+          patternValid(notes, count - 1));
+}
+#define CHECK_PATTERN(a) static_assert(PATTERN_SIZE(a) <= 255 && patternValid(a, PATTERN_SIZE(a)), \
+                                       #a " : note hors table ou durée invalide");
+CHECK_PATTERN(intro)
+CHECK_PATTERN(verse)
+CHECK_PATTERN(chorus)
+CHECK_PATTERN(hookPart)
+CHECK_PATTERN(level1_intro)
+CHECK_PATTERN(level1_verse)
+CHECK_PATTERN(level1_chorus)
+CHECK_PATTERN(level1_hook)
+CHECK_PATTERN(level2_intro)
+CHECK_PATTERN(level2_verse)
+CHECK_PATTERN(level2_chorus)
+CHECK_PATTERN(level2_hook)
+CHECK_PATTERN(level3_intro)
+CHECK_PATTERN(level3_verse)
+CHECK_PATTERN(level3_chorus)
+CHECK_PATTERN(level3_hook)
+CHECK_PATTERN(level4_intro)
+CHECK_PATTERN(level4_verse)
+CHECK_PATTERN(level4_chorus)
+CHECK_PATTERN(level4_hook)
+CHECK_PATTERN(level5_intro)
+CHECK_PATTERN(level5_verse)
+CHECK_PATTERN(level5_chorus)
+CHECK_PATTERN(level5_hook)
+CHECK_PATTERN(level6_intro)
+CHECK_PATTERN(level6_verse)
+CHECK_PATTERN(level6_chorus)
+CHECK_PATTERN(level6_hook)
+CHECK_PATTERN(level7_intro)
+CHECK_PATTERN(level7_verse)
+CHECK_PATTERN(level7_chorus)
+CHECK_PATTERN(level7_hook)
+CHECK_PATTERN(level8_intro)
+CHECK_PATTERN(level8_verse)
+CHECK_PATTERN(level8_chorus)
+CHECK_PATTERN(level8_hook)
+CHECK_PATTERN(level9_intro)
+CHECK_PATTERN(level9_verse)
+CHECK_PATTERN(level9_chorus)
+CHECK_PATTERN(level9_hook)
+#undef CHECK_PATTERN
 
 // Fonction helper pour lire une note depuis PROGMEM
 inline void getNote(const MusicNote* array, uint8_t index, MusicNote* result) {
-  result->frequency = pgm_read_word(&(array[index].frequency));
+  result->note = pgm_read_byte(&(array[index].note));
   result->duration = pgm_read_byte(&(array[index].duration));
 }
 
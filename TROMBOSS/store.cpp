@@ -0,0 +1,232 @@
+#include <Arduino.h>
+#include "store.h"
+
+#include <avr/eeprom.h>
+
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#define STORE_LOCK()   uint8_t store_sreg = SREG; cli()
+#define STORE_UNLOCK() SREG = store_sreg
+#else
+#define STORE_LOCK()   noInterrupts()
+#define STORE_UNLOCK() interrupts()
+#endif
+
+// record layout
+#define STORE_COMMIT 0          // STORE_MAGIC once complete
+#define STORE_SEQUENCE 1        // 2 bytes, little endian
+#define STORE_LEVEL 3
+#define STORE_BEST 4            // STORE_LEVELS bytes
+#define STORE_CHECK (STORE_RECORD - 1)
+// writes of a record: commit byte cleared, bytes 1..STORE_CHECK, commit byte set
+#define STORE_WRITES (STORE_RECORD + 1)
+
+static_assert(STORE_BEST + STORE_LEVELS <= STORE_CHECK, "state fits in a record");
+static_assert(STORE_SLOTS >= 2, "the newest record is never overwritten");
+
+volatile StoreStats store_stats;
+
+static StoreState store_state;              // latest state
+static uint8_t store_dirty = 0;             // store_state differs from the newest record
+static uint8_t store_record[STORE_RECORD];  // record being written
+static uint8_t store_slot = 0;              // its slot
+static uint8_t store_step = 0;              // next of its STORE_WRITES writes
+static uint8_t store_newest = STORE_SLOTS - 1;
+
+
+/*
+ * store_crc
+ * CRC-8 (polynomial 0x07): catches any error confined to one byte, such
+ * as a write cut by a power loss.
+ */
+static uint8_t store_crc(const uint8_t* data, uint8_t length)
+{
+  uint8_t crc = 0;
+  while (length--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+
+static inline uint16_t store_address(uint8_t slot, uint8_t offset)
+{
+  return STORE_BASE + (uint16_t)slot * STORE_RECORD + offset;
+}
+
+
+/*
+ * store_start
+ * snapshot the state into the next slot; called with interrupts disabled.
+ */
+static void store_start()
+{
+  store_slot = (store_newest + 1) % STORE_SLOTS;
+  uint16_t sequence = store_stats.sequence + 1;
+  store_record[STORE_COMMIT] = STORE_MAGIC;
+  store_record[STORE_SEQUENCE] = sequence & 0xFF;
+  store_record[STORE_SEQUENCE + 1] = sequence >> 8;
+  store_record[STORE_LEVEL] = store_state.level;
+  for (uint8_t i = 0; i < STORE_LEVELS; i++)
+    store_record[STORE_BEST + i] = store_state.best[i];
+  for (uint8_t i = STORE_BEST + STORE_LEVELS; i < STORE_CHECK; i++)
+    store_record[i] = 0;
+  store_record[STORE_CHECK] = store_crc(&store_record[STORE_SEQUENCE], STORE_CHECK - STORE_SEQUENCE);
+  store_step = 0;
+  store_dirty = 0;
+  store_stats.busy = 1;
+}
+
+
+/*
+ * store_next
+ * the byte of the current step: address and value, or false once the
+ * record is complete (then the next one starts if the state changed).
+ */
+static bool store_next(uint16_t* address, uint8_t* value)
+{
+  if (store_step >= STORE_WRITES) {
+    store_newest = store_slot;
+    store_stats.sequence++;
+    store_stats.records++;
+    store_stats.busy = 0;
+    if (!store_dirty)
+      return false;
+    store_start();
+  }
+  uint8_t offset = store_step < STORE_RECORD ? store_step : STORE_COMMIT;
+  *address = store_address(store_slot, offset);
+  *value = store_step == 0 ? 0 : store_record[offset];
+  store_step++;
+  store_stats.bytes++;
+  return true;
+}
+
+
+#if defined(__AVR__)
+
+/*
+ * EEPROM ready: the previous byte is written, start the next one.
+ */
+ISR(EE_READY_vect)
+{
+  uint16_t address;
+  uint8_t value;
+  if (!store_next(&address, &value)) {
+    EECR &= ~_BV(EERIE);
+    return;
+  }
+  EEAR = address;
+  EEDR = value;
+  EECR |= _BV(EEMPE);   // EEPE within 4 cycles, interrupts are off
+  EECR |= _BV(EEPE);
+}
+
+static void store_kick()
+{
+  EECR |= _BV(EERIE);   // fires at once if the EEPROM is ready
+}
+
+void store_poll()
+{
+}
+
+#else
+
+static void store_kick()
+{
+}
+
+void store_poll()
+{
+  uint16_t address;
+  uint8_t value;
+  if (!store_stats.busy || !eeprom_is_ready())
+    return;
+  STORE_LOCK();
+  bool write = store_next(&address, &value);
+  STORE_UNLOCK();
+  if (write)
+    eeprom_write_byte((uint8_t*)(uintptr_t)address, value);
+}
+
+#endif
+
+
+/*
+ * store_begin
+ * newest valid record: commit byte set, CRC right, highest sequence
+ * (modulo 2^16, the records of a journal span less than STORE_SLOTS).
+ */
+void store_begin()
+{
+  uint8_t record[STORE_RECORD];
+  bool found = false;
+  uint16_t sequence = 0;
+  store_stats.valid = 0;
+  store_newest = STORE_SLOTS - 1;
+  store_state.level = 0;
+  for (uint8_t i = 0; i < STORE_LEVELS; i++)
+    store_state.best[i] = STORE_NONE;
+  for (uint8_t slot = 0; slot < STORE_SLOTS; slot++) {
+    for (uint8_t i = 0; i < STORE_RECORD; i++)
+      record[i] = eeprom_read_byte((const uint8_t*)(uintptr_t)store_address(slot, i));
+    if (record[STORE_COMMIT] != STORE_MAGIC ||
+        record[STORE_CHECK] != store_crc(&record[STORE_SEQUENCE], STORE_CHECK - STORE_SEQUENCE))
+      continue;
+    store_stats.valid++;
+    uint16_t s = record[STORE_SEQUENCE] | (uint16_t)record[STORE_SEQUENCE + 1] << 8;
+    if (found && (int16_t)(s - sequence) <= 0)
+      continue;
+    found = true;
+    sequence = s;
+    store_newest = slot;
+    store_state.level = record[STORE_LEVEL] <= STORE_LEVELS ? record[STORE_LEVEL] : 0;
+    for (uint8_t i = 0; i < STORE_LEVELS; i++)
+      store_state.best[i] = record[STORE_BEST + i];
+  }
+  store_stats.sequence = sequence;
+  store_stats.busy = 0;
+  store_dirty = 0;
+}
+
+
+/*
+ * store_save
+ */
+void store_save(uint8_t level, uint8_t score)
+{
+  if (level < 1 || level > STORE_LEVELS)
+    return;
+  STORE_LOCK();
+  uint8_t* best = &store_state.best[level - 1];
+  if (store_state.level != level || *best == STORE_NONE || score > *best) {
+    store_state.level = level;
+    if (*best == STORE_NONE || score > *best)
+      *best = score;
+    if (store_stats.busy) {
+      if (store_dirty)
+        store_stats.coalesced++;
+      store_dirty = 1;   // next record, once this one is written
+    } else {
+      store_start();
+      store_kick();
+    }
+  }
+  STORE_UNLOCK();
+}
+
+
+/*
+ * store_read
+ */
+StoreState store_read()
+{
+  StoreState copy;
+  STORE_LOCK();
+  copy = store_state;
+  STORE_UNLOCK();
+  return copy;
+}
@@ -0,0 +1,62 @@
+/*
+ * store.h
+ * best score of each level and last level played, kept in EEPROM across
+ * resets without ever making the game wait for a write.
+ *
+ * The EEPROM holds a journal of STORE_SLOTS fixed records, each one a full
+ * copy of the state with a sequence number and a CRC-8. A save goes to the
+ * slot after the newest record, so the writes turn around the whole area
+ * (wear levelling) and the newest record is never overwritten. At boot one
+ * pass finds the newest valid record and applies it: the cost does not grow
+ * with the number of saves.
+ *
+ * A record is written one byte at a time, 3.4 ms each: on AVR by the
+ * EEPROM ready interrupt, on other targets (host build) by store_poll(),
+ * one byte per call. The commit byte is cleared first and set last, so a
+ * record cut by a power loss is never taken for a valid one: the previous
+ * record is still there. A save during a write is kept in RAM and written
+ * as the next record (latest value wins).
+ */
+
+#ifndef STORE_H
+#define STORE_H
+
+#include <Arduino.h>
+
+#if !defined(STORE_BASE)
+#define STORE_BASE 0          // first EEPROM byte of the journal
+#endif
+#if !defined(STORE_SLOTS)
+#define STORE_SLOTS 64        // records in the journal (1 KB on the ATmega328P)
+#endif
+#define STORE_RECORD 16       // bytes per record
+#define STORE_LEVELS 9
+#define STORE_MAGIC 0x5A      // commit byte of a complete record
+#define STORE_NONE 0xFF       // no score yet for the level
+
+typedef struct {
+  uint8_t level;                 // last level played (1..STORE_LEVELS), 0 = none
+  uint8_t best[STORE_LEVELS];    // best score in percent, STORE_NONE = never finished
+} StoreState;
+
+typedef struct {
+  uint16_t sequence;    // sequence of the newest record
+  uint8_t valid;        // valid records found at boot
+  uint8_t busy;         // a record is being written
+  uint16_t records;     // records written since boot
+  uint16_t bytes;       // EEPROM bytes written since boot
+  uint16_t coalesced;   // saves merged into a record already waiting
+} StoreStats;
+
+extern volatile StoreStats store_stats;
+
+// read the journal and restore the newest state (defaults on an empty EEPROM)
+void store_begin();
+// level finished with this score: last level, best score; never blocks
+void store_save(uint8_t level, uint8_t score);
+// copy of the state in RAM (what the next boot will find once written)
+StoreState store_read();
+// without EEPROM interrupt, write the next byte if the EEPROM is ready
+void store_poll();
+
+#endif // STORE_H
@@ -0,0 +1,116 @@
+/*
+ * telemetry.cpp
+ * ring drain and tick overrun check of telemetry.h.
+ */
+
+#include "telemetry.h"
+
+#if TELEMETRY
+
+volatile TelemStats telem_stats;
+TelemRecord telem_ring[TELEM_RING];
+volatile uint8_t telem_head = 0;
+volatile uint8_t telem_tail = 0;
+volatile uint8_t telem_pending = 0;
+static const volatile uint16_t telem_noClock = 0;
+const volatile uint16_t* telem_clock = &telem_noClock;
+
+static uint16_t telem_period = 0xFFFF;   // Timer1 period, in us
+
+
+void telem_begin(const volatile uint16_t* clock, unsigned long periodMicros)
+{
+  telem_clock = clock;
+  telem_period = periodMicros;
+  Serial.begin(TELEM_BAUD);
+}
+
+
+/*
+ * telem_crc
+ * CRC-8 (polynomial 0x07) of a record, last byte of its frame.
+ */
+static uint8_t telem_crc(const uint8_t* data, uint8_t length)
+{
+  uint8_t crc = 0;
+  while (length--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+
+static void telem_send(const TelemRecord* record)
+{
+  uint8_t frame[TELEM_FRAME];
+  frame[0] = TELEM_SYNC;
+  memcpy(&frame[1], record, sizeof(TelemRecord));   // little endian, like tools/telemdecode
+  frame[TELEM_FRAME - 1] = telem_crc(&frame[1], sizeof(TelemRecord));
+  Serial.write(frame, TELEM_FRAME);
+  telem_stats.sent++;
+}
+
+
+/*
+ * telem_poll
+ * records are complete once visible: the writers of loop() are not
+ * running, those of the interrupts have returned. Interrupts are only
+ * masked to take the count of dropped records.
+ */
+void telem_poll()
+{
+  while (Serial.availableForWrite() >= TELEM_FRAME) {
+    uint8_t tail = telem_tail;
+    if (tail != telem_head) {
+      telem_send(&telem_ring[tail & (TELEM_RING - 1)]);
+      telem_tail = tail + 1;   // the slot can be written again
+      continue;
+    }
+    // ring empty: the dropped records came after everything sent so far
+    if (!telem_pending)
+      return;
+    noInterrupts();
+    uint8_t count = telem_pending;
+    telem_pending = 0;
+    interrupts();
+    TelemRecord lost = { TELEM_LOST, 0, *telem_clock, count, 0 };
+    telem_stats.lost += count;
+    telem_send(&lost);
+  }
+}
+
+
+/*
+ * telem_tickStart / telem_tickEnd
+ * on AVR the Timer1 overflow flag, cleared when the interrupt started,
+ * is set again if the next period began before the end of the tick.
+ */
+uint16_t telem_tickStart()
+{
+#if defined(__AVR__)
+  return 0;
+#else
+  return (uint16_t)micros();
+#endif
+}
+
+void telem_tickEnd(uint16_t start)
+{
+#if defined(__AVR__)
+  (void)start;
+  if (TIFR1 & _BV(TOV1)) {
+    telem_stats.overruns++;
+    telem_log(TELEM_OVERRUN, 0, 0, 0);
+  }
+#else
+  uint16_t duration = (uint16_t)micros() - start;
+  if (duration > telem_period) {
+    telem_stats.overruns++;
+    telem_log(TELEM_OVERRUN, 0, duration, 0);
+  }
+#endif
+}
+
+#endif // TELEMETRY
@@ -0,0 +1,132 @@
+/*
+ * telemetry.h
+ * binary event log of the game (spawns, moves, hits, score, state changes,
+ * tick overruns) that costs a few cycles per event, even in the Timer1
+ * interrupt, instead of text printed on Serial at 9600 baud.
+ *
+ * telem_log() copies a fixed 8-byte record stamped with the Timer1 tick
+ * count into a ring of TELEM_RING records. Writers only reserve a slot
+ * (interrupts masked for the index bump, already masked in an interrupt)
+ * and never wait: a full ring drops the record and counts it. The reader,
+ * telem_poll() in loop(), never holds the writers back: it sends each
+ * record as a frame (TELEM_SYNC, record, CRC-8) while the Serial transmit
+ * buffer has room, then a TELEM_LOST record after a loss. tools/telemdecode reads the
+ * stream back, resynchronising on the sync byte and the CRC.
+ *
+ * With TELEMETRY 0 the macros expand to nothing and nothing is linked in.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+#if !defined(TELEMETRY)
+#define TELEMETRY 0   // 1 = binary event stream on Serial at TELEM_BAUD (tools/telemdecode)
+#endif
+#if !defined(TELEM_BAUD)
+#define TELEM_BAUD 1000000UL   // exact at 16 MHz (U2X)
+#endif
+#if !defined(TELEM_RING)
+#define TELEM_RING 16          // records, power of 2
+#endif
+#define TELEM_SYNC 0xA5
+#define TELEM_FRAME 10         // sync + record + CRC-8
+
+// record types (names in tools/telemdecode.cpp, same order)
+enum {
+  TELEM_SPAWN = 1,   // a = block, b = y | length << 8, c = x (int16)
+  TELEM_MOVE,        // a = live blocks, b = moves since the level start
+  TELEM_HIT,         // a = pixels, b = cursor row
+  TELEM_SCORE,       // a = percent, b = current, c = maximum
+  TELEM_JUDGE,       // a = ENGINE_JUDGE_*, b = block
+  TELEM_DROP,        // a = ENGINE_DROP_*
+  TELEM_STATE,       // a = new state, b = previous state, c = level
+  TELEM_OVERRUN,     // Timer1 tick longer than its period: b = duration (us, host build only)
+  TELEM_LOST,        // b = records dropped, ring full
+  TELEM_MENU,        // a = level selected, b = pot value, c = 1 validation started, 0 level changed
+  TELEM_TYPES
+};
+
+typedef struct {
+  uint8_t type;
+  uint8_t a;
+  uint16_t tick;   // Timer1 tick count (periodicCounter)
+  uint16_t b;
+  uint16_t c;
+} TelemRecord;
+
+static_assert(sizeof(TelemRecord) == 8, "fixed 8-byte records");
+static_assert((TELEM_RING & (TELEM_RING - 1)) == 0, "TELEM_RING is a power of 2");
+
+#if TELEMETRY
+
+typedef struct {
+  uint16_t sent;     // frames sent
+  uint16_t lost;     // records dropped (ring full) and reported
+  uint16_t overruns; // TELEM_OVERRUN records
+} TelemStats;
+
+extern volatile TelemStats telem_stats;
+extern TelemRecord telem_ring[TELEM_RING];
+extern volatile uint8_t telem_head;   // next slot to write
+extern volatile uint8_t telem_tail;   // next slot to send
+extern volatile uint8_t telem_pending;   // records dropped, not reported yet
+extern const volatile uint16_t* telem_clock;
+
+// Serial at TELEM_BAUD, records stamped with *clock, overruns beyond periodMicros
+void telem_begin(const volatile uint16_t* clock, unsigned long periodMicros);
+// send the waiting records while Serial has room; call it from loop()
+void telem_poll();
+// start / end of the Timer1 tick: TELEM_OVERRUN if it took longer than the period
+uint16_t telem_tickStart();
+void telem_tickEnd(uint16_t start);
+
+// one record, from an interrupt or from loop()
+static inline void telem_log(uint8_t type, uint8_t a, uint16_t b, uint16_t c)
+{
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+#else
+  noInterrupts();
+#endif
+  uint8_t slot = telem_head;
+  bool full = (uint8_t)(slot - telem_tail) >= TELEM_RING;
+  if (full) {
+    if (telem_pending < 0xFF)
+      telem_pending++;
+  } else
+    telem_head = slot + 1;
+#if defined(__AVR__)
+  SREG = sreg;
+#else
+  interrupts();
+#endif
+  if (full)
+    return;
+  TelemRecord* r = &telem_ring[slot & (TELEM_RING - 1)];
+  r->type = type;
+  r->a = a;
+  r->tick = *telem_clock;
+  r->b = b;
+  r->c = c;
+}
+
+struct TelemTickScope {
+  uint16_t start;
+  TelemTickScope() : start(telem_tickStart()) {}
+  ~TelemTickScope() { telem_tickEnd(start); }
+};
+
+#define TELEM_LOG(type, a, b, c) telem_log(type, a, b, c)
+#define TELEM_TICK_SCOPE() TelemTickScope telem_tick_scope
+
+#else
+
+#define TELEM_LOG(type, a, b, c)
+#define TELEM_TICK_SCOPE()
+
+#endif // TELEMETRY
+
+#endif // TELEMETRY_H
@@ -0,0 +1,102 @@
+/*
+ * Arduino.h (hôte)
+ * Couche d'abstraction matérielle pour compiler TROMBOSS.ino et lib_magic.cpp
+ * sous Linux. Les broches, l'ADC, le temps et les interruptions Timer1 sont
+ * simulés par hal.cpp ; les écritures sur les broches du bus HT1632 sont
+ * transmises à l'émulateur de bus (bus_emulator.cpp).
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+// ===== PROGMEM =====
+// Sur l'hôte, la mémoire flash est la mémoire ordinaire
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+// pgm_read_word sert aussi à lire des pointeurs (16 bits sur AVR) : on garde le type pointé
+template <class T> inline T hal_pgm_read_word(const T* p) { return *p; }
+#define pgm_read_word(p) hal_pgm_read_word(p)
+#define pgm_read_ptr(p) hal_pgm_read_word(p)
+#define memcpy_P memcpy
+
+// ===== INTERRUPTIONS =====
+void hal_noInterrupts();
+void hal_interrupts();
+#define noInterrupts() hal_noInterrupts()
+#define interrupts() hal_interrupts()
+#define cli() hal_noInterrupts()
+#define sei() hal_interrupts()
+
+// ===== ENTRÉES / SORTIES =====
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+// ===== TEMPS =====
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ===== SON =====
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// ===== SERIAL =====
+// Les sorties ne sont affichées que si hal_serialEcho est vrai ;
+// les entrées viennent de hal_serialInject()
+class HardwareSerial
+{
+public:
+  void begin(unsigned long baud);
+  int available();
+  int read();
+  int availableForWrite();
+  size_t write(uint8_t c);
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(long n, int base = DEC);
+  size_t print(unsigned long n, int base = DEC);
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(double n, int digits = 2);
+  template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <class T> size_t println(T value, int base) { size_t n = print(value, base); return n + println(); }
+  size_t println();
+};
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,25 @@
+/*
+ * TimerOne.h (hôte)
+ * Timer1 simulé : la fonction attachée est appelée par hal.cpp chaque fois
+ * que le temps simulé franchit une période, comme une interruption.
+ */
+
+#ifndef HOST_TIMERONE_H
+#define HOST_TIMERONE_H
+
+class TimerOne
+{
+public:
+  void initialize(long microseconds = 1000000);
+  void setPeriod(long microseconds);
+  void attachInterrupt(void (*isr)());
+  void attachInterrupt(void (*isr)(), long microseconds);
+  void detachInterrupt();
+  void start();
+  void stop();
+  void restart();
+  void resume();
+};
+extern TimerOne Timer1;
+
+#endif // HOST_TIMERONE_H
@@ -0,0 +1,28 @@
+/*
+ * Wire.h (hôte)
+ * Bus I2C simulé : chaque transaction est transmise à l'émulateur de bus
+ * et consomme le temps d'un transfert réel à la fréquence configurée.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+  void begin();
+  void setClock(unsigned long frequency);
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  uint8_t endTransmission(bool sendStop = true);
+
+private:
+  uint8_t address_;
+  uint8_t buffer_[32];
+  uint8_t length_;
+};
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
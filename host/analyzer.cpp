@@ -0,0 +1,340 @@
+/*
+ * analyzer.cpp
+ * Analyse des niveaux sur l'hôte : pour chaque niveau (et chaque variante de tempo), le moteur
+ * du jeu (TROMBOSS/engine.cpp) crée les blocs de la chanson sans joueur, puis une programmation
+ * dynamique sur les entrées du joueur donne le meilleur score atteignable. Les blocs ne
+ * dépendent pas du joueur (ni le curseur ni le bouton ne changent les apparitions), seules
+ * les entrées comptent, avec la règle de periodicFunction() : bouton tenu, le curseur ne suit
+ * plus le potentiomètre. Le résultat répond à « les 80 % de handleLevelState() sont-ils
+ * atteignables ? » pour un joueur dont chaque appui dure au moins un tick.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -pthread -Ihost -o tromboss_analyzer host/analyzer.cpp TROMBOSS/engine.cpp
+ * Utilisation :
+ *   ./tromboss_analyzer [niveaux...] [--tempo P,P...] [--column P,P...] [--threads N]
+ *   --tempo P,P...   : variantes du tempo de chaque niveau, en % (100 par défaut)
+ *   --column P,P...  : variantes de la durée d'une colonne, en % (100 par défaut)
+ *   --threads N      : fils de calcul (tous les cœurs par défaut)
+ * Une tâche par niveau et par variante, réparties sur un groupe de fils. Pour chacune : notes
+ * lues, blocs créés, notes perdues par raison (ENGINE_DROP_*), densité des blocs par seconde,
+ * remplissage des voies, score optimal ; les entrées du meilleur chemin sont ensuite rejouées
+ * par le moteur, qui doit redonner ce score (code de sortie 1 sinon).
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../TROMBOSS/engine.h"
+
+#define ANALYZER_MAX_TICKS (600000000UL / TIMER_PERIOD)   // 10 minutes simulées au plus par niveau
+#define ANALYZER_WIN_PERCENT 80                            // comme handleLevelState()
+#define ANALYZER_CURSOR_ROWS (MATRIX_HEIGHT - CURSOR_HEIGHT + 1)  // lignes 0..14 (pot.h)
+#define ANALYZER_DROP_REASONS (ENGINE_DROP_POOL + 1)
+
+static const char* dropNames[ANALYZER_DROP_REASONS] = { "trop proches", "réserve" };
+
+// ===== TÂCHES =====
+
+struct Job {
+  uint8_t level;
+  uint16_t tempoPercent;
+  uint16_t columnPercent;
+
+  // résultats
+  uint16_t bpm;
+  uint16_t column;              // unités de la ligne de temps
+  uint32_t ticks;
+  bool finished;
+  uint32_t notes;               // notes lues (blocs + pertes)
+  uint32_t blocks;
+  uint32_t drops[ANALYZER_DROP_REASONS];
+  uint32_t lanes[NOTE_LANES];   // blocs par voie
+  uint16_t peakPerSecond;       // blocs créés dans la seconde la plus chargée
+  uint8_t peakLive;             // blocs vivants au plus
+  uint16_t best;                // pixels touchés par le meilleur chemin
+  uint16_t maxPossible;
+  uint8_t percent;              // comme Score.transformed
+  uint32_t states;              // états de la programmation dynamique, au plus par tick
+  bool verified;                // le rejeu du chemin optimal redonne best
+};
+
+struct Stats {
+  Job* job;
+  std::vector<uint16_t> perSecond;
+  uint32_t now;
+};
+
+static void analyzerEvent(Engine* e, uint8_t event, uint8_t block, uint8_t value) {
+  Stats* stats = (Stats*)e->user;
+  Job* job = stats->job;
+  if (event == ENGINE_EVENT_SPAWN) {
+    job->notes++;
+    job->blocks++;
+    job->lanes[e->blockY[block] / BLOCK_HEIGHT % NOTE_LANES]++;
+    uint32_t second = stats->now / 1000000UL;
+    if (second >= stats->perSecond.size()) stats->perSecond.resize(second + 1);
+    stats->perSecond[second]++;
+  } else if (event == ENGINE_EVENT_DROP) {
+    job->notes++;
+    if (value < ANALYZER_DROP_REASONS) job->drops[value]++;
+  }
+}
+
+// Début du niveau de la tâche, tempo et colonne de la variante
+static void startLevel(Engine* e, Job* job, uint8_t cursor) {
+  e->cursorY = cursor;
+  engine_begin(e, job->level);
+  if (job->tempoPercent != 100 || job->columnPercent != 100) {
+    uint32_t bpm = (uint32_t)e->tempo.bpm * job->tempoPercent / 100;
+    uint32_t column = (uint32_t)e->tempo.column * job->columnPercent / 100;
+    engine_setTempo(e, bpm > TEMPO_MAX_BPM ? TEMPO_MAX_BPM : bpm, column > 0xFFFF ? 0xFFFF : column);
+  }
+  job->bpm = e->tempo.bpm;
+  job->column = e->tempo.column;
+}
+
+// ===== COLONNES VERTES =====
+// Les pixels de blocs sur x=2 et x=3, ligne y en bits 2y (x=2) et 2y+1 (x=3). Le curseur en
+// ligne c couvre les bits 2c..2c+3 ; un déplacement fait passer x=3 en x=2 et sortir x=2.
+// Après `shift` déplacements sans apparition, ce sont les colonnes 2+shift et 3+shift de maintenant.
+
+static uint32_t greenPixels(const Engine* e, uint8_t shift) {
+  uint32_t green = 0;
+  for (uint8_t y = 0; y < MATRIX_HEIGHT; y++)
+    green |= ((e->boardBlocks[y] >> (CURSOR_COLUMN_START + shift)) & 3) << (2 * y);
+  return green;
+}
+
+static inline uint32_t cursorCover(uint8_t c) {
+  return 0xFUL << (2 * c);
+}
+
+static inline uint32_t greenShift(uint32_t mask) {
+  return (mask >> 1) & 0x55555555UL;
+}
+
+// ===== PROGRAMMATION DYNAMIQUE =====
+// État avant un tick : ligne du curseur, ligne visée et pixels verts déjà touchés (boardHits).
+// Deux transitions par tick, comme les entrées de periodicFunction() :
+// - tenir : bouton enfoncé, le curseur gagne les pixels verts qu'il couvre et pas encore
+//   touchés ; la ligne visée ne change pas (potentiomètre ignoré bouton tenu)
+// - viser : bouton relâché, aucun pixel gagné ; la ligne visée devient n'importe quelle ligne
+// Puis le curseur avance d'une ligne au plus vers la ligne visée et les blocs se déplacent.
+// Plusieurs déplacements dans un tick (colonne plus courte qu'un tick) : les colonnes vertes
+// entre deux d'entre eux comptent aussi, sous le curseur d'avant le tick (comme engine_tick()).
+// Un appui plus court qu'un tick (appuyé et relâché entre deux ticks, touche et nouvelle
+// visée dans le même tick) n'est pas modélisé.
+
+struct Node {
+  uint32_t hits;
+  uint16_t score;
+  uint8_t cursor;
+  uint8_t target;
+  bool held;        // transition qui mène ici : tenir (true) ou viser
+  int32_t parent;   // nœud du tick précédent
+};
+
+static inline uint8_t cursorStep(uint8_t cursor, uint8_t target) {
+  return cursor < target ? cursor + 1 : cursor > target ? cursor - 1 : cursor;
+}
+
+static void analyzeLevel(Job* job) {
+  Stats stats;
+  stats.job = job;
+  stats.now = 0;
+  Engine engine;
+  memset(&engine, 0, sizeof(engine));
+  engine.onEvent = analyzerEvent;
+  engine.user = &stats;
+
+  // Blocs sans joueur : pixels verts avant chaque tick et entre ses déplacements (à partir de
+  // greenStart[t]), déplacements pendant le tick
+  std::vector<uint32_t> green;
+  std::vector<uint32_t> greenStart;
+  std::vector<uint8_t> moves;
+  startLevel(&engine, job, 0);
+  while (!engine_finished(&engine) && moves.size() < ANALYZER_MAX_TICKS) {
+    stats.now += TIMER_PERIOD;
+    Engine before = engine;
+    uint32_t nextMove = engine.tempo.nextMove;
+    engine_tick(&engine, stats.now, 0, false);
+    uint32_t moved = (engine.tempo.nextMove - nextMove) / engine.tempo.column;
+    moves.push_back(moved);
+    greenStart.push_back(green.size());
+    for (uint32_t shift = 0; shift < (moved ? moved : 1); shift++) green.push_back(greenPixels(&before, shift));
+    if (engine.blockLiveCount > job->peakLive) job->peakLive = engine.blockLiveCount;
+  }
+  job->ticks = moves.size();
+  job->finished = engine_finished(&engine);
+  job->maxPossible = engine.score.maxPossible;
+  for (size_t s = 0; s < stats.perSecond.size(); s++)
+    if (stats.perSecond[s] > job->peakPerSecond) job->peakPerSecond = stats.perSecond[s];
+
+  // Tous les états atteignables, tick par tick (un état par couple curseur + pixels touchés)
+  std::vector<std::vector<Node> > layers(job->ticks + 1);
+  for (uint8_t c = 0; c < ANALYZER_CURSOR_ROWS; c++) layers[0].push_back(Node{ 0, 0, c, c, false, -1 });
+  std::unordered_map<uint64_t, uint32_t> index;
+  for (uint32_t t = 0; t < job->ticks; t++) {
+    const std::vector<Node>& from = layers[t];
+    std::vector<Node>& to = layers[t + 1];
+    index.clear();
+    auto reach = [&](uint32_t hits, uint16_t score, uint8_t cursor, uint8_t target, bool held, uint32_t parent) {
+      uint64_t key = ((uint64_t)cursor << 40) | ((uint64_t)target << 32) | hits;
+      auto found = index.find(key);
+      if (found == index.end()) {
+        index[key] = to.size();
+        to.push_back(Node{ hits, score, cursor, target, held, (int32_t)parent });
+      } else if (to[found->second].score < score) {
+        to[found->second].score = score;
+        to[found->second].held = held;
+        to[found->second].parent = parent;
+      }
+    };
+    for (uint32_t n = 0; n < from.size(); n++) {
+      const Node& node = from[n];
+      // tenir : pixels sous le curseur pendant le tick, ligne visée inchangée
+      uint16_t score = node.score;
+      uint32_t hits = node.hits, released = node.hits;
+      for (uint32_t step = 0; step < (moves[t] ? moves[t] : 1); step++) {
+        uint32_t covered = green[greenStart[t] + step] & cursorCover(node.cursor);
+        score += __builtin_popcountl(covered & ~hits);
+        hits |= covered;
+        if (step < moves[t]) {
+          hits = greenShift(hits);
+          released = greenShift(released);
+        }
+      }
+      reach(hits, score, cursorStep(node.cursor, node.target), node.target, true, n);
+      // viser : aucune touche, n'importe quelle ligne visée
+      for (uint8_t target = 0; target < ANALYZER_CURSOR_ROWS; target++)
+        reach(released, node.score, cursorStep(node.cursor, target), target, false, n);
+    }
+    if (to.size() > job->states) job->states = to.size();
+  }
+
+  const std::vector<Node>& last = layers[job->ticks];
+  uint32_t bestNode = 0;
+  for (uint32_t n = 1; n < last.size(); n++)
+    if (last[n].score > last[bestNode].score) bestNode = n;
+  job->best = last[bestNode].score;
+  job->percent = job->maxPossible ? (uint32_t)job->best * 100 / job->maxPossible : 0;
+
+  // Entrées du meilleur chemin rejouées par le moteur : au tick t, la ligne visée et le bouton
+  // de la transition vers le nœud du tick t + 1
+  std::vector<Node> path(job->ticks + 1);
+  int32_t n = bestNode;
+  for (int32_t t = job->ticks; t >= 0; t--) {
+    path[t] = layers[t][n];
+    n = layers[t][n].parent;
+  }
+  layers.clear();
+  engine.onEvent = NULL;
+  startLevel(&engine, job, path[0].cursor);
+  uint32_t now = 0;
+  for (uint32_t t = 0; t < job->ticks; t++) {
+    now += TIMER_PERIOD;
+    engine_tick(&engine, now, path[t + 1].target, path[t + 1].held);
+  }
+  job->verified = engine.score.current == job->best && engine_finished(&engine) == job->finished;
+}
+
+// ===== GROUPE DE FILS =====
+// Chaque fil prend la tâche suivante jusqu'à épuisement : un niveau lent n'en bloque pas d'autres.
+
+static void runJobs(std::vector<Job>& jobs, unsigned threads) {
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t j = next++; j < jobs.size(); j = next++) analyzeLevel(&jobs[j]);
+  };
+  std::vector<std::thread> pool;
+  for (unsigned i = 1; i < threads; i++) pool.push_back(std::thread(worker));
+  worker();
+  for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+}
+
+// Liste de pourcentages "80,100,120"
+static void parsePercents(const char* text, std::vector<uint16_t>& percents) {
+  percents.clear();
+  while (*text) {
+    int percent = atoi(text);
+    if (percent > 0) percents.push_back(percent);
+    const char* comma = strchr(text, ',');
+    if (!comma) break;
+    text = comma + 1;
+  }
+  if (percents.empty()) percents.push_back(100);
+}
+
+int main(int argc, char** argv) {
+  std::vector<uint8_t> levels;
+  std::vector<uint16_t> tempos(1, 100), columns(1, 100);
+  unsigned threads = std::thread::hardware_concurrency();
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--tempo") && i + 1 < argc) parsePercents(argv[++i], tempos);
+    else if (!strcmp(argv[i], "--column") && i + 1 < argc) parsePercents(argv[++i], columns);
+    else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+    else {
+      int level = atoi(argv[i]);
+      if (level >= MIN_DIFFICULTY_LEVEL && level <= MAX_DIFFICULTY_LEVEL) levels.push_back(level);
+    }
+  }
+  if (levels.empty()) {
+    for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) levels.push_back(level);
+  }
+  if (!threads) threads = 1;
+
+  std::vector<Job> jobs;
+  for (size_t l = 0; l < levels.size(); l++)
+    for (size_t t = 0; t < tempos.size(); t++)
+      for (size_t c = 0; c < columns.size(); c++) {
+        Job job;
+        memset(&job, 0, sizeof(job));
+        job.level = levels[l];
+        job.tempoPercent = tempos[t];
+        job.columnPercent = columns[c];
+        jobs.push_back(job);
+      }
+  if (threads > jobs.size()) threads = jobs.size();
+
+  auto start = std::chrono::steady_clock::now();
+  runJobs(jobs, threads);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint32_t failures = 0;
+  for (size_t j = 0; j < jobs.size(); j++) {
+    const Job& job = jobs[j];
+    double duration = job.ticks * (TIMER_PERIOD / 1e6);
+    printf("niveau %u (%u bpm, colonne %.2f) : %.1f s, %u notes, %u blocs", job.level, job.bpm,
+           job.column / (double)TEMPO_ONE, duration, job.notes, job.blocks);
+    if (job.notes > job.blocks) {
+      printf(", %u perdues (", job.notes - job.blocks);
+      bool first = true;
+      for (uint8_t r = 0; r < ANALYZER_DROP_REASONS; r++) {
+        if (!job.drops[r]) continue;
+        printf("%s%s %u", first ? "" : ", ", dropNames[r], job.drops[r]);
+        first = false;
+      }
+      printf(")");
+    }
+    printf("%s\n", job.finished ? "" : " (non terminé)");
+    uint8_t busiest = 0;
+    for (uint8_t lane = 1; lane < NOTE_LANES; lane++)
+      if (job.lanes[lane] > job.lanes[busiest]) busiest = lane;
+    printf("  densité %.2f blocs/s (pointe %u en une seconde, %u vivants au plus), voie la plus chargée "
+           "y=%u : %.0f %% des blocs\n", duration > 0 ? job.blocks / duration : 0, job.peakPerSecond,
+           job.peakLive, busiest * BLOCK_HEIGHT, job.blocks ? job.lanes[busiest] * 100.0 / job.blocks : 0);
+    printf("  score optimal %u/%u pixels = %u %% (%u %% %s), %u états au plus, rejeu %s\n", job.best,
+           job.maxPossible, job.percent, ANALYZER_WIN_PERCENT,
+           job.percent >= ANALYZER_WIN_PERCENT ? "atteignable" : "HORS D'ATTEINTE", job.states,
+           job.verified ? "identique" : "DIFFÉRENT");
+    if (!job.verified) failures++;
+  }
+  printf("%u analyses sur %u fils en %.2f s\n", (unsigned)jobs.size(), threads, seconds);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,11 @@
+// avr/eeprom.h (hôte) : EEPROM simulée par hal.cpp (voir hal.h), mêmes noms qu'avr-libc
+#ifndef HOST_AVR_EEPROM_H
+#define HOST_AVR_EEPROM_H
+#include <Arduino.h>
+
+uint8_t eeprom_read_byte(const uint8_t* address);
+// Lance l'écriture d'un octet (3,4 ms) ; attend d'abord la fin de la précédente, comme avr-libc
+void eeprom_write_byte(uint8_t* address, uint8_t value);
+bool eeprom_is_ready();
+
+#endif
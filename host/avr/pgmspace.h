@@ -0,0 +1,2 @@
+// avr/pgmspace.h (hôte) : tout est déjà défini dans Arduino.h
+#include <Arduino.h>
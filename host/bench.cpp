@@ -0,0 +1,915 @@
+/*
+ * bench.cpp
+ * Banc d'essai hôte : exécute le vrai TROMBOSS.ino sur le matériel simulé,
+ * rejoue des parties scriptées (sélection du niveau au potentiomètre,
+ * validation au bouton, pilote automatique pendant le niveau) et mesure le
+ * trafic des bus par interruption Timer1 pour chaque état du jeu.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -Wall -Wextra -Ihost -o tromboss_host \
+ *       host/bench.cpp host/hal.cpp host/bus_emulator.cpp TROMBOSS/[a-z]*.cpp
+ * Utilisation :
+ *   ./tromboss_host [niveaux...] [--digitalwrite] [--serial] [--screen] [--idle] [--wav FICHIER]
+ *                   [--potnoise N] [--pot] [--tempo [SECONDES]] [--song] [--eeprom]
+ *                   [--serialout FICHIER] [--panel]
+ *   --digitalwrite : compter ~3.4 µs par écriture de broche au lieu de sbi/cbi
+ *   --serial       : afficher les sorties Serial du jeu
+ *   --screen       : afficher l'écran émulé à la fin de chaque niveau
+ *   --idle         : ne pas jouer (niveaux perdus, écran LOSER)
+ *   --wav FICHIER  : enregistrer la synthèse DDS des niveaux joués (WAV 8 bits mono)
+ *   --potnoise N   : bruit uniforme de ±N LSB sur les conversions du potentiomètre
+ *   --pot          : mesurer bruit et latence du potentiomètre (filtre de pot.cpp contre
+ *                    l'ancienne lecture analogRead() tous les 4 ticks), sans jouer
+ *   --tempo [S]    : dérive de l'horloge musicale de chaque niveau sur S secondes
+ *                    simulées (3600 par défaut), sans jouer ; code de sortie 1 si une
+ *                    échéance passe d'un tick ou plus (tests/tempo_test vérifie aussi la dérive)
+ *   --song         : vérifier que song_data.h (tools/songpack) redonne les notes de
+ *                    song_patterns.h, sans jouer ; code de sortie 1 sinon
+ *   --serialout F  : enregistrer les octets émis sur Serial (flux de -DTELEMETRY=1, à lire
+ *                    avec tools/telemdecode)
+ *   --eeprom       : journal des scores (store.h) : usure, sauvegardes fusionnées et coupure
+ *                    d'alimentation à chaque écriture d'octet, sans jouer ; code de sortie 1
+ *                    si un redémarrage ne retrouve pas le bon état
+ *   --panel        : durée d'une image HT1632 sur l'écran compilé (-DHT1632_BOARDS_X=2,
+ *                    -DHT1632_BOARDS_Y=2...), sans jouer ; code de sortie 1 si la RAM des
+ *                    puces diffère de la shadowram
+ * Chaque niveau joué est rejoué par le moteur seul (engine.h) à partir de ses entrées
+ * enregistrées ; code de sortie 1 si le score ou le jugement diffère, ou si le bus
+ * émulé a vu une erreur ou une RAM de puce différente de la shadowram.
+ * Compilé avec -DPROFILING=1, le banc affiche à la fin les compteurs de
+ * profile.h (durées en ticks de 4 µs, temps simulé). Compilé avec -DTELEMETRY=1, le jeu
+ * émet ses événements en trames binaires sur Serial (telemetry.h), au débit simulé.
+ */
+
+#include <Arduino.h>
+#include "../TROMBOSS/TROMBOSS.ino"
+#include "../TROMBOSS/song_data.h"
+#include <stdio.h>
+#include <math.h>
+#include "hal.h"
+#include "bus_emulator.h"
+
+// ===== STATISTIQUES PAR ÉTAT =====
+struct StateStats {
+  uint64_t ticks;
+  uint64_t loops;
+  uint64_t clocks;
+  uint64_t commands;
+  uint64_t ht1632Ns;
+  uint64_t i2cTransactions;
+  uint64_t i2cNs;
+  uint64_t isrNs;
+  uint64_t adcNs;
+};
+
+static StateStats stateStats[4];
+// Images du compositeur pendant les niveaux
+static uint64_t composedFrames = 0;
+static uint64_t composedPixels = 0;
+static uint64_t composedClocks = 0;
+static uint8_t composedPixelsMax = 0;
+static uint64_t shadowMismatches = 0;
+// Latence du bouton : de l'appui (broche basse) à sa prise en compte par le jeu (curseur clignotant)
+static uint64_t pressStartNs = 0;
+static bool pressWaiting = false;
+static uint64_t pressLatencySum = 0;
+static uint64_t pressLatencyMax = 0;
+static uint32_t pressCount = 0;
+static uint64_t pressStampErrorMax = 0;  // écart entre l'appui et sa date micros() dans la file
+static bool showScreen = false;
+static bool idlePlayer = false;
+static unsigned replayMismatches = 0;  // niveaux dont le rejeu par le moteur seul diffère
+
+#if MUSIQUE && AUDIO_DDS
+// ===== SYNTHÈSE AUDIO =====
+// Les échantillons sont calculés par audio_nextSample(), le corps de l'interruption
+// Timer2, au rythme de AUDIO_SAMPLE_RATE en temps simulé.
+// Coût estimé sur ATmega328P (décompte des instructions) : deux interruptions par
+// échantillon, ~70 cycles chacune (entrée, sauvegarde des registres, sortie),
+// ~20 cycles de mixage et ~30 cycles par voix ouverte. Sans voix l'interruption est coupée.
+#define AUDIO_CYCLES_BASE 160
+#define AUDIO_CYCLES_PER_VOICE 30
+
+static FILE* wavFile = NULL;
+static uint32_t wavBytes = 0;
+static uint64_t audioSamples = 0;                     // échantillons échus depuis le démarrage
+static uint64_t audioVoiceSamples[AUDIO_VOICES + 1];  // échantillons des niveaux par nombre de voix
+
+static void wavHeader(FILE* f, uint32_t bytes) {
+  uint32_t rate = (uint32_t)(AUDIO_SAMPLE_RATE + 0.5);
+  uint8_t h[44] = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
+                    16, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 8, 0,
+                    'd', 'a', 't', 'a', 0, 0, 0, 0 };
+  uint32_t fields[4][2] = { { 4, bytes + 36 }, { 24, rate }, { 28, rate }, { 40, bytes } };
+  for (uint8_t i = 0; i < 4; i++)
+    for (uint8_t b = 0; b < 4; b++) h[fields[i][0] + b] = (uint8_t)(fields[i][1] >> (8 * b));
+  fseek(f, 0, SEEK_SET);
+  fwrite(h, 1, sizeof(h), f);
+  fseek(f, 0, SEEK_END);
+}
+
+// Échantillons échus jusqu'à l'instant simulé ; enregistrés pendant les niveaux
+static void renderAudio(bool level) {
+  uint64_t due = (uint64_t)(hal_nowNs * (AUDIO_SAMPLE_RATE / 1e9));
+  while (audioSamples < due) {
+    if (level) audioVoiceSamples[audio_activeVoices]++;
+    uint8_t sample = audio_nextSample();
+    if (level && wavFile) {
+      fputc(sample, wavFile);
+      wavBytes++;
+    }
+    audioSamples++;
+  }
+}
+
+// ===== POLYPHONIE =====
+// Accords de 1 à AUDIO_VOICES voix ouvertes ensemble : échantillon par échantillon, le mélange
+// doit valoir la somme des mêmes notes jouées seules, divisée par la plus petite puissance de 2
+// qui garde n voix à pleine échelle dans 0..255. Une note de plus que AUDIO_VOICES est ignorée ;
+// audio_noteOff() d'une voix laisse les autres continuer sans saut de phase.
+// Le coût par échantillon est celui du décompte des instructions (AUDIO_CYCLES_*), comparé à la
+// période d'échantillonnage (deux débordements du Timer2, 1020 cycles).
+#define AUDIO_STUDY_SAMPLES 4096
+
+static bool audioStudy() {
+  static const uint8_t chord[AUDIO_VOICES + 1] = { N_C5, N_E5, N_G5, N_C6, N_E6 };
+  static int16_t alone[AUDIO_VOICES][2 * AUDIO_STUDY_SAMPLES];
+  for (uint8_t v = 0; v < AUDIO_VOICES; v++) {
+    audio_allOff();
+    audio_noteOn(v, chord[v]);
+    for (uint16_t t = 0; t < 2 * AUDIO_STUDY_SAMPLES; t++) alone[v][t] = audio_nextSample() - AUDIO_SILENCE;
+  }
+  const double period = F_CPU / AUDIO_SAMPLE_RATE;
+  bool ok = true;
+  printf("polyphonie DDS : %u échantillons par accord, période %.0f cycles\n", AUDIO_STUDY_SAMPLES, period);
+  for (uint8_t n = 1; n <= AUDIO_VOICES; n++) {
+    audio_allOff();
+    for (uint8_t v = 0; v < n; v++) audio_noteOn(v, chord[v]);
+    // n = AUDIO_VOICES : une note de trop, puis la première voix fermée au milieu
+    uint8_t first = 0, voices = n, extra = AUDIO_VOICES;
+    uint16_t errors = 0;
+    int16_t low = 255, high = 0;
+    for (uint16_t t = 0; t < 2 * AUDIO_STUDY_SAMPLES; t++) {
+      if (n == AUDIO_VOICES && t == AUDIO_STUDY_SAMPLES) {
+        audio_noteOn(AUDIO_VOICES, chord[AUDIO_VOICES]);
+        extra = audio_activeVoices;
+        audio_noteOff(0);
+        first = 1;
+        voices = n - 1;
+      } else if (n < AUDIO_VOICES && t == AUDIO_STUDY_SAMPLES) {
+        break;
+      }
+      int16_t sum = 0;
+      for (uint8_t v = first; v < n; v++) sum += alone[v][t];
+      uint8_t shift = 0;
+      while (((voices * 127) >> shift) > 127) shift++;
+      int16_t expected = AUDIO_SILENCE + (sum >> shift);
+      uint8_t sample = audio_nextSample();
+      if (expected < 0 || expected > 255 || sample != expected) errors++;
+      if (sample < low) low = sample;
+      if (sample > high) high = sample;
+    }
+    uint16_t cycles = AUDIO_CYCLES_BASE + n * AUDIO_CYCLES_PER_VOICE;
+    bool voicesOk = n < AUDIO_VOICES || (extra == AUDIO_VOICES && audio_activeVoices == AUDIO_VOICES - 1);
+    printf("  %u voix : mélange %s, échantillons %d..%d, ~%u cycles/échantillon = %.1f %% du CPU%s\n", n,
+           errors ? "DIFFÉRENT" : "exact", low, high, cycles, cycles / period * 100.0,
+           n < AUDIO_VOICES ? "" : voicesOk ? ", note de trop ignorée, voix fermée sans toucher aux autres"
+                                            : ", ALLOCATION DES VOIX FAUSSE");
+    if (errors || !voicesOk || cycles >= period) ok = false;
+  }
+  audio_allOff();
+  return ok;
+}
+#endif
+
+static const char* stateName(uint8_t state) {
+  switch (state) {
+    case GAME_STATE_MENU: return "MENU";
+    case GAME_STATE_LEVEL: return "NIVEAU";
+    case GAME_STATE_WIN: return "WIN";
+    case GAME_STATE_LOSE: return "LOSE";
+  }
+  return "?";
+}
+
+// Compare les images RAM décodées sur le bus avec la shadowram du pilote
+static void checkShadow() {
+  if (ht1632_framemode) return;
+  for (uint8_t chip = 0; chip < CHIP_MAX; chip++) {
+    for (uint8_t addr = 0; addr < 64; addr++) {
+      if (bus_chipRam(chip, addr) != ht1632_shadowram[addr][chip]) shadowMismatches++;
+    }
+  }
+}
+
+// Une itération de loop() avec attribution du trafic à l'état courant
+static void step() {
+  uint8_t state = gameState.etat & 3;
+  BusStats before = bus_stats;
+  unsigned long ticks = hal_timerTicks;
+  uint64_t isr = hal_isrNs;
+  uint64_t adc = hal_adcIsrNs;
+
+  uint16_t frames = levelFrameCount;
+
+  hal_advance(hal_costs.loopNs);
+  loop();
+#if MUSIQUE && AUDIO_DDS
+  renderAudio(state == GAME_STATE_LEVEL);
+#endif
+
+  if (levelFrameCount != frames && state == GAME_STATE_LEVEL) {
+    composedFrames++;
+    composedPixels += levelFramePixels;
+    composedClocks += levelFrameBusBits;
+    if (levelFramePixels > composedPixelsMax) composedPixelsMax = levelFramePixels;
+  }
+
+  if (pressWaiting && cursor.state == CURSOR_STATE_BLINKING) {
+    uint64_t latency = hal_nowNs - pressStartNs;
+    pressLatencySum += latency;
+    if (latency > pressLatencyMax) pressLatencyMax = latency;
+    pressCount++;
+    pressWaiting = false;
+    uint64_t stamp = (uint64_t)game.lastPressTime * 1000ULL;
+    uint64_t error = stamp > pressStartNs ? stamp - pressStartNs : pressStartNs - stamp;
+    if (error > pressStampErrorMax) pressStampErrorMax = error;
+  }
+
+  StateStats& s = stateStats[state];
+  s.loops++;
+  s.ticks += hal_timerTicks - ticks;
+  s.clocks += bus_stats.ht1632Clocks - before.ht1632Clocks;
+  s.commands += bus_stats.ht1632Commands - before.ht1632Commands;
+  s.ht1632Ns += bus_stats.ht1632WireNs - before.ht1632WireNs;
+  s.i2cTransactions += bus_stats.i2cTransactions - before.i2cTransactions;
+  s.i2cNs += bus_stats.i2cWireNs - before.i2cWireNs;
+  s.isrNs += hal_isrNs - isr;
+  s.adcNs += hal_adcIsrNs - adc;
+  checkShadow();
+}
+
+// ===== PILOTE AUTOMATIQUE =====
+
+// Valeur du potentiomètre qui place le curseur au milieu de la ligne y
+// (loin des frontières où joue l'hystérésis de pot.cpp)
+static int potForCursor(uint8_t y) {
+  return (2 * y + 1) * 1024 / (2 * (MATRIX_HEIGHT - 1));
+}
+
+// Valeur du potentiomètre qui sélectionne un niveau dans le menu (mapping inversé)
+static int potForLevel(uint8_t level) { return (9 - level) * 114 + 57; }
+
+// Suit le prochain bloc qui arrive sur les colonnes vertes et appuie quand il y est ;
+// lâche un bloc dès que sa queue a passé x=3 (ses pixels sont comptés) pour viser le suivant
+static void autopilot() {
+  int8_t target = -1;
+  for (uint8_t i = 0; i < MAX_BLOCKS; i++) {
+    if (!(game.blockActiveMask & ((BlockMask)1 << i)) || game.blockX[i] + game.blockLength[i] <= CURSOR_COLUMN_START + 1) continue;
+    if (target < 0 || game.blockX[i] < game.blockX[target]) target = i;
+  }
+  if (target < 0) {
+    hal_setInput(BUTTON_PIN, HIGH);
+    return;
+  }
+  int16_t x = game.blockX[target];
+  bool onGreen = x <= CURSOR_COLUMN_START + 1 && x + game.blockLength[target] > CURSOR_COLUMN_START;
+  bool aligned = game.cursorY == game.blockY[target];
+  // Le potentiomètre n'est lu que bouton relâché : viser d'abord, appuyer ensuite
+  if (hal_pinLevel(BUTTON_PIN) == HIGH) hal_setAnalog(POT_PIN, potForCursor(game.blockY[target]));
+  bool press = onGreen && aligned;
+  if (press && hal_pinLevel(BUTTON_PIN) == HIGH && cursor.state != CURSOR_STATE_BLINKING) {
+    pressStartNs = hal_nowNs;
+    pressWaiting = true;
+  }
+  if (!press) pressWaiting = false;
+  hal_setInput(BUTTON_PIN, press ? LOW : HIGH);
+}
+
+// ===== POTENTIOMÈTRE : BRUIT ET LATENCE =====
+
+// Ancienne lecture : analogRead() tous les 4 ticks (100 ms), bande morte de ±5, ligne par map()
+struct OldPot {
+  int value;
+  uint8_t row;
+};
+
+static void oldPotRead(OldPot& p) {
+  int raw = hal_adcSample(POT_PIN);
+  if (abs(raw - p.value) <= 5) return;
+  p.value = raw;
+  int y = map(raw, 0, 1024, 0, MATRIX_HEIGHT - 1);
+  p.row = y < 0 ? 0 : y > MATRIX_HEIGHT - 2 ? MATRIX_HEIGHT - 2 : y;
+}
+
+// Avance d'une milliseconde ; l'ancienne lecture a lieu toutes les 100 ms
+static void potMillisecond(OldPot& old) {
+  hal_advance(1000000);
+  if ((hal_nowNs / 1000000) % 100 == 0) oldPotRead(old);
+}
+
+static void potStudy() {
+  static const int noises[] = { 0, 2, 4, 8, 16 };
+  const int boundary = (8 * 1024 + MATRIX_HEIGHT - 2) / (MATRIX_HEIGHT - 1);  // lignes 7 | 8
+#if POT_TRIGGER == POT_TRIGGER_TIMER1
+  printf("potentiomètre : filtre %u conversions/échantillon par tick Timer1, moyenne sur %u, hystérésis %u LSB\n",
+         POT_OVERSAMPLE, POT_RING, POT_HYSTERESIS);
+#else
+  printf("potentiomètre : filtre %u conversions/échantillon à %.0f Hz, moyenne sur %u, hystérésis %u LSB\n",
+         POT_OVERSAMPLE, POT_ADC_RATE, POT_RING, POT_HYSTERESIS);
+#endif
+  printf("%-8s | %-36s | %-36s\n", "", "filtre (pot.cpp)", "ancien (analogRead / 100 ms)");
+  printf("%-8s | %10s %12s %12s | %10s %12s %12s\n", "bruit", "écart LSB", "lignes/s", "latence ms",
+         "écart LSB", "lignes/s", "latence ms");
+  for (uint8_t n = 0; n < sizeof(noises) / sizeof(noises[0]); n++) {
+    hal_adcNoise = noises[n];
+    OldPot old = { 0, 0 };
+
+    // Stationnaire sur la frontière entre deux lignes : bruit publié et changements de ligne
+    hal_setAnalog(POT_PIN, boundary);
+    for (uint16_t ms = 0; ms < 300; ms++) potMillisecond(old);
+    double sum = 0, sum2 = 0, oldSum = 0, oldSum2 = 0;
+    uint32_t rowChanges = 0, oldRowChanges = 0, samples = 0, oldSamples = 0;
+    uint8_t row = pot_read().cursor, oldRow = old.row;
+    for (uint16_t ms = 0; ms < 4000; ms++) {
+      potMillisecond(old);
+      PotState pot = pot_read();
+      sum += pot.value;
+      sum2 += (double)pot.value * pot.value;
+      samples++;
+      if (pot.cursor != row) rowChanges++;
+      row = pot.cursor;
+      if ((hal_nowNs / 1000000) % 100 == 0) {
+        oldSum += old.value;
+        oldSum2 += (double)old.value * old.value;
+        oldSamples++;
+        if (old.row != oldRow) oldRowChanges++;
+        oldRow = old.row;
+      }
+    }
+    double sd = sqrt(sum2 / samples - (sum / samples) * (sum / samples));
+    double oldSd = sqrt(oldSum2 / oldSamples - (oldSum / oldSamples) * (oldSum / oldSamples));
+
+    // Échelons ligne 2 <-> ligne 12 à des phases différentes : délai jusqu'à la nouvelle ligne
+    double latency = 0, oldLatency = 0;
+    const uint8_t trials = 20;
+    for (uint8_t t = 0; t < trials; t++) {
+      uint8_t from = (t & 1) ? 12 : 2, to = (t & 1) ? 2 : 12;
+      hal_setAnalog(POT_PIN, potForCursor(from));
+      for (uint16_t ms = 0; ms < 300 + t * 7; ms++) potMillisecond(old);
+      hal_setAnalog(POT_PIN, potForCursor(to));
+      int newMs = -1, oldMs = -1;
+      for (uint16_t ms = 1; ms <= 1000 && (newMs < 0 || oldMs < 0); ms++) {
+        potMillisecond(old);
+        if (newMs < 0 && pot_read().cursor == to) newMs = ms;
+        if (oldMs < 0 && old.row == to) oldMs = ms;
+      }
+      latency += newMs;
+      oldLatency += oldMs;
+    }
+    printf("±%-2d LSB | %10.2f %12.2f %12.1f | %10.2f %12.2f %12.1f\n", noises[n], sd,
+           rowChanges / 4.0, latency / trials, oldSd, oldRowChanges / 4.0, oldLatency / trials);
+  }
+  hal_adcNoise = 0;
+}
+
+// ===== CHANSONS COMPRESSÉES =====
+// song_data.h est généré par tools/songpack à partir de song_patterns.h : la lecture de
+// songRead() doit redonner, niveau par niveau, les notes des quatre parties à la suite.
+// Un song_data.h qui n'a pas été régénéré après une modification des patterns est signalé ici.
+
+struct SongPart {
+  const MusicNote* notes;
+  uint8_t size;
+};
+#define SONG_PART(n, part) { level##n##_##part, sizeof(level##n##_##part) / sizeof(MusicNote) }
+#define SONG_LEVEL(n) { SONG_PART(n, intro), SONG_PART(n, verse), SONG_PART(n, chorus), SONG_PART(n, hook) }
+static const SongPart songParts[MAX_DIFFICULTY_LEVEL][4] = {
+  SONG_LEVEL(1), SONG_LEVEL(2), SONG_LEVEL(3), SONG_LEVEL(4), SONG_LEVEL(5),
+  SONG_LEVEL(6), SONG_LEVEL(7), SONG_LEVEL(8), SONG_LEVEL(9)
+};
+#undef SONG_PART
+#undef SONG_LEVEL
+
+static bool songCheck() {
+  unsigned patternBytes = 0;
+  for (uint8_t level = 0; level < MAX_DIFFICULTY_LEVEL; level++)
+    for (uint8_t part = 0; part < 4; part++) patternBytes += songParts[level][part].size * sizeof(MusicNote);
+  unsigned packedBytes = sizeof(songDurations) + sizeof(songPhrases) + sizeof(songPhraseStart) +
+                         sizeof(songSections) + sizeof(songLevelStart);
+  printf("chansons : song_data.h %u octets, tableaux MusicNote de song_patterns.h %u octets (x%.2f)\n",
+         packedBytes, patternBytes, (double)patternBytes / packedBytes);
+  bool ok = true;
+  for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) {
+    SongReader song;
+    songStart(&song, level);
+    uint16_t notes = 0, errors = 0;
+    MusicNote decoded, expected;
+    for (uint8_t part = 0; part < 4; part++) {
+      const SongPart& p = songParts[level - 1][part];
+      for (uint8_t i = 0; i < p.size; i++, notes++) {
+        getNote(p.notes, i, &expected);
+        if (!songRead(&song, &decoded) || decoded.note != expected.note || decoded.duration != expected.duration) errors++;
+      }
+    }
+    uint16_t extra = 0;
+    while (songRead(&song, &decoded)) extra++;
+    uint16_t sections = pgm_read_word(&songLevelStart[level]) - pgm_read_word(&songLevelStart[level - 1]);
+    printf("niveau %u : %u notes, %u sections, %s\n", level, notes, sections,
+           errors || extra ? "DIFFÉRENT (relancer tools/songpack)" : "identique");
+    if (errors || extra) ok = false;
+  }
+  return ok;
+}
+
+// ===== HORLOGE MUSICALE : DÉRIVE =====
+// La ligne de temps de chaque niveau tourne seule, un tempoAdvance() par tick comme dans
+// periodicFunction(). Chaque déplacement et chaque apparition de note est comparé à son
+// instant exact (double) : position k * colonne, ou somme des durées des notes précédentes.
+// L'écart doit rester sous un tick du début à la fin, sans tendance (dérive).
+
+// Écarts (µs) d'une suite d'échéances : maximum, moyennes de la première et de la dernière minute
+struct TempoErrors {
+  uint32_t count;
+  double max, exactMax;
+  double firstSum, lastSum;
+  uint32_t firstCount, lastCount;
+};
+
+static void tempoRecord(TempoErrors& e, double ideal, double tick, double exact, double end) {
+  double error = tick - ideal;
+  e.count++;
+  if (error > e.max) e.max = error;
+  if (fabs(exact - ideal) > e.exactMax) e.exactMax = fabs(exact - ideal);
+  if (ideal < 60e6) { e.firstSum += error; e.firstCount++; }
+  if (ideal >= end - 60e6) { e.lastSum += error; e.lastCount++; }
+}
+
+static double tempoDrift(const TempoErrors& e) {
+  if (!e.firstCount || !e.lastCount) return 0;
+  return e.lastSum / e.lastCount - e.firstSum / e.firstCount;
+}
+
+static bool tempoStudy(uint32_t seconds) {
+  bool ok = true;
+  printf("horloge musicale : tick %u µs, %u s simulées par niveau, écarts en ms (tick / échéance exacte)\n",
+         TIMER_PERIOD, seconds);
+  printf("%-6s %5s %9s %9s | %8s %8s %9s %8s | %8s %8s %9s %8s | %10s\n", "niveau", "bpm", "colonne",
+         "u/tick", "dépl.", "max", "exact", "dérive", "notes", "max", "exact", "dérive", "sans reste");
+  for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) {
+    Tempo tempo;
+    SongReader song;
+    tempo.bpm = engine_levelBpm(level);
+    tempo.column = engine_levelColumn(level);
+    tempoStart(&tempo);
+    songStart(&song, level);
+    double unitUs = 60e6 / (tempo.bpm * 8.0 * TEMPO_ONE);  // durée exacte d'une unité
+    double end = seconds * 1e6;
+    TempoErrors moves = {}, spawns = {};
+    uint32_t moveCount = 0;
+    uint64_t spawnUnits = 0;   // somme des durées des notes déjà apparues (unités)
+    // La note 0 est due au démarrage, avant le premier tick
+    for (uint64_t tick = 0; tick * TIMER_PERIOD <= end; tick++) {
+      if (tick) tempoAdvance(&tempo);
+      double now = (double)tick * TIMER_PERIOD;
+      while (TEMPO_DUE(&tempo, tempo.nextMove)) {
+        double exact = now - tempoLateMicros(&tempo, tempo.nextMove);
+        tempoRecord(moves, ++moveCount * (double)tempo.column * unitUs, now, exact, end);
+        tempo.nextMove += tempo.column;
+      }
+      while (TEMPO_DUE(&tempo, tempo.nextSpawn)) {
+        double exact = now - tempoLateMicros(&tempo, tempo.nextSpawn);
+        tempoRecord(spawns, spawnUnits * unitUs, now, exact, end);
+        // Chanson du niveau (song_data.h) jouée en boucle
+        MusicNote note;
+        if (!songRead(&song, &note)) {
+          songStart(&song, level);
+          songRead(&song, &note);
+        }
+        spawnUnits += (uint32_t)note.duration << TEMPO_FRAC_BITS;
+        tempo.nextSpawn += (uint32_t)note.duration << TEMPO_FRAC_BITS;
+      }
+    }
+    // Même ligne de temps avec une avance par tick arrondie à l'unité, sans le reste
+    double exactStep = (double)TIMER_PERIOD / unitUs;
+    double naive = fabs((double)(tempo.whole + (tempo.fraction * 2 >= TEMPO_DENOMINATOR)) - exactStep) /
+                   exactStep * end;
+    printf("%-6u %5u %9.2f %9.2f | %8u %8.2f %9.3f %8.3f | %8u %8.2f %9.3f %8.3f | %10.1f\n", level, tempo.bpm,
+           (double)tempo.column / TEMPO_ONE, exactStep, moves.count, moves.max / 1000, moves.exactMax / 1000,
+           tempoDrift(moves) / 1000, spawns.count, spawns.max / 1000, spawns.exactMax / 1000,
+           tempoDrift(spawns) / 1000, naive / 1000);
+    if (moves.max >= TIMER_PERIOD || spawns.max >= TIMER_PERIOD) {
+      printf("niveau %u : échéance en retard d'un tick ou plus\n", level);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+// ===== EEPROM : JOURNAL DES SCORES =====
+// Une suite de sauvegardes aléatoires (niveau, score) passe par store_save() et store_poll(),
+// chacune écrite jusqu'au bout avant la suivante, assez pour faire plusieurs fois le tour du
+// journal. Puis la même suite est rejouée une fois par écriture d'octet, avec une coupure
+// d'alimentation à cette écriture : au redémarrage, store_begin() doit retrouver l'état de la
+// dernière sauvegarde entièrement écrite (ou la suivante si seul son octet de validation a été
+// coupé en prenant par hasard la bonne valeur), et une nouvelle sauvegarde doit encore passer.
+
+#define EEPROM_SAVES 200
+
+struct EepromSave {
+  uint8_t level, score;
+};
+
+static bool sameStore(const StoreState& a, const StoreState& b) {
+  return !memcmp(&a, &b, sizeof(StoreState));
+}
+
+// Écriture de l'enregistrement en cours jusqu'au bout (ou jusqu'à la coupure)
+static void eepromDrain() {
+  while (store_stats.busy && !hal_eepromPowerLost) {
+    store_poll();
+    hal_advance(HAL_EEPROM_WRITE_NS / 4);
+  }
+}
+
+// Sauvegardes jusqu'à la coupure ; état attendu au redémarrage dans expected (et alternative)
+static void eepromRun(const EepromSave* saves, StoreState* expected, StoreState* alternative) {
+  store_begin();
+  *expected = *alternative = store_read();
+  for (uint16_t i = 0; i < EEPROM_SAVES && !hal_eepromPowerLost; i++) {
+    unsigned long before = hal_eepromWrites;
+    store_save(saves[i].level, saves[i].score);
+    eepromDrain();
+    if (!hal_eepromPowerLost) *expected = *alternative = store_read();
+    else if (hal_eepromWrites - before == STORE_RECORD + 1) *alternative = store_read();
+  }
+}
+
+static bool eepromStudy() {
+  EepromSave saves[EEPROM_SAVES];
+  uint32_t random = 12345;
+  for (uint16_t i = 0; i < EEPROM_SAVES; i++) {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    saves[i].level = MIN_DIFFICULTY_LEVEL + random % MAX_DIFFICULTY_LEVEL;
+    saves[i].score = (random >> 8) % 101;
+  }
+
+  // Suite complète sans coupure : usure et temps de démarrage
+  hal_eepromReset(true);
+  hal_eepromCut = -1;
+  StoreState expected, alternative;
+  eepromRun(saves, &expected, &alternative);
+  unsigned long writes = hal_eepromWrites;
+  uint16_t records = store_stats.records;
+  uint32_t wearMax = 0, wearMin = UINT32_MAX;
+  for (uint16_t a = STORE_BASE; a < STORE_BASE + STORE_SLOTS * STORE_RECORD; a++) {
+    if (hal_eepromWear[a] > wearMax) wearMax = hal_eepromWear[a];
+    if (hal_eepromWear[a] < wearMin) wearMin = hal_eepromWear[a];
+  }
+  store_begin();
+  bool ok = sameStore(store_read(), expected);
+  printf("EEPROM : %u sauvegardes, %u enregistrements de %u octets (%lu écritures, %.1f s d'écriture en "
+         "arrière-plan), journal de %u emplacements parcouru %.1f fois\n", EEPROM_SAVES, records, STORE_RECORD,
+         writes, writes * HAL_EEPROM_WRITE_NS / 1e9, STORE_SLOTS, (double)records / STORE_SLOTS);
+  printf("  usure : %u à %u écritures par octet (un enregistrement fixe : %u sur son octet de validation)\n",
+         wearMin, wearMax, 2 * records);
+  printf("  redémarrage : %u enregistrements valides, séquence %u, état %s\n", store_stats.valid,
+         store_stats.sequence, ok ? "retrouvé" : "DIFFÉRENT");
+
+  // Sauvegardes rapprochées : une seule écriture en attente, la dernière valeur gagne
+  uint16_t recordsBefore = store_stats.records, coalescedBefore = store_stats.coalesced;
+  store_save(1, 10);
+  store_save(2, 20);
+  store_save(3, 30);
+  store_save(4, 40);
+  StoreState merged = store_read();
+  eepromDrain();
+  eepromDrain();
+  uint16_t mergedRecords = store_stats.records - recordsBefore;
+  uint16_t mergedSaves = store_stats.coalesced - coalescedBefore;
+  store_begin();
+  bool coalesced = mergedRecords == 2 && mergedSaves == 2 && sameStore(store_read(), merged);
+  printf("  4 sauvegardes pendant une écriture : %u enregistrements, %u fusionnées, %s\n", mergedRecords,
+         mergedSaves, coalesced ? "dernier état retrouvé" : "DIFFÉRENT");
+  ok = ok && coalesced;
+
+  // Coupure à chaque écriture d'octet
+  unsigned failures = 0, newer = 0;
+  for (long cut = 0; cut < (long)writes; cut++) {
+    hal_eepromReset(true);
+    hal_eepromCut = cut;
+    eepromRun(saves, &expected, &alternative);
+    hal_eepromCut = -1;
+    hal_eepromReset(false);
+    store_begin();
+    StoreState found = store_read();
+    if (!sameStore(found, expected) && !sameStore(found, alternative)) {
+      if (!failures) printf("  coupure à l'écriture %ld : état retrouvé différent\n", cut);
+      failures++;
+      continue;
+    }
+    if (!sameStore(found, expected)) newer++;
+    // Le journal doit encore accepter une sauvegarde
+    uint8_t level = found.level % MAX_DIFFICULTY_LEVEL + 1;
+    store_save(level, 100);
+    eepromDrain();
+    store_begin();
+    if (store_read().level != level || store_read().best[level - 1] != 100) failures++;
+  }
+  printf("  coupures : %lu essais (une par écriture), %u états faux, %u validations coupées mais justes\n",
+         writes, failures, newer);
+  return ok && !failures;
+}
+
+// ===== CHAÎNE DE CARTES HT1632 =====
+// Images envoyées par ht1632_flush() sur l'écran choisi à la compilation (HT1632Panel) :
+// à comparer entre des bancs compilés pour 1, 2 et 4 cartes.
+
+struct PanelLoad {
+  const char* name;
+  uint8_t boards;   // cartes dessinées (0 = toutes)
+  bool full;        // tout l'écran change (sinon 16 pixels par carte)
+};
+
+// Image "frame" de la charge : 16 pixels allumés puis éteints à l'image suivante, ou l'écran
+// entier alternativement vert et rouge
+static void panelFrame(const PanelLoad& load, uint8_t frame) {
+  ht1632_beginframe();
+  if (load.full) ht1632_fill((frame & 1) ? RED : GREEN);
+  uint8_t boards = load.boards ? load.boards : (uint8_t)HT1632Panel::boards;
+  for (uint8_t board = 0; board < boards && !load.full; board++) {
+    for (uint8_t i = 0; i < 16; i++) {
+      uint8_t k = i + (frame >> 1) * 16;
+      ht1632_plot((board % HT1632_BOARDS_X) * HT1632Board::width + (k * 7) % HT1632Board::width,
+                  (board / HT1632_BOARDS_X) * HT1632Board::height + (k * 5 + (k >> 5)) % HT1632Board::height,
+                  (frame & 1) ? BLACK : ORANGE);
+    }
+  }
+  ht1632_flush();
+}
+
+static bool panelStudy() {
+  static const PanelLoad loads[] = {
+    { "16 pixels sur la première carte", 1, false },
+    { "16 pixels par carte", 0, false },
+    { "écran complet", 0, true },
+  };
+  const uint8_t frames = 64;
+  ht1632_setup();
+  ht1632_clear();
+  printf("écran %ux%u : %u carte(s) %ux%u, %u puces, shadowram %u octets\n", X_MAX, Y_MAX,
+         HT1632Panel::boards, HT1632_BOARDS_X, HT1632_BOARDS_Y, CHIP_MAX, (unsigned)sizeof(ht1632_shadowram));
+  for (const PanelLoad& load : loads) {
+    BusStats before = bus_stats;
+    uint64_t start = hal_nowNs;
+    for (uint8_t frame = 0; frame < frames; frame++) {
+      panelFrame(load, frame);
+      checkShadow();
+    }
+    double clocks = (double)(bus_stats.ht1632Clocks - before.ht1632Clocks) / frames;
+    double select = (double)(bus_stats.ht1632SelectClocks - before.ht1632SelectClocks) / frames;
+    double micros = (hal_nowNs - start) / 1e3 / frames;
+    printf("  %-32s %7.0f clk/image (dont sélection %4.1f) %8.1f µs/image %6.1f µs/puce\n", load.name, clocks,
+           select, micros, micros / CHIP_MAX);
+  }
+  printf("  erreurs bus %llu, divergences RAM/shadow %llu\n", (unsigned long long)bus_stats.errors,
+         (unsigned long long)shadowMismatches);
+  return !bus_stats.errors && !shadowMismatches;
+}
+
+// ===== MOTEUR SEUL =====
+// Les entrées du moteur du jeu (ticks et appuis datés) sont enregistrées pendant chaque niveau,
+// puis rejouées par un autre moteur, sans matériel ni interruption : le rejeu doit finir le
+// niveau avec le même score et le même jugement (host/runner.cpp s'appuie là-dessus).
+
+static EngineTraceStep levelSteps[1 << 16];
+static EngineTrace levelTrace = { levelSteps, sizeof(levelSteps) / sizeof(levelSteps[0]), 0, 0, 0, 0 };
+static Engine replayEngine;
+
+static void replayCheck() {
+  uint32_t ticks = engine_run(&replayEngine, &levelTrace);
+  bool same = !levelTrace.lost && engine_finished(&replayEngine) &&
+              replayEngine.score.current == game.score.current &&
+              replayEngine.score.maxPossible == game.score.maxPossible &&
+              replayEngine.judge.perfect == game.judge.perfect && replayEngine.judge.good == game.judge.good &&
+              replayEngine.judge.miss == game.judge.miss;
+  printf("  moteur seul : %u ticks et %u appuis rejoués, %s\n", ticks, levelTrace.count - ticks,
+         same ? "même score et même jugement" : "DIFFÉRENT");
+  if (!same) replayMismatches++;
+}
+
+// ===== SCÉNARIO =====
+
+static void runFor(uint32_t ms, bool pilot) {
+  uint64_t end = hal_nowNs + (uint64_t)ms * 1000000ULL;
+  while (hal_nowNs < end) {
+    if (pilot && gameState.etat == GAME_STATE_LEVEL) autopilot();
+    step();
+  }
+}
+
+static bool runUntil(uint8_t state, uint32_t timeoutMs, bool pilot) {
+  uint64_t end = hal_nowNs + (uint64_t)timeoutMs * 1000000ULL;
+  while (hal_nowNs < end) {
+    if (gameState.etat == state) return true;
+    if (pilot && gameState.etat == GAME_STATE_LEVEL) autopilot();
+    step();
+  }
+  return gameState.etat == state;
+}
+
+static void pressButton(uint32_t ms) {
+  hal_setInput(BUTTON_PIN, LOW);
+  runFor(ms, false);
+  hal_setInput(BUTTON_PIN, HIGH);
+}
+
+static void playLevel(uint8_t level) {
+  // Menu : choisir le niveau puis valider
+  runUntil(GAME_STATE_MENU, 5000, false);
+  hal_setAnalog(POT_PIN, potForLevel(level));
+  runFor(800, false);
+  pressButton(400);
+  if (!runUntil(GAME_STATE_LEVEL, 3000, false)) {
+    printf("niveau %u : validation du menu impossible\n", level);
+    return;
+  }
+
+  uint64_t start = hal_nowNs;
+  // Un niveau dure quelques minutes au plus
+  while (gameState.etat == GAME_STATE_LEVEL && hal_nowNs - start < 600000000000ULL) {
+    if (!idlePlayer) autopilot();
+    step();
+  }
+  hal_setInput(BUTTON_PIN, HIGH);
+  printf("niveau %u : %s, score %u/%u (%u%%), %.1f s, appuis parfaits %u, bons %u, ratés %u, notes sans bloc %u\n",
+         level, stateName(gameState.etat), game.score.current, game.score.maxPossible, game.score.transformed,
+         (hal_nowNs - start) / 1e9, game.judge.perfect, game.judge.good, game.judge.miss, game.dropped);
+  replayCheck();
+  if (showScreen) bus_render(stdout);
+
+  // Écran de fin : retour au menu
+  runFor(1000, false);
+  pressButton(300);
+  runUntil(GAME_STATE_MENU, 3000, false);
+}
+
+static void report() {
+  printf("\n%-7s %8s %8s %10s %10s %12s %10s %10s %10s %13s\n", "état", "ticks", "loops",
+         "bits/tick", "cmd/tick", "HT1632 µs/t", "I2C tr/t", "I2C µs/t", "ISR µs/t", "+ ADC µs/t");
+  for (uint8_t state = 0; state < 4; state++) {
+    const StateStats& s = stateStats[state];
+    if (!s.ticks) continue;
+    double t = (double)s.ticks;
+    printf("%-7s %8llu %8llu %10.1f %10.2f %12.1f %10.2f %10.1f %10.1f %13.1f\n", stateName(state),
+           (unsigned long long)s.ticks, (unsigned long long)s.loops, s.clocks / t,
+           s.commands / t, s.ht1632Ns / t / 1000.0, s.i2cTransactions / t,
+           s.i2cNs / t / 1000.0, s.isrNs / t / 1000.0, (s.isrNs + s.adcNs) / t / 1000.0);
+  }
+  printf("\ntemps simulé %.1f s, ticks perdus %lu, erreurs bus %llu, divergences RAM/shadow %llu\n",
+         hal_nowNs / 1e9, hal_timerMissed, (unsigned long long)bus_stats.errors,
+         (unsigned long long)shadowMismatches);
+  printf("écrans (changement d'état -> écran complet) :");
+  for (uint8_t state = 0; state < 4; state++) {
+    if (screenReadyMicros[state])
+      printf(" %s %.2f ms / %lu clk", stateName(state), screenReadyMicros[state] / 1000.0, screenReadyBits[state]);
+  }
+  printf(", ticks suspendus %u\n", transitionTicks);
+  if (composedFrames)
+    printf("compositeur : %llu images, pixels modifiés %.2f/image (max %u), %.1f clk/image\n",
+           (unsigned long long)composedFrames, (double)composedPixels / composedFrames,
+           composedPixelsMax, (double)composedClocks / composedFrames);
+#if MUSIQUE && AUDIO_DDS
+  uint64_t levelSamples = 0, voiceSum = 0;
+  uint8_t voiceMax = 0;
+  for (uint8_t v = 0; v <= AUDIO_VOICES; v++) {
+    levelSamples += audioVoiceSamples[v];
+    voiceSum += audioVoiceSamples[v] * v;
+    if (audioVoiceSamples[v]) voiceMax = v;
+  }
+  if (levelSamples) {
+    double busy = (double)(levelSamples - audioVoiceSamples[0]) / levelSamples;
+    double cycles = busy * AUDIO_CYCLES_BASE + (double)voiceSum / levelSamples * AUDIO_CYCLES_PER_VOICE;
+    uint16_t peak = voiceMax ? AUDIO_CYCLES_BASE + voiceMax * AUDIO_CYCLES_PER_VOICE : 0;
+    printf("audio DDS : %.0f Hz, voix ouvertes %.2f/échantillon (max %u, son %.0f %% du temps), "
+           "~%.0f cycles/échantillon (pointe %u) = %.1f %% du CPU\n",
+           AUDIO_SAMPLE_RATE, (double)voiceSum / levelSamples, voiceMax, busy * 100.0, cycles, peak,
+           cycles * AUDIO_SAMPLE_RATE / F_CPU * 100.0);
+  }
+#endif
+  if (pressCount)
+    printf("bouton : %u appuis, datés à %.0f µs près, pris en compte %.1f ms après en moyenne (max %.1f ms), "
+           "fronts %u, rebonds %u, rétablis %u\n", pressCount, pressStampErrorMax / 1e3,
+           pressLatencySum / 1e6 / pressCount, pressLatencyMax / 1e6, button_stats.edges,
+           button_stats.bounces, button_stats.restored);
+  double adcTick = hal_timerTicks ? hal_adcIsrNs / 1000.0 / hal_timerTicks : 0.0;
+  double isrTick = hal_timerTicks ? hal_isrNs / 1000.0 / hal_timerTicks : 0.0;
+  printf("ADC : %lu conversions, interruption ADC %.1f µs/tick (estimation) ; "
+         "total Timer1 + ADC %.1f µs/tick = %.2f %% du CPU\n", hal_adcConversions, adcTick,
+         isrTick + adcTick, (isrTick + adcTick) / TIMER_PERIOD * 100.0);
+#if TELEMETRY
+  printf("télémétrie : %u trames envoyées, %u enregistrements perdus (file pleine), %u dépassements du tick\n",
+         telem_stats.sent, telem_stats.lost, telem_stats.overruns);
+#endif
+  if (hal_serialOut.size())
+    printf("Serial : %zu octets émis, %.1f ms passées à attendre le tampon d'émission\n", hal_serialOut.size(),
+           hal_serialBlockedNs / 1e6);
+  printf("EEPROM : %u enregistrements, %u octets écrits en arrière-plan, %u sauvegardes fusionnées\n",
+         store_stats.records, store_stats.bytes, store_stats.coalesced);
+  printf("7 segments : envois %u, déjà affichés %u, fusionnés %u, file max %u, reprises %u, pertes %u\n",
+         seg7_stats.sent, seg7_stats.cached, seg7_stats.coalesced, seg7_stats.maxPending,
+         seg7_stats.retries, seg7_stats.dropped);
+}
+
+int main(int argc, char** argv) {
+  uint8_t levels[MAX_DIFFICULTY_LEVEL];
+  uint8_t levelCount = 0;
+  bool potOnly = false;
+  uint32_t tempoSeconds = 0;
+  bool songOnly = false;
+  bool eepromOnly = false;
+  bool panelOnly = false;
+  bool audioOnly = false;
+  const char* serialFile = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--digitalwrite")) hal_costs.pinWriteNs = 3400;
+    else if (!strcmp(argv[i], "--serial")) hal_serialEcho = true;
+    else if (!strcmp(argv[i], "--screen")) showScreen = true;
+    else if (!strcmp(argv[i], "--idle")) idlePlayer = true;
+    else if (!strcmp(argv[i], "--pot")) potOnly = true;
+    else if (!strcmp(argv[i], "--song")) songOnly = true;
+    else if (!strcmp(argv[i], "--eeprom")) eepromOnly = true;
+    else if (!strcmp(argv[i], "--panel")) panelOnly = true;
+    else if (!strcmp(argv[i], "--serialout") && i + 1 < argc) serialFile = argv[++i];
+    else if (!strcmp(argv[i], "--tempo")) {
+      tempoSeconds = 3600;
+      if (i + 1 < argc && atoi(argv[i + 1]) > 0) tempoSeconds = atoi(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--potnoise") && i + 1 < argc) hal_adcNoise = atoi(argv[++i]);
+#if MUSIQUE && AUDIO_DDS
+    else if (!strcmp(argv[i], "--audio")) audioOnly = true;
+    else if (!strcmp(argv[i], "--wav") && i + 1 < argc) {
+      wavFile = fopen(argv[++i], "wb");
+      if (!wavFile) perror(argv[i]);
+      else wavHeader(wavFile, 0);
+    }
+#endif
+    else {
+      int level = atoi(argv[i]);
+      if (level >= MIN_DIFFICULTY_LEVEL && level <= MAX_DIFFICULTY_LEVEL && levelCount < MAX_DIFFICULTY_LEVEL)
+        levels[levelCount++] = (uint8_t)level;
+    }
+  }
+  if (!levelCount) {
+    for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) levels[levelCount++] = level;
+  }
+  // Avant setup() : pas d'interruption Timer1 pendant l'étude
+  if (eepromOnly) return eepromStudy() ? 0 : 1;
+  if (panelOnly) return panelStudy() ? 0 : 1;
+#if MUSIQUE && AUDIO_DDS
+  if (audioOnly) return audioStudy() ? 0 : 1;
+#endif
+
+  hal_setInput(BUTTON_PIN, HIGH);
+  hal_setAnalog(POT_PIN, 512);
+#if POT_TRIGGER == POT_TRIGGER_TIMER1
+  hal_adcAttachTimer1(POT_PIN, POT_OVERSAMPLE, pot_sample);
+#else
+  hal_adcAttach(POT_PIN, POT_ADC_RATE, POT_OVERSAMPLE, pot_sample);
+#endif
+  hal_pinChangeAttach(BUTTON_PIN, button_change);
+  setup();
+  game.trace = &levelTrace;
+  if (potOnly) {
+    potStudy();
+    return 0;
+  }
+  if (songOnly) return songCheck() ? 0 : 1;
+  if (tempoSeconds) return tempoStudy(tempoSeconds) ? 0 : 1;
+  for (uint8_t i = 0; i < levelCount; i++) playLevel(levels[i]);
+  report();
+  if (serialFile) {
+    FILE* f = fopen(serialFile, "wb");
+    if (!f) perror(serialFile);
+    else {
+      fwrite(hal_serialOut.data(), 1, hal_serialOut.size(), f);
+      fclose(f);
+    }
+  }
+#if MUSIQUE && AUDIO_DDS
+  if (wavFile) {
+    wavHeader(wavFile, wavBytes);
+    fclose(wavFile);
+  }
+#endif
+#if PROFILING
+  // Compteurs du jeu, demandés comme sur la carte ('p' sur Serial)
+  printf("\n");
+  hal_serialEcho = true;
+  hal_serialInject("p");
+  step();
+#endif
+  return replayMismatches || bus_stats.errors || shadowMismatches ? 1 : 0;
+}
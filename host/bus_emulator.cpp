@@ -0,0 +1,158 @@
+/*
+ * bus_emulator.cpp
+ * Décodage du flux de bits HT1632 : le 74164 décale l'entrée A (broche
+ * ht1632_cs) à chaque front montant de ht1632_clk, ses sorties Q0..Q3 sont
+ * les CS (actifs bas) des puces 1..4 ; avec plusieurs cartes (HT1632Panel),
+ * les registres sont chaînés et la sortie Qk est le CS de la puce k+1,
+ * k < CHIP_MAX. Chaque puce sélectionnée reçoit la
+ * donnée à chaque front montant de WR : ID sur 3 bits, puis adresse sur
+ * 7 bits et quartets successifs (écriture), ou commande sur 9 bits.
+ */
+
+#include <Arduino.h>
+#include "bus_emulator.h"
+#include "../TROMBOSS/ht1632.h"
+
+BusStats bus_stats;
+
+enum { DEC_IDLE, DEC_ID, DEC_ADDRESS, DEC_DATA, DEC_COMMAND, DEC_IGNORE };
+
+struct ChipDecoder {
+  uint8_t state;
+  uint8_t shift;
+  uint8_t count;
+  uint8_t address;
+  uint8_t ram[128];
+};
+
+static ChipDecoder chips[CHIP_MAX];
+static uint32_t shiftReg = 0;       // niveaux des sorties Q de la chaîne de 74164 (1 = haut)
+static uint8_t pinA = HIGH;
+static uint8_t pinClk = LOW;
+static uint8_t pinWr = HIGH;
+static uint8_t pinData = LOW;
+static uint8_t segments[128];
+
+static bool isSelected(uint8_t chip) { return !(shiftReg & (1UL << chip)); }
+
+static void clockShiftRegister() {
+  uint32_t before = shiftReg;
+  shiftReg = ((shiftReg << 1) | (pinA ? 1 : 0)) & HT1632Panel::all();
+  for (uint8_t c = 0; c < CHIP_MAX; c++) {
+    bool wasSelected = !(before & (1UL << c));
+    // Front descendant de CS : début d'une nouvelle commande
+    if (!wasSelected && isSelected(c)) {
+      chips[c].state = DEC_ID;
+      chips[c].shift = 0;
+      chips[c].count = 0;
+    }
+    // Front montant de CS : fin de commande
+    if (wasSelected && !isSelected(c)) chips[c].state = DEC_IDLE;
+  }
+}
+
+static void clockChip(ChipDecoder& chip, uint8_t bit) {
+  chip.shift = (uint8_t)((chip.shift << 1) | bit);
+  chip.count++;
+  switch (chip.state) {
+    case DEC_ID:
+      if (chip.count == 3) {
+        bus_stats.ht1632Commands++;
+        if (chip.shift == HT1632_ID_WR) chip.state = DEC_ADDRESS;
+        else if (chip.shift == HT1632_ID_CMD) chip.state = DEC_COMMAND;
+        else chip.state = DEC_IGNORE;
+        chip.shift = 0;
+        chip.count = 0;
+      }
+      break;
+    case DEC_ADDRESS:
+      if (chip.count == 7) {
+        chip.address = chip.shift & 0x7F;
+        chip.state = DEC_DATA;
+        chip.shift = 0;
+        chip.count = 0;
+      }
+      break;
+    case DEC_DATA:
+      // Premier bit reçu = D0, stocké en bit 3 comme dans ht1632_shadowram
+      if (chip.count == 4) {
+        chip.ram[chip.address & 0x7F] = chip.shift & 0x0F;
+        chip.address = (chip.address + 1) & 0x7F;
+        bus_stats.ht1632Nibbles++;
+        chip.shift = 0;
+        chip.count = 0;
+      }
+      break;
+    case DEC_COMMAND:
+      if (chip.count == 9) chip.state = DEC_IGNORE;
+      break;
+    default:
+      break;
+  }
+}
+
+static void clockWrite() {
+  uint8_t selected = 0;
+  for (uint8_t c = 0; c < CHIP_MAX; c++) selected += isSelected(c);
+  // Plusieurs puces en même temps : normal seulement pour une diffusion (ChipSelect(-1))
+  if (selected > 1 && selected < CHIP_MAX) bus_stats.errors++;
+  for (uint8_t c = 0; c < CHIP_MAX; c++) {
+    if (isSelected(c) && chips[c].state != DEC_IDLE) clockChip(chips[c], pinData ? 1 : 0);
+  }
+}
+
+void bus_pinWrite(uint8_t pin, uint8_t level, uint32_t costNs) {
+  if (pin == ht1632_cs) {
+    pinA = level;
+  } else if (pin == ht1632_clk) {
+    if (level && !pinClk) {
+      clockShiftRegister();
+      bus_stats.ht1632Clocks++;
+      bus_stats.ht1632SelectClocks++;
+    }
+    pinClk = level;
+  } else if (pin == ht1632_wrclk) {
+    if (level && !pinWr) {
+      clockWrite();
+      bus_stats.ht1632Clocks++;
+    }
+    pinWr = level;
+  } else if (pin == ht1632_data) {
+    pinData = level;
+  } else {
+    return;
+  }
+  bus_stats.ht1632WireNs += costNs;
+}
+
+void bus_i2cTransaction(uint8_t address, const uint8_t* data, uint8_t length, uint64_t ns) {
+  bus_stats.i2cTransactions++;
+  bus_stats.i2cBytes += length + 1;
+  bus_stats.i2cWireNs += ns;
+  // Registre 0x09 (GPIO) de l'expandeur : motif des segments
+  if (length >= 2 && data[0] == 0x09) segments[address & 0x7F] = data[1];
+}
+
+uint8_t bus_chipRam(uint8_t chip, uint8_t address) {
+  return chips[chip % CHIP_MAX].ram[address & 0x7F];
+}
+
+uint8_t bus_pixel(uint8_t x, uint8_t y) {
+  uint8_t chip = HT1632Panel::chip(x, y);
+  uint8_t address = HT1632Panel::addr(x, y);
+  uint8_t bit = HT1632Panel::bit(y);
+  uint8_t color = 0;
+  if (chips[chip].ram[address] & bit) color |= GREEN;
+  if (chips[chip].ram[address + 32] & bit) color |= RED;
+  return color;
+}
+
+uint8_t bus_segments(uint8_t address) { return segments[address & 0x7F]; }
+
+void bus_render(FILE* out) {
+  static const char symbols[] = ".gro";
+  for (uint8_t y = 0; y < Y_MAX; y++) {
+    for (uint8_t x = 0; x < X_MAX; x++) fputc(symbols[bus_pixel(x, y)], out);
+    fputc('\n', out);
+  }
+}
@@ -0,0 +1,42 @@
+/*
+ * bus_emulator.h
+ * Émulateur bit à bit des bus de la carte :
+ * - registre 74164 de sélection de puce (chaîné d'une carte à l'autre) +
+ *   protocole HT1632 (ID, adresse, données) décodés en une image de RAM par puce ;
+ * - transactions I2C vers les afficheurs 7 segments.
+ */
+
+#ifndef HOST_BUS_EMULATOR_H
+#define HOST_BUS_EMULATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct BusStats {
+  uint64_t ht1632Clocks;     // impulsions WR + horloge 74164
+  uint64_t ht1632SelectClocks;  // dont horloge 74164 (sélection de puce)
+  uint64_t ht1632Commands;   // commandes HT1632 (ID reçu)
+  uint64_t ht1632Nibbles;    // quartets écrits en RAM
+  uint64_t ht1632WireNs;     // temps passé à écrire les broches du bus
+  uint64_t i2cTransactions;
+  uint64_t i2cBytes;
+  uint64_t i2cWireNs;
+  uint64_t errors;           // bits reçus alors que plusieurs puces étaient sélectionnées hors diffusion
+};
+extern BusStats bus_stats;
+
+// Appelé à chaque écriture de broche (coût en ns compté si c'est une broche du bus)
+void bus_pinWrite(uint8_t pin, uint8_t level, uint32_t costNs);
+// Appelé à chaque transaction I2C terminée
+void bus_i2cTransaction(uint8_t address, const uint8_t* data, uint8_t length, uint64_t ns);
+
+// Image RAM d'une puce (chip 0..CHIP_MAX-1, adresse 0..127), au format de ht1632_shadowram
+uint8_t bus_chipRam(uint8_t chip, uint8_t address);
+// Couleur affichée d'un pixel (BLACK, GREEN, RED, ORANGE)
+uint8_t bus_pixel(uint8_t x, uint8_t y);
+// Dernier motif envoyé au registre 0x09 d'un expandeur 7 segments
+uint8_t bus_segments(uint8_t address);
+// Dessine l'écran en ASCII (. vert=g rouge=r orange=o)
+void bus_render(FILE* out);
+
+#endif // HOST_BUS_EMULATOR_H
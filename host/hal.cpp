@@ -0,0 +1,439 @@
+/*
+ * hal.cpp
+ * Implémentation hôte des fonctions Arduino utilisées par le jeu.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <TimerOne.h>
+#include <stdio.h>
+#include <deque>
+#include <avr/eeprom.h>
+#include "hal.h"
+#include "bus_emulator.h"
+
+HalCosts hal_costs = {
+  125,      // pinWriteNs : FastPin (sbi/cbi, 2 cycles)
+  3000,     // digitalReadNs
+  112000,   // analogReadNs
+  10000,    // loopNs
+  5000,     // isrEntryNs
+  3750,     // adcIsrNs : ~60 cycles (entrée, registres, somme de la conversion)
+  6000,     // adcSampleNs : ~95 cycles (anneau, deux comparaisons aux bornes des zones, publication)
+  100000,   // i2cClockHz : fréquence par défaut de Wire
+  5000      // serialWriteNs : ~80 cycles dans write(), autant dans l'interruption UDRE
+};
+
+uint64_t hal_nowNs = 0;
+unsigned long hal_timerTicks = 0;
+unsigned long hal_timerMissed = 0;
+uint64_t hal_isrNs = 0;
+int hal_adcNoise = 0;
+unsigned long hal_adcConversions = 0;
+uint64_t hal_adcIsrNs = 0;
+unsigned int hal_toneFrequency = 0;
+unsigned long hal_toneChanges = 0;
+bool hal_serialEcho = false;
+std::vector<uint8_t> hal_serialOut;
+uint64_t hal_serialBlockedNs = 0;
+uint8_t hal_eeprom[HAL_EEPROM_SIZE];
+unsigned long hal_eepromWrites = 0;
+uint32_t hal_eepromWear[HAL_EEPROM_SIZE];
+long hal_eepromCut = -1;
+bool hal_eepromPowerLost = false;
+
+HardwareSerial Serial;
+TwoWire Wire;
+TimerOne Timer1;
+
+static int pinLevels[32];
+static int analogValues[8];
+static std::deque<uint8_t> serialIn;
+static uint64_t serialByteNs = 0;       // 0 : Serial.begin() pas appelé, émission sans coût
+static uint64_t serialIdleNs = 0;       // fin d'émission du dernier octet
+
+static void (*timerIsr)() = 0;
+static uint64_t timerPeriodNs = 1000000000ULL;
+static uint64_t nextTickNs = 0;
+static bool timerRunning = false;
+static bool interruptsEnabled = true;
+static bool inIsr = false;
+static void (*adcIsr)(uint16_t) = 0;
+static uint8_t adcPin = 0;
+static uint64_t adcPeriodNs = 0;
+static uint64_t nextAdcNs = 0;
+static uint8_t adcBurst = 0;            // conversions par débordement du Timer1 (0 : cadence fixe)
+static uint8_t adcBurstLeft = 0;
+static uint8_t adcDecimation = 1;       // conversions par échantillon publié
+static uint8_t adcSummed = 0;           // conversions de l'échantillon en cours
+static uint32_t noiseState = 2463534242u;
+static uint64_t eepromReadyNs = 0;
+static long eepromIndex = 0;
+static bool eepromErased = false;
+static void (*pinChangeIsr)() = 0;
+static uint8_t pinChangePin = 0;
+static bool pinChangePending = false;
+
+// ===== TEMPS ET INTERRUPTIONS =====
+
+// Conversions ADC échues : une seule interruption en attente, comme le drapeau ADIF.
+// En rafale, chaque interruption lance la conversion suivante : elle finit une
+// conversion après l'entrée dans l'interruption
+static void pollAdc() {
+  if (!adcIsr || hal_nowNs < nextAdcNs) return;
+  if (adcBurst) {
+    if (!adcBurstLeft) return;
+    nextAdcNs = --adcBurstLeft ? hal_nowNs + adcPeriodNs : UINT64_MAX;
+  } else {
+    while (nextAdcNs + adcPeriodNs <= hal_nowNs) nextAdcNs += adcPeriodNs;
+    nextAdcNs += adcPeriodNs;
+  }
+  inIsr = true;
+  uint64_t start = hal_nowNs;
+  hal_nowNs += hal_costs.adcIsrNs;
+  if (++adcSummed >= adcDecimation) {
+    adcSummed = 0;
+    hal_nowNs += hal_costs.adcSampleNs;
+  }
+  hal_adcConversions++;
+  adcIsr((uint16_t)hal_adcSample(adcPin));
+  hal_adcIsrNs += hal_nowNs - start;
+  inIsr = false;
+}
+
+// Changement de broche en attente (drapeau PCIFx) : servi dès que les interruptions le permettent
+static void pollPinChange() {
+  if (!pinChangePending) return;
+  pinChangePending = false;
+  inIsr = true;
+  hal_nowNs += hal_costs.isrEntryNs;
+  pinChangeIsr();
+  inIsr = false;
+}
+
+static void pollInterrupts() {
+  if (inIsr || !interruptsEnabled) return;
+  pollPinChange();
+  pollAdc();
+  if (!timerIsr || !timerRunning || inIsr) return;
+  if (hal_nowNs < nextTickNs) return;
+
+  // Comme le drapeau TOV1 : une seule interruption reste en attente,
+  // les périodes supplémentaires sont perdues
+  uint64_t late = hal_nowNs - nextTickNs;
+  if (late >= timerPeriodNs) {
+    uint64_t lost = late / timerPeriodNs;
+    hal_timerMissed += lost;
+    nextTickNs += lost * timerPeriodNs;
+  }
+  nextTickNs += timerPeriodNs;
+
+  // Le débordement déclenche aussi la rafale de conversions ADC
+  if (adcBurst) {
+    adcBurstLeft = adcBurst;
+    nextAdcNs = nextTickNs - timerPeriodNs + adcPeriodNs;
+  }
+
+  inIsr = true;
+  uint64_t start = hal_nowNs;
+  hal_nowNs += hal_costs.isrEntryNs;
+  hal_timerTicks++;
+  timerIsr();
+  hal_isrNs += hal_nowNs - start;
+  inIsr = false;
+}
+
+void hal_advance(uint64_t ns) {
+  hal_nowNs += ns;
+  pollInterrupts();
+}
+
+void hal_noInterrupts() { interruptsEnabled = false; }
+
+void hal_interrupts() {
+  interruptsEnabled = true;
+  pollInterrupts();
+}
+
+unsigned long millis() { return (unsigned long)(hal_nowNs / 1000000ULL); }
+unsigned long micros() { return (unsigned long)(hal_nowNs / 1000ULL); }
+
+void delay(unsigned long ms) {
+  // Avancer par pas de 100 µs pour laisser passer les interruptions à l'heure
+  for (unsigned long i = 0; i < ms * 10; i++) hal_advance(100000);
+}
+
+void delayMicroseconds(unsigned int us) { hal_advance((uint64_t)us * 1000); }
+
+// ===== ENTRÉES / SORTIES =====
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (mode == INPUT_PULLUP && pin < 32) pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < 32) pinLevels[pin] = value ? HIGH : LOW;
+  bus_pinWrite(pin, value ? HIGH : LOW, hal_costs.pinWriteNs);
+  hal_advance(hal_costs.pinWriteNs);
+}
+
+int digitalRead(uint8_t pin) {
+  hal_advance(hal_costs.digitalReadNs);
+  return pin < 32 ? pinLevels[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+  hal_advance(hal_costs.analogReadNs);
+  if (pin >= A0) pin -= A0;
+  return pin < 8 ? analogValues[pin] : 0;
+}
+
+int hal_adcSample(uint8_t pin) {
+  if (pin >= A0) pin -= A0;
+  int value = pin < 8 ? analogValues[pin] : 0;
+  if (hal_adcNoise) {
+    // xorshift32 : bruit reproductible d'une exécution à l'autre
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    value += (int)(noiseState % (2 * hal_adcNoise + 1)) - hal_adcNoise;
+  }
+  return value < 0 ? 0 : value > 1023 ? 1023 : value;
+}
+
+void hal_adcAttach(uint8_t pin, double rate, uint8_t decimation, void (*isr)(uint16_t)) {
+  adcPin = pin;
+  adcDecimation = decimation;
+  adcSummed = 0;
+  adcPeriodNs = (uint64_t)(1e9 / rate);
+  nextAdcNs = hal_nowNs + adcPeriodNs;
+  adcBurst = 0;
+  adcIsr = isr;
+}
+
+void hal_adcAttachTimer1(uint8_t pin, uint8_t burst, void (*isr)(uint16_t)) {
+  adcPin = pin;
+  adcPeriodNs = HAL_ADC_CONVERSION_NS;
+  nextAdcNs = UINT64_MAX;
+  adcBurst = burst;
+  adcBurstLeft = 0;
+  adcDecimation = burst;
+  adcSummed = 0;
+  adcIsr = isr;
+}
+
+void hal_setAnalog(uint8_t pin, int value) {
+  if (pin >= A0) pin -= A0;
+  if (pin < 8) analogValues[pin] = value;
+}
+
+void hal_setInput(uint8_t pin, int level) {
+  if (pin >= 32 || pinLevels[pin] == level) return;
+  pinLevels[pin] = level;
+  if (pinChangeIsr && pin == pinChangePin) {
+    pinChangePending = true;
+    pollInterrupts();
+  }
+}
+
+void hal_pinChangeAttach(uint8_t pin, void (*isr)()) {
+  pinChangePin = pin;
+  pinChangeIsr = isr;
+}
+
+int hal_pinLevel(uint8_t pin) { return pin < 32 ? pinLevels[pin] : LOW; }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// ===== SON =====
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  (void)pin; (void)duration;
+  hal_toneFrequency = frequency;
+  hal_toneChanges++;
+  hal_advance(20000); // configuration du Timer2 par tone()
+}
+
+void noTone(uint8_t pin) {
+  (void)pin;
+  hal_toneFrequency = 0;
+  hal_toneChanges++;
+}
+
+// ===== EEPROM =====
+
+// EEPROM neuve au premier accès
+static void eepromErase() {
+  if (eepromErased) return;
+  memset(hal_eeprom, 0xFF, sizeof(hal_eeprom));
+  eepromErased = true;
+}
+
+void hal_eepromReset(bool erase) {
+  if (erase) {
+    memset(hal_eeprom, 0xFF, sizeof(hal_eeprom));
+    memset(hal_eepromWear, 0, sizeof(hal_eepromWear));
+  }
+  eepromErased = true;
+  eepromReadyNs = 0;
+  eepromIndex = 0;
+  hal_eepromPowerLost = false;
+}
+
+uint8_t eeprom_read_byte(const uint8_t* address) {
+  eepromErase();
+  uintptr_t a = (uintptr_t)address;
+  return a < HAL_EEPROM_SIZE ? hal_eeprom[a] : 0xFF;
+}
+
+bool eeprom_is_ready() { return hal_nowNs >= eepromReadyNs; }
+
+void eeprom_write_byte(uint8_t* address, uint8_t value) {
+  eepromErase();
+  while (!eeprom_is_ready()) hal_advance(eepromReadyNs - hal_nowNs < 100000 ? eepromReadyNs - hal_nowNs : 100000);
+  uintptr_t a = (uintptr_t)address;
+  hal_advance(500); // EEAR, EEDR, EEMPE, EEPE
+  eepromReadyNs = hal_nowNs + HAL_EEPROM_WRITE_NS;
+  if (hal_eepromPowerLost || a >= HAL_EEPROM_SIZE) return;
+  if (hal_eepromCut >= 0 && eepromIndex == hal_eepromCut) {
+    // Écriture interrompue : effacement et programmation à moitié faits
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    value = (uint8_t)noiseState;
+    hal_eepromPowerLost = true;
+  }
+  eepromIndex++;
+  hal_eeprom[a] = value;
+  hal_eepromWear[a]++;
+  hal_eepromWrites++;
+}
+
+// ===== TIMER1 =====
+
+void TimerOne::initialize(long microseconds) { setPeriod(microseconds); }
+
+void TimerOne::setPeriod(long microseconds) {
+  timerPeriodNs = (uint64_t)microseconds * 1000;
+  nextTickNs = hal_nowNs + timerPeriodNs;
+  timerRunning = true;
+}
+
+void TimerOne::attachInterrupt(void (*isr)()) { timerIsr = isr; }
+
+void TimerOne::attachInterrupt(void (*isr)(), long microseconds) {
+  setPeriod(microseconds);
+  timerIsr = isr;
+}
+
+void TimerOne::detachInterrupt() { timerIsr = 0; }
+void TimerOne::start() { nextTickNs = hal_nowNs + timerPeriodNs; timerRunning = true; }
+void TimerOne::stop() { timerRunning = false; }
+void TimerOne::restart() { start(); }
+void TimerOne::resume() { timerRunning = true; }
+
+// ===== I2C =====
+
+void TwoWire::begin() {}
+void TwoWire::setClock(unsigned long frequency) { hal_costs.i2cClockHz = frequency; }
+
+void TwoWire::beginTransmission(uint8_t address) {
+  address_ = address;
+  length_ = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (length_ >= sizeof(buffer_)) return 0;
+  buffer_[length_++] = data;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  // START + adresse + données, 9 bits par octet (ACK compris) + STOP
+  uint64_t bits = 1 + 9 * (uint64_t)(length_ + 1) + 1;
+  uint64_t ns = bits * 1000000000ULL / hal_costs.i2cClockHz;
+  bus_i2cTransaction(address_, buffer_, length_, ns);
+  // Wire attend la fin du transfert : les interruptions continuent pendant ce temps
+  for (uint64_t t = 0; t < ns; t += 10000) hal_advance(ns - t < 10000 ? ns - t : 10000);
+  return 0;
+}
+
+// ===== SERIAL =====
+
+void HardwareSerial::begin(unsigned long baud) { serialByteNs = baud ? 10000000000ULL / baud : 0; }
+
+// Octets encore dans le tampon d'émission (celui en cours de transmission compris)
+static uint64_t serialPending() {
+  if (!serialByteNs || serialIdleNs <= hal_nowNs) return 0;
+  return (serialIdleNs - hal_nowNs + serialByteNs - 1) / serialByteNs;
+}
+
+int HardwareSerial::availableForWrite() { return (int)(HAL_SERIAL_TX_BUFFER - 1 - serialPending()); }
+
+int HardwareSerial::available() { return (int)serialIn.size(); }
+
+int HardwareSerial::read() {
+  if (serialIn.empty()) return -1;
+  int c = serialIn.front();
+  serialIn.pop_front();
+  return c;
+}
+
+void hal_serialInject(const char* text) {
+  while (*text) serialIn.push_back((uint8_t)*text++);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (serialByteNs) {
+    uint64_t start = hal_nowNs;
+    while (serialPending() >= HAL_SERIAL_TX_BUFFER - 1) hal_advance(serialByteNs);
+    hal_serialBlockedNs += hal_nowNs - start;
+    serialIdleNs = (serialIdleNs > hal_nowNs ? serialIdleNs : hal_nowNs) + serialByteNs;
+    hal_advance(hal_costs.serialWriteNs);
+  }
+  hal_serialOut.push_back(c);
+  if (hal_serialEcho) putchar(c);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) write(buffer[i]);
+  return size;
+}
+
+size_t HardwareSerial::print(const char* s) {
+  size_t n = 0;
+  while (*s) n += write((uint8_t)*s++);
+  return n;
+}
+
+size_t HardwareSerial::print(char c) { return write((uint8_t)c); }
+
+size_t HardwareSerial::print(long n, int base) {
+  if (n < 0 && base == DEC) return print('-') + print((unsigned long)-n, base);
+  return print((unsigned long)n, base);
+}
+
+size_t HardwareSerial::print(unsigned long n, int base) {
+  char buffer[8 * sizeof(long) + 1];
+  char* p = &buffer[sizeof(buffer) - 1];
+  *p = 0;
+  if (base < 2) base = DEC;
+  do {
+    unsigned long digit = n % base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    n /= base;
+  } while (n);
+  return print(p);
+}
+
+size_t HardwareSerial::print(double n, int digits) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+  return print(buffer);
+}
+
+size_t HardwareSerial::println() { return print("\r\n"); }
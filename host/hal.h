@@ -0,0 +1,83 @@
+/*
+ * hal.h
+ * Commandes du matériel simulé, utilisées par le banc d'essai.
+ * Le temps est virtuel : chaque appel matériel (écriture de broche, ADC,
+ * transaction I2C, delay) le fait avancer de son coût réel estimé, et
+ * l'interruption Timer1 est déclenchée quand une période est franchie.
+ */
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <stdint.h>
+#include <vector>
+
+// Coûts en nanosecondes des opérations matérielles (ATmega328P à 16 MHz)
+struct HalCosts {
+  uint32_t pinWriteNs;     // écriture d'une broche (125 = sbi/cbi, ~3400 = digitalWrite)
+  uint32_t digitalReadNs;  // digitalRead()
+  uint32_t analogReadNs;   // analogRead() bloquant (13 cycles ADC à 125 kHz)
+  uint32_t loopNs;         // coût fixe d'une itération de loop()
+  uint32_t isrEntryNs;     // entrée + sortie d'interruption
+  uint32_t adcIsrNs;       // interruption ADC de pot.cpp, une conversion sommée (estimation)
+  uint32_t adcSampleNs;    // en plus, à la conversion qui publie l'échantillon décimé (estimation)
+  uint32_t i2cClockHz;     // fréquence du bus I2C
+  uint32_t serialWriteNs;  // Serial.write() d'un octet et son interruption UDRE
+};
+extern HalCosts hal_costs;
+
+// Temps simulé depuis le démarrage
+extern uint64_t hal_nowNs;
+// Fait avancer le temps et déclenche les interruptions échues
+void hal_advance(uint64_t ns);
+
+// Statistiques Timer1
+extern unsigned long hal_timerTicks;   // interruptions exécutées
+extern unsigned long hal_timerMissed;  // périodes perdues (interruption encore en cours)
+extern uint64_t hal_isrNs;             // temps passé dans l'interruption
+
+// Entrées
+void hal_setAnalog(uint8_t pin, int value);
+void hal_setInput(uint8_t pin, int level);
+int hal_pinLevel(uint8_t pin);
+// Interruption de changement de broche : isr() appelée quand hal_setInput() change le niveau
+void hal_pinChangeAttach(uint8_t pin, void (*isr)());
+
+// ADC en conversion automatique : isr(conversion) appelée "rate" fois par seconde sur la
+// voie "pin", tension simulée + bruit uniforme de ±hal_adcNoise LSB ; une conversion sur
+// "decimation" publie un échantillon (coût adcSampleNs en plus)
+void hal_adcAttach(uint8_t pin, double rate, uint8_t decimation, void (*isr)(uint16_t));
+// ADC déclenché par le débordement du Timer1 : rafale de "burst" conversions à la suite,
+// chacune lancée par l'interruption de la précédente ; la dernière publie l'échantillon
+#define HAL_ADC_CONVERSION_NS 104000ULL   // 13 cycles ADC à 125 kHz
+void hal_adcAttachTimer1(uint8_t pin, uint8_t burst, void (*isr)(uint16_t));
+int hal_adcSample(uint8_t pin);        // une conversion bruitée (sans coût)
+extern int hal_adcNoise;
+extern unsigned long hal_adcConversions;
+extern uint64_t hal_adcIsrNs;          // temps passé dans l'interruption ADC
+
+// Buzzer : fréquence en cours (0 = silence) et nombre de changements
+extern unsigned int hal_toneFrequency;
+extern unsigned long hal_toneChanges;
+
+// EEPROM : 1 Ko, effacée (0xFF) au démarrage, 3,4 ms par octet écrit
+#define HAL_EEPROM_SIZE 1024
+#define HAL_EEPROM_WRITE_NS 3400000ULL
+extern uint8_t hal_eeprom[HAL_EEPROM_SIZE];
+extern unsigned long hal_eepromWrites;   // octets écrits depuis le démarrage
+extern uint32_t hal_eepromWear[HAL_EEPROM_SIZE];   // écritures par octet
+// Coupure d'alimentation : l'écriture numéro hal_eepromCut (0 = la première après
+// hal_eepromReset) laisse une valeur quelconque dans son octet et les suivantes sont perdues
+extern long hal_eepromCut;               // -1 = pas de coupure
+extern bool hal_eepromPowerLost;
+void hal_eepromReset(bool erase);        // nouveau démarrage (erase : EEPROM neuve)
+
+// Serial : écho sur stdout, octets émis, octets à recevoir. Après Serial.begin(), chaque
+// octet occupe la ligne 10 bits au débit choisi ; tampon d'émission plein : write() attend
+#define HAL_SERIAL_TX_BUFFER 64
+extern bool hal_serialEcho;
+extern uint64_t hal_serialBlockedNs;   // temps passé à attendre de la place dans le tampon
+extern std::vector<uint8_t> hal_serialOut;
+void hal_serialInject(const char* text);
+
+#endif // HOST_HAL_H
@@ -0,0 +1,233 @@
+/*
+ * runner.cpp
+ * Simulation de masse sur l'hôte : le moteur du jeu (TROMBOSS/engine.cpp) seul, sans
+ * matériel simulé ni interruptions, joue des niveaux complets aussi vite que possible.
+ * C'est le même moteur que celui du firmware : ce qui est mesuré ici est ce que la carte
+ * ferait avec les mêmes entrées (le banc le vérifie en rejouant ses propres niveaux).
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -Ihost -o tromboss_runner host/runner.cpp TROMBOSS/engine.cpp
+ * Utilisation :
+ *   ./tromboss_runner [niveaux...] [--runs N] [--jitter MS] [--seed S]
+ *   --runs N     : parties par niveau (1000 par défaut)
+ *   --jitter MS  : retard aléatoire de 0 à MS ms de chaque appui du joueur simulé (40 par défaut)
+ *   --seed S     : graine du générateur (1 par défaut)
+ * Pour chaque niveau : N parties d'un joueur simulé dont les entrées sont enregistrées
+ * (score, victoires, jugement), puis le rejeu des N traces par engine_run(), qui doit redonner
+ * exactement les mêmes résultats. Débit de chaque phase en niveaux et en ticks par seconde
+ * de temps réel ; code de sortie 1 si un rejeu diffère.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "../TROMBOSS/engine.h"
+
+#define RUNNER_MAX_TICKS (600000000UL / TIMER_PERIOD)   // 10 minutes simulées au plus par niveau
+#define RUNNER_WIN_PERCENT 80                            // comme handleLevelState()
+
+// ===== JOUEUR SIMULÉ =====
+// Même stratégie que le pilote automatique du banc : viser le prochain bloc qui arrive sur les
+// colonnes vertes, appuyer quand il y est et que le curseur est aligné, relâcher après (dès que
+// sa queue a passé x=3 : le bloc suivant peut arriver dans la colonne d'après). Le curseur
+// visé ne change pas bouton enfoncé (le potentiomètre n'est lu que bouton relâché).
+
+struct Player {
+  uint32_t random;     // xorshift32
+  uint32_t jitterUs;
+  uint8_t aim;         // ligne visée
+  bool down;           // bouton enfoncé
+  bool waiting;        // appui décidé, pas encore fait
+  uint32_t pressAt;    // instant de l'appui décidé
+};
+
+static uint32_t playerRandom(Player* p) {
+  p->random ^= p->random << 13;
+  p->random ^= p->random >> 17;
+  p->random ^= p->random << 5;
+  return p->random;
+}
+
+// Entrées du tick à l'instant now : appui éventuel (engine_press), ligne visée et bouton
+static void playerTick(Engine* e, Player* p, uint32_t now, uint8_t* aim, bool* hit) {
+  int8_t target = -1;
+  BlockMask pending = e->blockActiveMask;
+  while (pending) {
+    uint8_t i = __builtin_ctzl(pending);
+    pending &= pending - 1;
+    if (e->blockX[i] + e->blockLength[i] <= CURSOR_COLUMN_START + 1) continue;
+    if (target < 0 || e->blockX[i] < e->blockX[target]) target = i;
+  }
+  bool pressedThisTick = false;
+  if (target < 0) {
+    p->down = false;
+    p->waiting = false;
+  } else {
+    int16_t x = e->blockX[target];
+    bool onGreen = x <= CURSOR_COLUMN_START + 1 && x + e->blockLength[target] > CURSOR_COLUMN_START;
+    bool press = onGreen && e->cursorY == e->blockY[target];
+    if (!p->down) p->aim = e->blockY[target];
+    if (press && !p->down && !p->waiting) {
+      // Décision prise pendant le tick précédent, appui retardé de 0..jitter
+      p->waiting = true;
+      p->pressAt = now - TIMER_PERIOD + playerRandom(p) % TIMER_PERIOD +
+                   (p->jitterUs ? playerRandom(p) % p->jitterUs : 0);
+    }
+    if (!press) {
+      p->down = false;
+      p->waiting = false;
+    }
+  }
+  if (p->waiting && (int32_t)(now - p->pressAt) >= 0) {
+    engine_press(e, p->pressAt);
+    p->waiting = false;
+    p->down = true;
+    pressedThisTick = true;
+  }
+  *aim = p->aim;
+  *hit = p->down || pressedThisTick;
+}
+
+// ===== PARTIES =====
+
+struct Result {
+  Score score;
+  Judgement judge;
+  uint32_t ticks;
+  bool finished;
+};
+
+static Result resultOf(const Engine* e, uint32_t ticks) {
+  Result r;
+  r.score = e->score;
+  r.judge = e->judge;
+  r.ticks = ticks;
+  r.finished = engine_finished(e);
+  return r;
+}
+
+static bool sameResult(const Result& a, const Result& b) {
+  return a.finished == b.finished && a.ticks == b.ticks && a.score.current == b.score.current &&
+         a.score.maxPossible == b.score.maxPossible && a.judge.perfect == b.judge.perfect &&
+         a.judge.good == b.judge.good && a.judge.miss == b.judge.miss;
+}
+
+// Un niveau complet joué par le joueur simulé, entrées enregistrées dans trace
+static Result playLevel(Engine* e, uint8_t level, uint32_t seed, uint32_t jitterUs, EngineTrace* trace) {
+  Player player = { seed ? seed : 1, jitterUs, 0, false, false, 0 };
+  e->trace = trace;
+  e->cursorY = 0;
+  engine_begin(e, level);
+  uint32_t now = 0;
+  uint32_t ticks = 0;
+  while (!engine_finished(e) && ticks < RUNNER_MAX_TICKS) {
+    now += TIMER_PERIOD;
+    uint8_t aim;
+    bool hit;
+    playerTick(e, &player, now, &aim, &hit);
+    engine_tick(e, now, aim, hit);
+    ticks++;
+  }
+  e->trace = NULL;
+  return resultOf(e, ticks);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  uint8_t levels[MAX_DIFFICULTY_LEVEL];
+  uint8_t levelCount = 0;
+  uint32_t runs = 1000;
+  uint32_t jitterUs = 40000;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--runs") && i + 1 < argc) runs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--jitter") && i + 1 < argc) jitterUs = atoi(argv[++i]) * 1000;
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = atoi(argv[++i]);
+    else {
+      int level = atoi(argv[i]);
+      if (level >= MIN_DIFFICULTY_LEVEL && level <= MAX_DIFFICULTY_LEVEL && levelCount < MAX_DIFFICULTY_LEVEL)
+        levels[levelCount++] = (uint8_t)level;
+    }
+  }
+  if (!levelCount) {
+    for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) levels[levelCount++] = level;
+  }
+  if (!runs) runs = 1;
+
+  printf("moteur seul : %u parties par niveau, appuis retardés de 0 à %u ms, graine %u, Engine %u octets\n",
+         runs, jitterUs / 1000, seed, (unsigned)sizeof(Engine));
+  std::vector<EngineTraceStep> steps;
+  std::vector<EngineTrace> traces(runs);
+  std::vector<Result> results(runs);
+  Engine engine;
+  memset(&engine, 0, sizeof(engine));
+  uint64_t totalLevels = 0, totalTicks = 0;
+  double totalPlay = 0, totalReplay = 0;
+  uint32_t mismatches = 0;
+
+  for (uint8_t l = 0; l < levelCount; l++) {
+    uint8_t level = levels[l];
+    // Traces de toutes les parties dans un seul tableau, place estimée par une partie sans
+    // capacité (toutes ses entrées comptées dans lost), avec de la marge pour les appuis
+    EngineTrace probe = { NULL, 0, 0, 0, 0, 0 };
+    playLevel(&engine, level, seed, jitterUs, &probe);
+    uint32_t perRun = probe.lost + probe.lost / 4 + 64;
+    steps.resize((size_t)perRun * runs);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t ticks = 0;
+    for (uint32_t r = 0; r < runs; r++) {
+      EngineTrace& trace = traces[r];
+      trace.steps = &steps[(size_t)r * perRun];
+      trace.capacity = perRun;
+      results[r] = playLevel(&engine, level, seed * 2654435761u + r * 40503u + level, jitterUs, &trace);
+      ticks += results[r].ticks;
+    }
+    double play = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    uint32_t same = 0;
+    for (uint32_t r = 0; r < runs; r++) {
+      uint32_t replayed = engine_run(&engine, &traces[r]);
+      if (!traces[r].lost && sameResult(results[r], resultOf(&engine, replayed))) same++;
+    }
+    double replay = secondsSince(start);
+
+    double percent = 0;
+    uint8_t low = 100, high = 0;
+    uint32_t wins = 0, unfinished = 0;
+    double perfect = 0, good = 0, miss = 0;
+    for (uint32_t r = 0; r < runs; r++) {
+      const Result& res = results[r];
+      percent += res.score.transformed;
+      if (res.score.transformed < low) low = res.score.transformed;
+      if (res.score.transformed > high) high = res.score.transformed;
+      if (!res.finished) unfinished++;
+      else if (res.score.transformed >= RUNNER_WIN_PERCENT) wins++;
+      perfect += res.judge.perfect;
+      good += res.judge.good;
+      miss += res.judge.miss;
+    }
+    printf("niveau %u : score moyen %.1f %% (min %u, max %u), victoires %u/%u, par partie %.1f parfaits, "
+           "%.1f bons, %.1f ratés, %.0f ticks%s\n", level, percent / runs, low, high, wins, runs,
+           perfect / runs, good / runs, miss / runs, (double)ticks / runs,
+           unfinished ? " (parties non terminées)" : "");
+    printf("  parties : %.0f niveaux/s (%.1f M ticks/s) ; rejeu des traces : %.0f niveaux/s, %u/%u identiques\n",
+           runs / play, ticks / play / 1e6, runs / replay, same, runs);
+    totalLevels += runs;
+    totalTicks += ticks;
+    totalPlay += play;
+    totalReplay += replay;
+    mismatches += runs - same;
+  }
+  printf("total : %llu niveaux, %llu ticks (%.1f h de jeu) ; parties %.0f niveaux/s, rejeux %.0f niveaux/s\n",
+         (unsigned long long)totalLevels, (unsigned long long)totalTicks,
+         totalTicks * (TIMER_PERIOD / 1e6) / 3600, totalLevels / totalPlay, totalLevels / totalReplay);
+  return mismatches ? 1 : 0;
+}
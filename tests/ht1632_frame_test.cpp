@@ -0,0 +1,161 @@
+/*
+ * ht1632_frame_test.cpp
+ * Test hôte du mode trame du pilote HT1632 (lib_magic.cpp) sur une couche de
+ * broches simulée (tests/stub) : les écritures de broches sont décodées
+ * (registre 74164 de sélection, ID, adresse, quartets) en images de RAM des
+ * quatre puces, comparées à ht1632_shadowram après chaque dessin.
+ * Vérifie aussi que ht1632_busbits compte exactement les impulsions vues sur
+ * le bus, et qu'une image du niveau coûte moins en trame qu'en écritures directes.
+ *
+ * Compilation et exécution (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -Wall -Wextra -Itests/stub -o ht1632_frame_test \
+ *       tests/ht1632_frame_test.cpp TROMBOSS/lib_magic.cpp TROMBOSS/seg7.cpp
+ *   ./ht1632_frame_test
+ * Code de sortie 1 si une vérification échoue.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "../TROMBOSS/ht1632.h"
+
+// ===== DÉCODEUR DU BUS =====
+enum { DEC_IDLE, DEC_ID, DEC_ADDRESS, DEC_DATA, DEC_OTHER };
+
+struct Chip {
+  uint8_t state, shift, count, address;
+  uint8_t ram[128];
+};
+
+static Chip chips[CHIP_MAX];
+static uint8_t shiftReg = 0;   // sorties Q du 74164 (1 = haut, CS actif bas)
+static uint8_t pinA = HIGH, pinClk = LOW, pinWr = HIGH, pinData = LOW;
+static unsigned long clocks = 0;   // fronts montants de WR et de l'horloge du 74164
+
+static bool selected(uint8_t c) { return !(shiftReg & (1 << c)); }
+
+static void clockChip(Chip& chip, uint8_t bit) {
+  chip.shift = (uint8_t)((chip.shift << 1) | bit);
+  chip.count++;
+  if (chip.state == DEC_ID && chip.count == 3) {
+    chip.state = chip.shift == HT1632_ID_WR ? DEC_ADDRESS : DEC_OTHER;
+    chip.shift = chip.count = 0;
+  } else if (chip.state == DEC_ADDRESS && chip.count == 7) {
+    chip.address = chip.shift & 0x7F;
+    chip.state = DEC_DATA;
+    chip.shift = chip.count = 0;
+  } else if (chip.state == DEC_DATA && chip.count == 4) {
+    // premier bit reçu en bit 3, comme dans ht1632_shadowram
+    chip.ram[chip.address] = chip.shift & 0x0F;
+    chip.address = (chip.address + 1) & 0x7F;
+    chip.shift = chip.count = 0;
+  }
+}
+
+void test_pinWrite(uint8_t pin, uint8_t level) {
+  if (pin == ht1632_cs) {
+    pinA = level;
+  } else if (pin == ht1632_clk) {
+    if (level && !pinClk) {
+      uint8_t before = shiftReg;
+      shiftReg = ((shiftReg << 1) | pinA) & ((1 << CHIP_MAX) - 1);
+      for (uint8_t c = 0; c < CHIP_MAX; c++) {
+        bool was = !(before & (1 << c));
+        if (!was && selected(c)) chips[c].state = DEC_ID, chips[c].shift = chips[c].count = 0;
+        if (was && !selected(c)) chips[c].state = DEC_IDLE;
+      }
+      clocks++;
+    }
+    pinClk = level;
+  } else if (pin == ht1632_wrclk) {
+    if (level && !pinWr) {
+      for (uint8_t c = 0; c < CHIP_MAX; c++)
+        if (selected(c) && chips[c].state != DEC_IDLE) clockChip(chips[c], pinData ? 1 : 0);
+      clocks++;
+    }
+    pinWr = level;
+  } else if (pin == ht1632_data) {
+    pinData = level;
+  }
+}
+
+// ===== VÉRIFICATIONS =====
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "ÉCHEC");
+  if (!ok) failures++;
+}
+
+static bool ramMatchesShadow() {
+  for (uint8_t c = 0; c < CHIP_MAX; c++)
+    for (uint8_t a = 0; a < 64; a++)
+      if (chips[c].ram[a] != ht1632_shadowram[a][c]) return false;
+  return true;
+}
+
+// Une image du niveau : 8 blocs de 2 pixels de haut avancent d'une colonne
+// (ancienne colonne de tête effacée, nouvelle dessinée), comme handleLevelLoop()
+static void levelFrame(uint8_t step, uint8_t color) {
+  for (uint8_t b = 0; b < 8; b++) {
+    uint8_t y = 1 + b * 2 - (b & 1);
+    uint8_t x = (uint8_t)(31 - step - b * 3) & 31;
+    for (uint8_t dy = 0; dy < 2; dy++) {
+      ht1632_plot((x + 4) & 31, y + dy, BLACK);
+      ht1632_plot(x, y + dy, color);
+    }
+  }
+}
+
+int main() {
+  ht1632_setup();
+  ht1632_clear();
+  printf("mode trame HT1632 :\n");
+  check(ramMatchesShadow(), "écran effacé : RAM des puces = shadowram");
+
+  // Écritures directes (sans trame), puis la même image en trame
+  unsigned long immediate = 0, framed = 0;
+  bool counted = true, same = true, deferred = true;
+  for (uint8_t step = 0; step < 16; step++) {
+    unsigned long bits = ht1632_busbits, seen = clocks;
+    levelFrame(step, step & 1 ? RED : GREEN);
+    immediate += ht1632_busbits - bits;
+    counted = counted && ht1632_busbits - bits == clocks - seen;
+    same = same && ramMatchesShadow();
+  }
+  check(same, "écritures directes : RAM des puces = shadowram");
+  ht1632_clear();
+  for (uint8_t step = 0; step < 16; step++) {
+    unsigned long bits = ht1632_busbits, seen = clocks;
+    ht1632_beginframe();
+    levelFrame(step, step & 1 ? RED : GREEN);
+    deferred = deferred && ht1632_busbits == bits;
+    ht1632_flush();
+    framed += ht1632_busbits - bits;
+    counted = counted && ht1632_busbits - bits == clocks - seen;
+    same = same && ramMatchesShadow();
+  }
+  check(deferred, "trames : rien n'est envoyé avant ht1632_flush()");
+  check(same, "trames : RAM des puces = shadowram après ht1632_flush()");
+  check(counted, "ht1632_busbits = impulsions décodées sur le bus");
+  printf("  16 images : %lu impulsions en écritures directes, %lu en trames\n", immediate, framed);
+  check(framed * 2 < immediate, "une trame coûte moins de la moitié des écritures directes");
+
+  // Rien de modifié : rien n'est envoyé
+  unsigned long bits = ht1632_busbits;
+  ht1632_beginframe();
+  ht1632_flush();
+  check(ht1632_busbits == bits, "trame vide : aucune impulsion");
+  ht1632_beginframe();
+  levelFrame(15, RED);   // mêmes pixels, mêmes couleurs que la dernière image
+  ht1632_flush();
+  check(ht1632_busbits == bits, "pixels redessinés à l'identique : aucune impulsion");
+
+  ht1632_clear();
+  bool cleared = ramMatchesShadow();
+  for (uint8_t c = 0; c < CHIP_MAX; c++)
+    for (uint8_t a = 0; a < 64; a++) cleared = cleared && !ht1632_shadowram[a][c];
+  check(cleared, "ht1632_clear() : shadowram et RAM des puces à zéro");
+
+  printf("%s\n", failures ? "ÉCHEC" : "tout est bon");
+  return failures ? 1 : 0;
+}
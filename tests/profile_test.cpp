@@ -0,0 +1,76 @@
+/*
+ * profile_test.cpp
+ * Test hôte des compteurs de profile.h sur le matériel simulé (host/) :
+ * une interruption Timer1 plus longue que sa période doit compter un
+ * dépassement et des périodes perdues, des interruptions courtes aucun,
+ * et les sections chronométrées dans l'interruption (PROF_ISR_BEGIN/END)
+ * doivent mesurer leur durée au-delà de quelques millisecondes.
+ *
+ * Compilation et exécution (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -Wall -Wextra -DPROFILING=1 -Ihost -o profile_test \
+ *       tests/profile_test.cpp TROMBOSS/profile.cpp host/hal.cpp host/bus_emulator.cpp
+ *   ./profile_test
+ * Code de sortie 1 si une vérification échoue.
+ */
+
+#include <Arduino.h>
+#include <TimerOne.h>
+#include <stdio.h>
+#include "hal.h"
+#include "../TROMBOSS/profile.h"
+
+#define PERIOD 25000UL   // µs, TIMER_PERIOD du jeu
+
+static unsigned long busyMicros = 0;   // durée de l'interruption simulée
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "ok  " : "ECHEC", what);
+  if (!ok) failures++;
+}
+
+// Interruption Timer1 : busyMicros de travail, mesurés comme une section du jeu
+static void periodic() {
+  PROF_TICK_SCOPE();
+  PROF_ISR_BEGIN(PROF_ENGINE);
+  delayMicroseconds(busyMicros);
+  PROF_ISR_END(PROF_ENGINE);
+}
+
+// Laisse passer "ticks" périodes de Timer1 avec des interruptions de busy µs
+static void run(unsigned long busy, unsigned ticks) {
+  busyMicros = busy;
+  prof_reset();
+  delay(ticks * PERIOD / 1000);
+}
+
+int main() {
+  prof_begin(PERIOD);
+  Timer1.initialize(PERIOD);
+  Timer1.attachInterrupt(periodic);
+
+  // Interruptions courtes : ni dépassement ni période perdue
+  run(2000, 40);
+  check(prof_sections[PROF_TICK].count >= 39, "interruptions courtes exécutées");
+  check(prof_overruns == 0, "interruptions courtes : aucun dépassement");
+  check(prof_missed == 0, "interruptions courtes : aucune période perdue");
+
+  // 10 ms dans l'interruption : bien plus que les ~2 ms d'un Timer0 figé
+  run(10000, 40);
+  ProfSection engine = prof_sections[PROF_ENGINE];
+  uint16_t expected = 10000 / (PROF_CYCLES_PER_TICK / 16);
+  check(engine.count > 0 && engine.min >= expected && engine.max <= expected + 1,
+        "section de 10 ms mesurée dans l'interruption");
+  check(prof_overruns == 0, "interruptions de 10 ms : aucun dépassement");
+
+  // 1,5 période dans l'interruption : chaque tick dépasse et une période sur deux est perdue
+  run(PERIOD * 3 / 2, 40);
+  unsigned long ticks = prof_sections[PROF_TICK].count;
+  check(ticks > 0 && prof_overruns == ticks, "interruptions trop longues : un dépassement par tick");
+  check((unsigned long)prof_sections[PROF_TICK].min * (PROF_CYCLES_PER_TICK / 16) > PERIOD,
+        "durée du tick au-delà de la période");
+  check(prof_missed > 0, "interruptions trop longues : périodes perdues");
+
+  printf("%s\n", failures ? "ÉCHEC" : "tout est bon");
+  return failures ? 1 : 0;
+}
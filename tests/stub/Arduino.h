@@ -0,0 +1,26 @@
+/*
+ * Arduino.h (stub des tests)
+ * Couche de broches minimale : les écritures de broches sont passées à
+ * test_pinWrite(), défini par le test, qui décode le bus.
+ */
+#ifndef TESTS_STUB_ARDUINO_H
+#define TESTS_STUB_ARDUINO_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t byte;
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+
+void test_pinWrite(uint8_t pin, uint8_t level);
+
+inline void digitalWrite(uint8_t pin, uint8_t level) { test_pinWrite(pin, level); }
+inline void pinMode(uint8_t, uint8_t) {}
+inline void delay(unsigned long) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#endif
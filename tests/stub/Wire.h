@@ -0,0 +1,18 @@
+/*
+ * Wire.h (stub des tests) : transactions I2C ignorées.
+ */
+#ifndef TESTS_STUB_WIRE_H
+#define TESTS_STUB_WIRE_H
+
+#include <stdint.h>
+
+struct TwoWire {
+  void begin() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t) {}
+  uint8_t write(uint8_t) { return 1; }
+  uint8_t endTransmission() { return 0; }
+};
+static TwoWire Wire;
+
+#endif
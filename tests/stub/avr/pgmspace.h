@@ -0,0 +1,10 @@
+/*
+ * avr/pgmspace.h (stub des tests) : PROGMEM en mémoire ordinaire.
+ */
+#ifndef TESTS_STUB_PGMSPACE_H
+#define TESTS_STUB_PGMSPACE_H
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+
+#endif
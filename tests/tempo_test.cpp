@@ -0,0 +1,112 @@
+/*
+ * tempo_test.cpp
+ * Test hôte de l'horloge musicale (tempoStart() / tempoAdvance(), engine.cpp) :
+ * la ligne de temps de chaque niveau tourne seule pendant une heure simulée, un
+ * tempoAdvance() par tick comme dans periodicFunction(). Chaque déplacement et
+ * chaque apparition de note doit tomber au premier tick à son instant exact ou
+ * après (jamais avant, moins d'un tick après), et l'écart ne doit pas dériver :
+ * pente des moindres carrés de l'écart en fonction du temps, multipliée par la
+ * durée simulée, sous TEMPO_TEST_DRIFT_US.
+ *
+ * Compilation et exécution (depuis la racine du dépôt) :
+ *   g++ -std=gnu++11 -O2 -Wall -Wextra -Ihost -o tempo_test \
+ *       tests/tempo_test.cpp TROMBOSS/engine.cpp
+ *   ./tempo_test [secondes]
+ * (-DTIMER_PERIOD=12500 : même test avec un tick de 12,5 ms.)
+ * Code de sortie 1 si une vérification échoue.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../TROMBOSS/engine.h"
+
+#define TEMPO_TEST_SECONDS 3600
+#define TEMPO_TEST_DRIFT_US 1000.0   // dérive tolérée sur toute la durée (1 ms)
+
+// Écarts (µs) d'une suite d'échéances : bornes et droite des moindres carrés
+struct Errors {
+  uint32_t count;
+  double min, max;
+  double sumT, sumE, sumTT, sumTE;
+};
+
+static void record(Errors& e, double ideal, double tick) {
+  double error = tick - ideal;
+  double t = ideal / 1e6;
+  if (!e.count || error < e.min) e.min = error;
+  if (!e.count || error > e.max) e.max = error;
+  e.count++;
+  e.sumT += t;
+  e.sumE += error;
+  e.sumTT += t * t;
+  e.sumTE += t * error;
+}
+
+// Dérive de l'écart sur "seconds" secondes (pente × durée), en µs
+static double drift(const Errors& e, double seconds) {
+  double n = e.count;
+  double den = n * e.sumTT - e.sumT * e.sumT;
+  if (e.count < 2 || den == 0) return 0;
+  return (n * e.sumTE - e.sumT * e.sumE) / den * seconds;
+}
+
+static int failures = 0;
+
+static void check(bool ok, uint8_t level, const char* what, const Errors& e, double seconds) {
+  if (ok) return;
+  printf("ECHEC niveau %u, %s : %u échéances, écart %.3f .. %.3f ms, dérive %.3f ms\n", level, what,
+         e.count, e.min / 1000, e.max / 1000, drift(e, seconds) / 1000);
+  failures++;
+}
+
+int main(int argc, char** argv) {
+  uint32_t seconds = argc > 1 ? (uint32_t)atol(argv[1]) : TEMPO_TEST_SECONDS;
+  double end = seconds * 1e6;
+  for (uint8_t level = MIN_DIFFICULTY_LEVEL; level <= MAX_DIFFICULTY_LEVEL; level++) {
+    Tempo tempo;
+    SongReader song;
+    tempo.bpm = engine_levelBpm(level);
+    tempo.column = engine_levelColumn(level);
+    tempoStart(&tempo);
+    songStart(&song, level);
+    double unitUs = 60e6 / (tempo.bpm * 8.0 * TEMPO_ONE);  // durée exacte d'une unité
+    Errors moves = {}, spawns = {};
+    uint32_t moveCount = 0;
+    uint64_t spawnUnits = 0;   // somme des durées des notes déjà apparues (unités)
+
+    // La note 0 est due au démarrage, avant le premier tick
+    for (uint64_t tick = 0; tick * TIMER_PERIOD <= end; tick++) {
+      if (tick) tempoAdvance(&tempo);
+      double now = (double)tick * TIMER_PERIOD;
+      while (TEMPO_DUE(&tempo, tempo.nextMove)) {
+        record(moves, ++moveCount * (double)tempo.column * unitUs, now);
+        tempo.nextMove += tempo.column;
+      }
+      while (TEMPO_DUE(&tempo, tempo.nextSpawn)) {
+        record(spawns, spawnUnits * unitUs, now);
+        // Chanson du niveau jouée en boucle
+        MusicNote note;
+        if (!songRead(&song, &note)) {
+          songStart(&song, level);
+          songRead(&song, &note);
+        }
+        spawnUnits += (uint32_t)note.duration << TEMPO_FRAC_BITS;
+        tempo.nextSpawn += (uint32_t)note.duration << TEMPO_FRAC_BITS;
+      }
+    }
+
+    // 1 ns de tolérance avant l'échéance : arrondi des doubles quand elle tombe pile sur un tick
+    check(moves.count > 0 && moves.min > -1e-3 && moves.max < TIMER_PERIOD, level,
+          "déplacements hors de [échéance, échéance + 1 tick]", moves, seconds);
+    check(spawns.count > 0 && spawns.min > -1e-3 && spawns.max < TIMER_PERIOD, level,
+          "apparitions hors de [échéance, échéance + 1 tick]", spawns, seconds);
+    check(fabs(drift(moves, seconds)) < TEMPO_TEST_DRIFT_US, level, "dérive des déplacements", moves, seconds);
+    check(fabs(drift(spawns, seconds)) < TEMPO_TEST_DRIFT_US, level, "dérive des apparitions", spawns, seconds);
+    printf("niveau %u : %u déplacements, %u notes, dérive %.3f / %.3f ms sur %u s\n", level, moves.count,
+           spawns.count, drift(moves, seconds) / 1000, drift(spawns, seconds) / 1000, seconds);
+  }
+  printf("%s\n", failures ? "ÉCHEC" : "tout est bon");
+  return failures ? 1 : 0;
+}
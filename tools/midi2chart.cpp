@@ -0,0 +1,555 @@
+/*
+ * midi2chart.cpp
+ * Compilateur de partitions : lit un fichier MIDI standard par niveau et écrit
+ * un en-tête d'événements d'apparition de blocs déjà calculés (tick, couloir,
+ * longueur, octave) pour les 9 niveaux × intro/verse/chorus/hook.
+ * Tout le travail fait jusqu'ici dans createNewBlock() à chaque note (couloir
+ * selon la fréquence, longueur selon la durée, conflits) est fait ici une fois.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=c++11 -O2 -o midi2chart tools/midi2chart.cpp
+ * Utilisation :
+ *   ./midi2chart --export-patterns midi/
+ *       écrit midi/level1.mid ... midi/level9.mid à partir de song_patterns.h
+ *       (une note tous les NOTE_CREATION_CYCLES ticks, comme le jeu actuel)
+ *   ./midi2chart [-o TROMBOSS/charts.h] [--pool N] niveau1.mid ... niveau9.mid
+ *       --pool N : taille du pool de blocs (MAX_BLOCKS, 32 par défaut) ;
+ *                  une partition qui le dépasse est refusée, et engine.cpp
+ *                  refuse de compiler si CHART_POOL (= N) dépasse MAX_BLOCKS
+ *
+ * Fichiers MIDI en entrée (format 0 ou 1, division en ticks par noire) :
+ * - les parties sont délimitées par des marqueurs (meta 0x06) "intro",
+ *   "verse", "chorus", "hook" ; les notes avant le premier marqueur vont dans l'intro
+ * - le canal 10 (percussions) est ignoré
+ * - couloir = note naturelle (do = ligne 0 ... si = ligne 12), une altération
+ *   est ramenée à la note naturelle inférieure ; octaves 4 à 9 du jeu, jouées
+ *   une octave au-dessus du fichier (note MIDI 48 = do 4, 119 = si 9)
+ * - longueur = durée en triples croches (32 = ronde), barème noteLengthFromDuration()
+ *
+ * Événement (16 bits) :
+ *   bits 15..13 couloir 0..6 (ligne 2 × couloir), 7 = attente
+ *   bits 12..10 longueur - 1
+ *   bits  9..7  octave - 4
+ *   bits  6..0  ticks de 25 ms depuis l'événement précédent
+ *   attente : bits 9..0 = ticks à attendre sans apparition
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Lecture de song_patterns.h sur PC (PROGMEM = mémoire ordinaire)
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#include "../TROMBOSS/song_patterns.h"
+
+// ===== CONSTANTES DU JEU (mêmes valeurs que definitions.h) =====
+static const int LEVELS = 9;
+static const int PARTS = 4;
+static const int TICK_US = 25000;                  // TIMER_PERIOD
+static const int MATRIX_WIDTH = 32;
+static const int LANES = 7;                        // lignes 0, 2, ..., 12
+static const int OCTAVE_MIN = 4;
+static const int OCTAVE_MAX = 9;
+// Le si 9 du buzzer (15804 Hz) dépasse la note MIDI 127 : le jeu joue une octave
+// au-dessus du fichier (note MIDI 60 = do 5, do 4 = 48)
+static const int MIDI_OCTAVE_SHIFT = 1;
+static const int BLOCK_MOVE_CYCLES[LEVELS] = {40, 35, 30, 25, 20, 15, 12, 10, 8};
+static const int NOTE_CREATION_CYCLES[LEVELS] = {60, 50, 42, 36, 30, 25, 20, 16, 12};
+static const char* const PART_NAMES[PARTS] = {"intro", "verse", "chorus", "hook"};
+
+// ===== FORMAT DES ÉVÉNEMENTS =====
+static const int WAIT_LANE = 7;
+static const int DELTA_MAX = 0x7F;
+static const int WAIT_MAX = 0x3FF;
+
+static uint16_t makeEvent(int lane, int length, int octave, int delta) {
+  return (uint16_t)((lane << 13) | ((length - 1) << 10) | ((octave - OCTAVE_MIN) << 7) | delta);
+}
+
+static uint16_t makeWait(int ticks) {
+  return (uint16_t)((WAIT_LANE << 13) | ticks);
+}
+
+// Note naturelle par classe de hauteur (do = 0) ; une altération descend d'un demi-ton
+static const int NATURAL_LANE[12] = {0, 0, 1, 1, 2, 3, 3, 4, 4, 5, 5, 6};
+static const bool IS_NATURAL[12] = {true, false, true, false, true, true, false, true, false, true, false, true};
+static const int NATURAL_PITCH[LANES] = {0, 2, 4, 5, 7, 9, 11};
+
+// ===== LECTURE MIDI =====
+
+struct MidiNote {
+  uint32_t tick;       // début en ticks MIDI
+  uint32_t length;     // durée en ticks MIDI
+  uint8_t pitch;
+  uint8_t channel;
+};
+
+struct MidiMarker {
+  uint32_t tick;
+  int part;
+};
+
+struct MidiTempo {
+  uint32_t tick;
+  uint32_t usPerQuarter;
+};
+
+struct MidiFile {
+  uint16_t ppq;
+  std::vector<MidiNote> notes;
+  std::vector<MidiMarker> markers;
+  std::vector<MidiTempo> tempos;
+};
+
+static bool fail(const char* path, const char* message) {
+  fprintf(stderr, "%s : %s\n", path, message);
+  return false;
+}
+
+static uint32_t readBE(const uint8_t* p, int bytes) {
+  uint32_t value = 0;
+  for (int i = 0; i < bytes; i++) value = (value << 8) | p[i];
+  return value;
+}
+
+static bool readVarLen(const uint8_t*& p, const uint8_t* end, uint32_t& value) {
+  value = 0;
+  for (int i = 0; i < 4; i++) {
+    if (p >= end) return false;
+    uint8_t b = *p++;
+    value = (value << 7) | (b & 0x7F);
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+static int partFromMarker(const std::string& text) {
+  for (int part = 0; part < PARTS; part++) {
+    size_t n = strlen(PART_NAMES[part]);
+    if (text.size() >= n && strncasecmp(text.c_str(), PART_NAMES[part], n) == 0) return part;
+  }
+  return -1;
+}
+
+static bool readTrack(const char* path, const uint8_t* p, const uint8_t* end, MidiFile& midi) {
+  uint32_t tick = 0;
+  uint8_t status = 0;
+  // notes en cours par (canal, hauteur) : débuts en attente de leur note off (FIFO)
+  std::vector<MidiNote> open;
+
+  while (p < end) {
+    uint32_t delta;
+    if (!readVarLen(p, end, delta)) return fail(path, "delta illisible");
+    tick += delta;
+    if (p >= end) return fail(path, "piste tronquée");
+
+    if (*p & 0x80) status = *p++;
+    else if (!status) return fail(path, "running status sans statut");
+
+    if (status == 0xFF) {
+      if (p >= end) return fail(path, "meta tronqué");
+      uint8_t type = *p++;
+      uint32_t length;
+      if (!readVarLen(p, end, length) || p + length > end) return fail(path, "meta tronqué");
+      if (type == 0x51 && length == 3) {
+        midi.tempos.push_back({tick, readBE(p, 3)});
+      } else if (type == 0x06 || type == 0x01) {
+        int part = partFromMarker(std::string((const char*)p, length));
+        if (part >= 0) midi.markers.push_back({tick, part});
+      } else if (type == 0x2F) {
+        break;
+      }
+      p += length;
+      status = 0;
+    } else if (status == 0xF0 || status == 0xF7) {
+      uint32_t length;
+      if (!readVarLen(p, end, length) || p + length > end) return fail(path, "sysex tronqué");
+      p += length;
+      status = 0;
+    } else {
+      uint8_t kind = status & 0xF0;
+      uint8_t channel = status & 0x0F;
+      int dataBytes = (kind == 0xC0 || kind == 0xD0) ? 1 : 2;
+      if (p + dataBytes > end) return fail(path, "événement tronqué");
+      uint8_t pitch = p[0];
+      uint8_t velocity = dataBytes > 1 ? p[1] : 0;
+      p += dataBytes;
+
+      if (kind == 0x90 && velocity > 0) {
+        open.push_back({tick, 0, pitch, channel});
+      } else if (kind == 0x80 || kind == 0x90) {
+        for (size_t i = 0; i < open.size(); i++) {
+          if (open[i].pitch == pitch && open[i].channel == channel) {
+            open[i].length = tick - open[i].tick;
+            midi.notes.push_back(open[i]);
+            open.erase(open.begin() + i);
+            break;
+          }
+        }
+      }
+    }
+  }
+  // notes jamais relâchées : durée nulle
+  for (size_t i = 0; i < open.size(); i++) midi.notes.push_back(open[i]);
+  return true;
+}
+
+static bool readMidi(const char* path, MidiFile& midi) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return fail(path, "ouverture impossible");
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.insert(data.end(), buffer, buffer + n);
+  fclose(f);
+
+  const uint8_t* p = data.data();
+  const uint8_t* end = p + data.size();
+  if (data.size() < 14 || memcmp(p, "MThd", 4) != 0) return fail(path, "pas un fichier MIDI");
+  uint32_t headerLength = readBE(p + 4, 4);
+  uint16_t format = readBE(p + 8, 2);
+  uint16_t tracks = readBE(p + 10, 2);
+  midi.ppq = readBE(p + 12, 2);
+  if (format > 1) return fail(path, "format MIDI 2 non géré");
+  if (midi.ppq & 0x8000) return fail(path, "division SMPTE non gérée");
+  p += 8 + headerLength;
+
+  for (uint16_t t = 0; t < tracks; t++) {
+    if (p + 8 > end || memcmp(p, "MTrk", 4) != 0) return fail(path, "piste manquante");
+    uint32_t length = readBE(p + 4, 4);
+    p += 8;
+    if (p + length > end) return fail(path, "piste tronquée");
+    if (!readTrack(path, p, p + length, midi)) return false;
+    p += length;
+  }
+
+  std::stable_sort(midi.tempos.begin(), midi.tempos.end(),
+                   [](const MidiTempo& a, const MidiTempo& b) { return a.tick < b.tick; });
+  std::stable_sort(midi.markers.begin(), midi.markers.end(),
+                   [](const MidiMarker& a, const MidiMarker& b) { return a.tick < b.tick; });
+  std::stable_sort(midi.notes.begin(), midi.notes.end(), [](const MidiNote& a, const MidiNote& b) {
+    return a.tick != b.tick ? a.tick < b.tick : a.pitch < b.pitch;
+  });
+  return true;
+}
+
+// Ticks MIDI -> microsecondes, avec la carte des tempos (120 bpm par défaut)
+static double midiTickToUs(const MidiFile& midi, uint32_t tick) {
+  double us = 0;
+  uint32_t lastTick = 0;
+  uint32_t usPerQuarter = 500000;
+  for (size_t i = 0; i < midi.tempos.size() && midi.tempos[i].tick <= tick; i++) {
+    us += (double)(midi.tempos[i].tick - lastTick) * usPerQuarter / midi.ppq;
+    lastTick = midi.tempos[i].tick;
+    usPerQuarter = midi.tempos[i].usPerQuarter;
+  }
+  return us + (double)(tick - lastTick) * usPerQuarter / midi.ppq;
+}
+
+// ===== COMPILATION D'UN NIVEAU =====
+
+struct LevelChart {
+  std::vector<uint16_t> parts[PARTS];
+  int notes;
+  int spawned;
+  int dropped;           // note chevauchant le bloc précédent
+  int accidentals;       // altérations ramenées à la note naturelle
+  int transposed;        // notes hors des octaves 4..9
+  int maxLive;           // blocs vivants au maximum
+  uint32_t lastTick;     // dernier événement (durée de la partition)
+};
+
+struct Spawn {
+  uint32_t tick;
+  int part;
+  int lane;
+  int length;
+  int octave;
+};
+
+static bool compileLevel(const char* path, int level, int pool, LevelChart& chart) {
+  MidiFile midi;
+  if (!readMidi(path, midi)) return false;
+
+  int moveCycles = BLOCK_MOVE_CYCLES[level];
+  chart = LevelChart();
+  std::vector<Spawn> spawns;
+  // dernier bloc retenu : tick d'apparition et longueur
+  long previousTick = -1;
+  int previousLength = 0;
+
+  size_t marker = 0;
+  int part = 0;
+  for (size_t i = 0; i < midi.notes.size(); i++) {
+    const MidiNote& note = midi.notes[i];
+    if (note.channel == 9) continue;
+    chart.notes++;
+    while (marker < midi.markers.size() && midi.markers[marker].tick <= note.tick) {
+      part = std::max(part, midi.markers[marker].part);   // les parties ne reviennent pas en arrière
+      marker++;
+    }
+
+    uint32_t tick = (uint32_t)(midiTickToUs(midi, note.tick) / TICK_US + 0.5);
+    int pitchClass = note.pitch % 12;
+    int lane = NATURAL_LANE[pitchClass];
+    if (!IS_NATURAL[pitchClass]) chart.accidentals++;
+    int octave = note.pitch / 12 + MIDI_OCTAVE_SHIFT;
+    if (octave < OCTAVE_MIN || octave > OCTAVE_MAX) {
+      chart.transposed++;
+      octave = std::min(std::max(octave, OCTAVE_MIN), OCTAVE_MAX);
+    }
+    int duration = (int)((note.length * 8 + midi.ppq / 2) / midi.ppq);   // triples croches
+    int length = noteLengthFromDuration(std::min(duration, NOTE_MAX_DURATION));
+
+    // Un seul bloc par colonne (le curseur ne joue qu'une note à la fois, cf. isColumnOccupied()) :
+    // le bloc précédent doit être entièrement entré, plus une colonne d'écart, quelle que soit
+    // la phase des déplacements (déplacements garantis = ticks / moveCycles)
+    if (previousTick >= 0 && (long)(tick - previousTick) / moveCycles < previousLength + 1) {
+      chart.dropped++;
+      continue;
+    }
+    previousTick = tick;
+    previousLength = length;
+    spawns.push_back({tick, part, lane, length, octave});
+  }
+
+  // Blocs vivants : de l'apparition en x = 32 jusqu'à x + longueur < -1
+  // (34 + longueur déplacements, plus un déplacement de phase au pire)
+  std::vector<std::pair<uint32_t, int> > edges;
+  for (size_t i = 0; i < spawns.size(); i++) {
+    uint32_t life = (uint32_t)(MATRIX_WIDTH + 2 + spawns[i].length + 1) * moveCycles;
+    edges.push_back(std::make_pair(spawns[i].tick, 1));
+    edges.push_back(std::make_pair(spawns[i].tick + life, -1));
+  }
+  std::sort(edges.begin(), edges.end());   // à tick égal, les sorties (-1) passent avant
+  int live = 0;
+  for (size_t i = 0; i < edges.size(); i++) {
+    live += edges[i].second;
+    if (live > chart.maxLive) chart.maxLive = live;
+    if (live > pool) {
+      fprintf(stderr, "%s : %d blocs vivants à %.2f s, le pool n'en a que %d\n", path, live,
+              edges[i].first * (TICK_US / 1e6), pool);
+      return false;
+    }
+  }
+
+  // Encodage : écart en ticks avec l'événement précédent, attentes pour les longs silences
+  uint32_t previous = 0;
+  for (size_t i = 0; i < spawns.size(); i++) {
+    std::vector<uint16_t>& events = chart.parts[spawns[i].part];
+    uint32_t delta = spawns[i].tick - previous;
+    while (delta > (uint32_t)DELTA_MAX) {
+      uint32_t wait = std::min(delta, (uint32_t)WAIT_MAX);
+      events.push_back(makeWait(wait));
+      delta -= wait;
+    }
+    events.push_back(makeEvent(spawns[i].lane, spawns[i].length, spawns[i].octave, delta));
+    previous = spawns[i].tick;
+  }
+  chart.spawned = (int)spawns.size();
+  chart.lastTick = previous;
+  return true;
+}
+
+// ===== ÉCRITURE DE L'EN-TÊTE =====
+
+static bool writeHeader(const char* path, const LevelChart* charts, int pool) {
+  FILE* f = fopen(path, "w");
+  if (!f) return fail(path, "écriture impossible");
+  fprintf(f, "/*\n"
+             " * charts.h\n"
+             " * Partitions précalculées - généré par tools/midi2chart, ne pas modifier à la main.\n"
+             " * Un événement par bloc (16 bits) :\n"
+             " *   bits 15..13 couloir 0..6 (ligne 2 x couloir), 7 = attente\n"
+             " *   bits 12..10 longueur - 1, bits 9..7 octave - 4\n"
+             " *   bits  6..0  ticks de 25 ms depuis l'événement précédent\n"
+             " *   attente : bits 9..0 = ticks sans apparition\n"
+             " * Pool vérifié : %d blocs (CHART_POOL, au plus MAX_BLOCKS).\n"
+             " */\n\n"
+             "#ifndef CHARTS_H\n#define CHARTS_H\n\n"
+             "#define CHART_LEVELS %d\n"
+             "#define CHART_PARTS %d\n"
+             "#define CHART_POOL %d\n"
+             "#define CHART_WAIT_LANE 7\n"
+             "#define CHART_LANE(e) ((e) >> 13)\n"
+             "#define CHART_LENGTH(e) ((((e) >> 10) & 0x07) + 1)\n"
+             "#define CHART_OCTAVE(e) (((e) >> 7) & 0x07)\n"
+             "#define CHART_DELTA(e) ((e) & 0x7F)\n"
+             "#define CHART_WAIT_TICKS(e) ((e) & 0x3FF)\n\n",
+          pool, LEVELS, PARTS, pool);
+
+  fprintf(f, "const PROGMEM uint16_t chart_empty[] = {0};\n\n");
+  for (int level = 0; level < LEVELS; level++) {
+    for (int part = 0; part < PARTS; part++) {
+      const std::vector<uint16_t>& events = charts[level].parts[part];
+      if (events.empty()) continue;
+      fprintf(f, "const PROGMEM uint16_t chart_level%d_%s[] = {", level + 1, PART_NAMES[part]);
+      for (size_t i = 0; i < events.size(); i++) {
+        fprintf(f, "%s0x%04X%s", i % 8 ? " " : "\n    ", events[i], i + 1 < events.size() ? "," : "");
+      }
+      fprintf(f, "\n};\n\n");
+    }
+  }
+
+  fprintf(f, "const uint16_t* const chartParts[CHART_LEVELS][CHART_PARTS] PROGMEM = {\n");
+  for (int level = 0; level < LEVELS; level++) {
+    fprintf(f, "    {");
+    for (int part = 0; part < PARTS; part++) {
+      if (charts[level].parts[part].empty()) fprintf(f, "chart_empty");
+      else fprintf(f, "chart_level%d_%s", level + 1, PART_NAMES[part]);
+      fprintf(f, "%s", part + 1 < PARTS ? ", " : "");
+    }
+    fprintf(f, "}%s\n", level + 1 < LEVELS ? "," : "");
+  }
+  fprintf(f, "};\n\n");
+
+  fprintf(f, "const uint16_t chartSizes[CHART_LEVELS][CHART_PARTS] PROGMEM = {\n");
+  for (int level = 0; level < LEVELS; level++) {
+    fprintf(f, "    {");
+    for (int part = 0; part < PARTS; part++) {
+      fprintf(f, "%u%s", (unsigned)charts[level].parts[part].size(), part + 1 < PARTS ? ", " : "");
+    }
+    fprintf(f, "}%s\n", level + 1 < LEVELS ? "," : "");
+  }
+  fprintf(f, "};\n\n#endif // CHARTS_H\n");
+  fclose(f);
+  return true;
+}
+
+// ===== EXPORT DE song_patterns.h EN MIDI =====
+
+struct PatternPart {
+  const MusicNote* notes;
+  uint8_t size;
+};
+
+static const PatternPart PATTERNS[LEVELS][PARTS] = {
+  {{level1_intro, LEVEL1_INTRO_SIZE}, {level1_verse, LEVEL1_VERSE_SIZE}, {level1_chorus, LEVEL1_CHORUS_SIZE}, {level1_hook, LEVEL1_HOOK_SIZE}},
+  {{level2_intro, LEVEL2_INTRO_SIZE}, {level2_verse, LEVEL2_VERSE_SIZE}, {level2_chorus, LEVEL2_CHORUS_SIZE}, {level2_hook, LEVEL2_HOOK_SIZE}},
+  {{level3_intro, LEVEL3_INTRO_SIZE}, {level3_verse, LEVEL3_VERSE_SIZE}, {level3_chorus, LEVEL3_CHORUS_SIZE}, {level3_hook, LEVEL3_HOOK_SIZE}},
+  {{level4_intro, LEVEL4_INTRO_SIZE}, {level4_verse, LEVEL4_VERSE_SIZE}, {level4_chorus, LEVEL4_CHORUS_SIZE}, {level4_hook, LEVEL4_HOOK_SIZE}},
+  {{level5_intro, LEVEL5_INTRO_SIZE}, {level5_verse, LEVEL5_VERSE_SIZE}, {level5_chorus, LEVEL5_CHORUS_SIZE}, {level5_hook, LEVEL5_HOOK_SIZE}},
+  {{level6_intro, LEVEL6_INTRO_SIZE}, {level6_verse, LEVEL6_VERSE_SIZE}, {level6_chorus, LEVEL6_CHORUS_SIZE}, {level6_hook, LEVEL6_HOOK_SIZE}},
+  {{level7_intro, LEVEL7_INTRO_SIZE}, {level7_verse, LEVEL7_VERSE_SIZE}, {level7_chorus, LEVEL7_CHORUS_SIZE}, {level7_hook, LEVEL7_HOOK_SIZE}},
+  {{level8_intro, LEVEL8_INTRO_SIZE}, {level8_verse, LEVEL8_VERSE_SIZE}, {level8_chorus, LEVEL8_CHORUS_SIZE}, {level8_hook, LEVEL8_HOOK_SIZE}},
+  {{level9_intro, LEVEL9_INTRO_SIZE}, {level9_verse, LEVEL9_VERSE_SIZE}, {level9_chorus, LEVEL9_CHORUS_SIZE}, {level9_hook, LEVEL9_HOOK_SIZE}},
+};
+
+static const uint16_t EXPORT_PPQ = 480;            // 120 bpm : 25 ms = 24 ticks MIDI
+
+static void putVarLen(std::vector<uint8_t>& out, uint32_t value) {
+  uint8_t bytes[4];
+  int n = 0;
+  do {
+    bytes[n++] = value & 0x7F;
+    value >>= 7;
+  } while (value);
+  while (n--) out.push_back(bytes[n] | (n ? 0x80 : 0));
+}
+
+// Hauteur MIDI d'une note de song_patterns.h (index = (octave - 4) * 7 + couloir)
+static uint8_t pitchFromNote(uint8_t note) {
+  int octave = OCTAVE_MIN + note / LANES;
+  return (uint8_t)(12 * (octave - MIDI_OCTAVE_SHIFT) + NATURAL_PITCH[note % LANES]);
+}
+
+static bool exportPatterns(const char* dir) {
+  for (int level = 0; level < LEVELS; level++) {
+    // (tick, ordre, octets) : à tick égal, note off (0) avant marqueur (1) avant note on (2)
+    struct Event { uint32_t tick; int order; std::vector<uint8_t> bytes; };
+    std::vector<Event> events;
+    uint32_t step = NOTE_CREATION_CYCLES[level] * TICK_US / 1000 * EXPORT_PPQ / 500;
+    uint32_t index = 0;
+    for (int part = 0; part < PARTS; part++) {
+      std::vector<uint8_t> marker = {0xFF, 0x06, (uint8_t)strlen(PART_NAMES[part])};
+      marker.insert(marker.end(), PART_NAMES[part], PART_NAMES[part] + strlen(PART_NAMES[part]));
+      events.push_back({index * step, 1, marker});
+      for (uint8_t i = 0; i < PATTERNS[level][part].size; i++, index++) {
+        MusicNote note;
+        getNote(PATTERNS[level][part].notes, i, &note);
+        uint8_t pitch = pitchFromNote(note.note);
+        uint8_t channel = index % 8;               // évite les chevauchements sur une même hauteur
+        uint32_t start = index * step;
+        uint32_t length = note.duration * EXPORT_PPQ / 8;
+        events.push_back({start, 2, {(uint8_t)(0x90 | channel), pitch, 100}});
+        events.push_back({start + length, 0, {(uint8_t)(0x80 | channel), pitch, 0}});
+      }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+      return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+    });
+
+    std::vector<uint8_t> track = {0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20};   // 500000 µs par noire
+    uint32_t last = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+      putVarLen(track, events[i].tick - last);
+      track.insert(track.end(), events[i].bytes.begin(), events[i].bytes.end());
+      last = events[i].tick;
+    }
+    track.insert(track.end(), {0x00, 0xFF, 0x2F, 0x00});
+
+    std::string path = std::string(dir) + "/level" + std::to_string(level + 1) + ".mid";
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return fail(path.c_str(), "écriture impossible");
+    const uint8_t header[] = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1,
+                              (uint8_t)(EXPORT_PPQ >> 8), (uint8_t)EXPORT_PPQ,
+                              'M', 'T', 'r', 'k',
+                              (uint8_t)(track.size() >> 24), (uint8_t)(track.size() >> 16),
+                              (uint8_t)(track.size() >> 8), (uint8_t)track.size()};
+    fwrite(header, 1, sizeof(header), f);
+    fwrite(track.data(), 1, track.size(), f);
+    fclose(f);
+    printf("%s : %u notes\n", path.c_str(), index);
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* output = "TROMBOSS/charts.h";
+  int pool = 32;
+  std::vector<const char*> inputs;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--export-patterns") && i + 1 < argc) return exportPatterns(argv[++i]) ? 0 : 1;
+    else if (!strcmp(argv[i], "-o") && i + 1 < argc) output = argv[++i];
+    else if (!strcmp(argv[i], "--pool") && i + 1 < argc) pool = atoi(argv[++i]);
+    else inputs.push_back(argv[i]);
+  }
+  if (inputs.size() != LEVELS) {
+    fprintf(stderr, "usage : %s [-o charts.h] [--pool N] niveau1.mid ... niveau9.mid\n"
+                    "        %s --export-patterns dossier/\n", argv[0], argv[0]);
+    return 1;
+  }
+
+  static LevelChart charts[LEVELS];
+  for (int level = 0; level < LEVELS; level++) {
+    if (!compileLevel(inputs[level], level, pool, charts[level])) return 1;
+  }
+  if (!writeHeader(output, charts, pool)) return 1;
+
+  // Rapport : place en flash par niveau, comparée aux tableaux MusicNote
+  printf("%-7s %6s %6s %8s %8s %8s %8s %9s %10s\n", "niveau", "notes", "blocs", "écartées",
+         "altérées", "vivants", "durée s", "flash o", "MusicNote");
+  size_t total = 0, totalPatterns = 0;
+  for (int level = 0; level < LEVELS; level++) {
+    const LevelChart& c = charts[level];
+    size_t bytes = 0, patternBytes = 0;
+    for (int part = 0; part < PARTS; part++) {
+      bytes += c.parts[part].size() * sizeof(uint16_t);
+      patternBytes += PATTERNS[level][part].size * sizeof(MusicNote);
+    }
+    total += bytes;
+    totalPatterns += patternBytes;
+    printf("%-7d %6d %6d %8d %8d %8d %8.1f %9zu %10zu\n", level + 1, c.notes, c.spawned, c.dropped,
+           c.accidentals + c.transposed, c.maxLive, c.lastTick * (TICK_US / 1e6), bytes, patternBytes);
+  }
+  printf("total %zu octets de partitions (+ tables %zu octets), song_patterns.h : %zu octets\n", total,
+         (size_t)LEVELS * PARTS * (sizeof(uint16_t) * 2), totalPatterns);
+  printf("écrit %s\n", output);
+  return 0;
+}
@@ -0,0 +1,420 @@
+/*
+ * songpack.cpp
+ * Compresseur de chansons : lit song_patterns.h (9 niveaux × intro/verse/chorus/hook)
+ * et écrit TROMBOSS/song_data.h, lu par nextNote() :
+ * - un dictionnaire de phrases partagé par tous les niveaux, un octet par note
+ *   (index de note + code de durée) au lieu des 2 octets de MusicNote ;
+ * - une table de sections par niveau : phrase, transposition, répétitions ;
+ * - une table de durées par niveau (6 codes au plus).
+ * Une phrase qui revient, à l'identique ou transposée, n'est stockée qu'une
+ * fois ; une phrase jouée plusieurs fois de suite coûte une seule section.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=c++11 -O2 -o songpack tools/songpack.cpp
+ * Utilisation :
+ *   ./songpack [-o TROMBOSS/song_data.h] [--min N]
+ *       --min N : longueur minimale d'une phrase partagée (3 par défaut)
+ *   Le rapport donne, par niveau, les notes, les sections et la place en flash,
+ *   puis le taux de compression par rapport aux tableaux MusicNote.
+ *
+ * Octet de note : code × NOTE_COUNT + note (note 0..41, code 0..5, 252 valeurs) ;
+ * la durée est songDurations[niveau][code]. Une phrase partagée par deux
+ * niveaux est jouée avec les durées de chacun.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+// Lecture de song_patterns.h sur PC (PROGMEM = mémoire ordinaire)
+#define PROGMEM
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#include "../TROMBOSS/song_patterns.h"
+
+// ===== FORMAT (mêmes valeurs que song_data.h) =====
+static const int LEVELS = 9;
+static const int PARTS = 4;
+static const int CODES = 6;                        // 6 × NOTE_COUNT = 252 <= 255
+static const int SECTION_BYTES = 3;                // phrase, transposition, répétitions
+static const int MAX_PHRASES = 255;                // index de phrase sur 8 bits
+static const int MAX_REPEAT = 255;
+static const int MAX_PHRASE_LENGTH = 64;           // recherche des phrases partagées
+
+static_assert(CODES * NOTE_COUNT <= 256, "un octet par note");
+
+struct PatternPart {
+  const MusicNote* notes;
+  size_t size;
+};
+
+#define PATTERN_PART(n, part) { level##n##_##part, PATTERN_SIZE(level##n##_##part) }
+#define PATTERN_LEVEL(n) { PATTERN_PART(n, intro), PATTERN_PART(n, verse), PATTERN_PART(n, chorus), PATTERN_PART(n, hook) }
+static const PatternPart PATTERNS[LEVELS][PARTS] = {
+  PATTERN_LEVEL(1), PATTERN_LEVEL(2), PATTERN_LEVEL(3), PATTERN_LEVEL(4), PATTERN_LEVEL(5),
+  PATTERN_LEVEL(6), PATTERN_LEVEL(7), PATTERN_LEVEL(8), PATTERN_LEVEL(9)
+};
+#undef PATTERN_PART
+#undef PATTERN_LEVEL
+
+// Tableaux lus par l'ancien nextNote() : les 36 des niveaux et les 4 de secours
+static const size_t FALLBACK_NOTES = INTRO_SIZE + VERSE_SIZE + CHORUS_SIZE + HOOK_SIZE;
+
+// ===== CHANSONS À COMPRESSER =====
+
+struct Level {
+  std::vector<uint8_t> durations;                  // code -> durée
+  std::vector<uint8_t> notes;                      // index de note
+  std::vector<uint8_t> codes;                      // code de durée
+};
+
+static bool readLevels(Level* levels) {
+  for (int level = 0; level < LEVELS; level++) {
+    Level& l = levels[level];
+    for (int part = 0; part < PARTS; part++) {
+      for (size_t i = 0; i < PATTERNS[level][part].size; i++) {
+        MusicNote note;
+        getNote(PATTERNS[level][part].notes, i, &note);
+        std::vector<uint8_t>::iterator code = std::find(l.durations.begin(), l.durations.end(), note.duration);
+        if (code == l.durations.end()) {
+          if ((int)l.durations.size() >= CODES) {
+            fprintf(stderr, "niveau %d : plus de %d durées différentes\n", level + 1, CODES);
+            return false;
+          }
+          code = l.durations.insert(l.durations.end(), note.duration);
+        }
+        l.notes.push_back(note.note);
+        l.codes.push_back((uint8_t)(code - l.durations.begin()));
+      }
+    }
+  }
+  return true;
+}
+
+// ===== DÉCOUPAGE EN PHRASES =====
+// Chaque note d'un niveau appartient à une occurrence de phrase partagée, ou à un
+// passage unique (phrase utilisée une seule fois). On ajoute, tant que la place
+// totale diminue, la phrase partagée qui en fait gagner le plus.
+
+struct Occurrence {
+  int level;
+  size_t start;
+  int phrase;                                      // dans shared
+};
+
+struct Packing {
+  std::vector<std::vector<uint8_t> > shared;       // phrases partagées (octets, transposition 0)
+  std::vector<Occurrence> occurrences;
+};
+
+struct Section {
+  int phrase;
+  int transpose;
+  int repeat;
+};
+
+struct Packed {
+  std::vector<uint8_t> bytes;                      // dictionnaire
+  std::vector<uint16_t> phraseStart;               // début de chaque phrase, + fin
+  std::vector<Section> sections;
+  std::vector<uint16_t> levelStart;                // première section de chaque niveau, + fin
+  size_t sharedNotes[LEVELS];                      // notes jouées depuis une phrase partagée
+};
+
+static uint8_t noteByte(const Level& l, size_t i) {
+  return (uint8_t)(l.codes[i] * NOTE_COUNT + l.notes[i]);
+}
+
+// Ajoute une phrase au dictionnaire (réutilise une phrase identique) ; renvoie son index
+static int addPhrase(Packed& p, std::map<std::vector<uint8_t>, int>& index, const std::vector<uint8_t>& bytes) {
+  std::map<std::vector<uint8_t>, int>::iterator it = index.find(bytes);
+  if (it != index.end()) return it->second;
+  int phrase = (int)p.phraseStart.size() - 1;
+  p.bytes.insert(p.bytes.end(), bytes.begin(), bytes.end());
+  p.phraseStart.push_back((uint16_t)p.bytes.size());
+  index[bytes] = phrase;
+  return phrase;
+}
+
+static void addSection(Packed& p, int phrase, int transpose) {
+  if (!p.sections.empty() && p.sections.size() > p.levelStart.back()) {
+    Section& last = p.sections.back();
+    if (last.phrase == phrase && last.transpose == transpose && last.repeat < MAX_REPEAT) {
+      last.repeat++;
+      return;
+    }
+  }
+  p.sections.push_back({phrase, transpose, 1});
+}
+
+// Dictionnaire et sections d'un découpage
+static Packed pack(const Level* levels, const Packing& packing) {
+  Packed p;
+  std::map<std::vector<uint8_t>, int> index;
+  p.phraseStart.push_back(0);
+  std::vector<int> sharedIndex;
+  for (size_t s = 0; s < packing.shared.size(); s++) sharedIndex.push_back(addPhrase(p, index, packing.shared[s]));
+
+  for (int level = 0; level < LEVELS; level++) {
+    const Level& l = levels[level];
+    p.levelStart.push_back((uint16_t)p.sections.size());
+    p.sharedNotes[level] = 0;
+    std::vector<const Occurrence*> owned;
+    for (size_t o = 0; o < packing.occurrences.size(); o++) {
+      if (packing.occurrences[o].level == level) owned.push_back(&packing.occurrences[o]);
+    }
+    std::sort(owned.begin(), owned.end(), [](const Occurrence* a, const Occurrence* b) { return a->start < b->start; });
+
+    size_t i = 0, next = 0;
+    while (i < l.notes.size()) {
+      if (next < owned.size() && owned[next]->start == i) {
+        const std::vector<uint8_t>& bytes = packing.shared[owned[next]->phrase];
+        int transpose = (int)l.notes[i] - bytes[0] % NOTE_COUNT;
+        addSection(p, sharedIndex[owned[next]->phrase], transpose);
+        p.sharedNotes[level] += bytes.size();
+        i += bytes.size();
+        next++;
+        continue;
+      }
+      // Passage unique jusqu'à la prochaine occurrence, stocké sans transposition
+      size_t end = next < owned.size() ? owned[next]->start : l.notes.size();
+      std::vector<uint8_t> bytes;
+      for (size_t j = i; j < end; j++) bytes.push_back(noteByte(l, j));
+      addSection(p, addPhrase(p, index, bytes), 0);
+      i = end;
+    }
+  }
+  p.levelStart.push_back((uint16_t)p.sections.size());
+  return p;
+}
+
+static size_t packedBytes(const Packed& p) {
+  return p.bytes.size() + p.phraseStart.size() * sizeof(uint16_t) + p.sections.size() * SECTION_BYTES +
+         p.levelStart.size() * sizeof(uint16_t) + LEVELS * CODES;
+}
+
+// Clé d'une fenêtre indépendante de la transposition : code et intervalle depuis la première note
+static std::vector<uint8_t> windowKey(const Level& l, size_t start, size_t length) {
+  std::vector<uint8_t> key;
+  for (size_t j = start; j < start + length; j++) {
+    key.push_back(l.codes[j]);
+    key.push_back((uint8_t)(l.notes[j] - l.notes[start] + NOTE_COUNT));
+  }
+  return key;
+}
+
+static bool packSongs(const Level* levels, size_t minLength, Packing& packing) {
+  std::vector<std::vector<bool> > used(LEVELS);
+  for (int level = 0; level < LEVELS; level++) used[level].assign(levels[level].notes.size(), false);
+  size_t best = packedBytes(pack(levels, packing));
+
+  for (;;) {
+    // Fenêtres libres regroupées par clé
+    std::map<std::vector<uint8_t>, std::vector<std::pair<int, size_t> > > windows;
+    for (size_t length = minLength; length <= (size_t)MAX_PHRASE_LENGTH; length++) {
+      for (int level = 0; level < LEVELS; level++) {
+        const Level& l = levels[level];
+        for (size_t start = 0; start + length <= l.notes.size(); start++) {
+          if (std::find(used[level].begin() + start, used[level].begin() + start + length, true) !=
+              used[level].begin() + start + length) continue;
+          windows[windowKey(l, start, length)].push_back(std::make_pair(level, start));
+        }
+      }
+    }
+
+    Packing bestPacking;
+    bool found = false;
+    for (std::map<std::vector<uint8_t>, std::vector<std::pair<int, size_t> > >::const_iterator w = windows.begin();
+         w != windows.end(); w++) {
+      if (w->second.size() < 2) continue;
+      size_t length = w->first.size() / 2;
+      const Level& first = levels[w->second[0].first];
+      // Phrase stockée telle qu'à sa première occurrence ; occurrences sans chevauchement
+      std::vector<uint8_t> bytes;
+      for (size_t j = 0; j < length; j++) bytes.push_back(noteByte(first, w->second[0].second + j));
+      Packing candidate = packing;
+      int phrase = (int)candidate.shared.size();
+      candidate.shared.push_back(bytes);
+      int lastLevel = -1;
+      size_t lastEnd = 0;
+      for (size_t o = 0; o < w->second.size(); o++) {
+        if (w->second[o].first == lastLevel && w->second[o].second < lastEnd) continue;
+        candidate.occurrences.push_back({w->second[o].first, w->second[o].second, phrase});
+        lastLevel = w->second[o].first;
+        lastEnd = w->second[o].second + length;
+      }
+      if (candidate.occurrences.size() - packing.occurrences.size() < 2) continue;
+      Packed p = pack(levels, candidate);
+      if (p.phraseStart.size() - 1 > (size_t)MAX_PHRASES) continue;
+      size_t bytesUsed = packedBytes(p);
+      if (bytesUsed < best) {
+        best = bytesUsed;
+        bestPacking = candidate;
+        found = true;
+      }
+    }
+    if (!found) break;
+    packing = bestPacking;
+    for (size_t o = 0; o < packing.occurrences.size(); o++) {
+      const Occurrence& occ = packing.occurrences[o];
+      for (size_t j = 0; j < packing.shared[occ.phrase].size(); j++) used[occ.level][occ.start + j] = true;
+    }
+  }
+  return pack(levels, packing).phraseStart.size() - 1 <= (size_t)MAX_PHRASES;
+}
+
+// ===== VÉRIFICATION =====
+// Décodage comme nextNote() : chaque niveau doit redonner ses notes et durées
+
+static bool verify(const Level* levels, const Packed& p) {
+  for (int level = 0; level < LEVELS; level++) {
+    const Level& l = levels[level];
+    size_t i = 0;
+    for (uint16_t s = p.levelStart[level]; s < p.levelStart[level + 1]; s++) {
+      const Section& section = p.sections[s];
+      for (int r = 0; r < section.repeat; r++) {
+        for (uint16_t b = p.phraseStart[section.phrase]; b < p.phraseStart[section.phrase + 1]; b++, i++) {
+          int note = p.bytes[b] % NOTE_COUNT + section.transpose;
+          uint8_t duration = l.durations[p.bytes[b] / NOTE_COUNT];
+          if (i >= l.notes.size() || note != l.notes[i] || duration != l.durations[l.codes[i]]) {
+            fprintf(stderr, "niveau %d : note %zu différente après décodage\n", level + 1, i);
+            return false;
+          }
+        }
+      }
+    }
+    if (i != l.notes.size()) {
+      fprintf(stderr, "niveau %d : %zu notes décodées sur %zu\n", level + 1, i, l.notes.size());
+      return false;
+    }
+  }
+  return true;
+}
+
+// ===== ÉCRITURE DE L'EN-TÊTE =====
+
+static bool writeHeader(const char* path, const Level* levels, const Packed& p, size_t notes, size_t sourceBytes) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    fprintf(stderr, "%s : écriture impossible\n", path);
+    return false;
+  }
+  fprintf(f, "/*\n"
+             " * song_data.h\n"
+             " * Chansons compressées - généré par tools/songpack à partir de song_patterns.h,\n"
+             " * ne pas modifier à la main.\n"
+             " * Dictionnaire de phrases partagé par les niveaux, un octet par note :\n"
+             " *   octet = code de durée x NOTE_COUNT + note, durée = songDurations[niveau][code]\n"
+             " * Sections de chaque niveau : phrase, transposition (index de note), répétitions.\n"
+             " * %zu notes : %zu octets (tableaux MusicNote : %zu octets).\n"
+             " */\n\n"
+             "#ifndef SONG_DATA_H\n#define SONG_DATA_H\n\n"
+             "#include \"notes_frequencies.h\"\n\n"
+             "#define SONG_LEVELS %d\n"
+             "#define SONG_CODES %d\n"
+             "#define SONG_PHRASES %zu\n"
+             "#define SONG_NOTE(b) ((b) %% NOTE_COUNT)\n"
+             "#define SONG_CODE(b) ((b) / NOTE_COUNT)\n\n"
+             "typedef struct {\n"
+             "  uint8_t phrase;      // index dans songPhraseStart\n"
+             "  int8_t transpose;    // ajouté à l'index de chaque note\n"
+             "  uint8_t repeat;      // lectures de suite (1..255)\n"
+             "} SongSection;\n\n",
+          notes, packedBytes(p), sourceBytes, LEVELS, CODES, p.phraseStart.size() - 1);
+
+  fprintf(f, "const uint8_t songDurations[SONG_LEVELS][SONG_CODES] PROGMEM = {\n");
+  for (int level = 0; level < LEVELS; level++) {
+    fprintf(f, "    {");
+    for (int code = 0; code < CODES; code++) {
+      const std::vector<uint8_t>& d = levels[level].durations;
+      fprintf(f, "%u%s", code < (int)d.size() ? d[code] : 0, code + 1 < CODES ? ", " : "");
+    }
+    fprintf(f, "}%s\n", level + 1 < LEVELS ? "," : "");
+  }
+  fprintf(f, "};\n\n");
+
+  fprintf(f, "const uint8_t songPhrases[] PROGMEM = {");
+  for (size_t phrase = 0; phrase + 1 < p.phraseStart.size(); phrase++) {
+    for (uint16_t b = p.phraseStart[phrase]; b < p.phraseStart[phrase + 1]; b++) {
+      fprintf(f, "%s%u%s", (b - p.phraseStart[phrase]) % 16 ? " " : "\n    ", p.bytes[b],
+              b + 1u < p.bytes.size() ? "," : "");
+    }
+  }
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "const uint16_t songPhraseStart[SONG_PHRASES + 1] PROGMEM = {");
+  for (size_t i = 0; i < p.phraseStart.size(); i++) {
+    fprintf(f, "%s%u%s", i % 16 ? " " : "\n    ", p.phraseStart[i], i + 1 < p.phraseStart.size() ? "," : "");
+  }
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "const SongSection songSections[] PROGMEM = {");
+  for (int level = 0; level < LEVELS; level++) {
+    fprintf(f, "\n    // niveau %d", level + 1);
+    for (uint16_t s = p.levelStart[level]; s < p.levelStart[level + 1]; s++) {
+      const Section& section = p.sections[s];
+      fprintf(f, "%s{%d, %d, %d}%s", (s - p.levelStart[level]) % 6 ? " " : "\n    ", section.phrase,
+              section.transpose, section.repeat, s + 1u < p.sections.size() ? "," : "");
+    }
+  }
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "const uint16_t songLevelStart[SONG_LEVELS + 1] PROGMEM = {");
+  for (size_t i = 0; i < p.levelStart.size(); i++) {
+    fprintf(f, "%s%u%s", i ? " " : "", p.levelStart[i], i + 1 < p.levelStart.size() ? "," : "");
+  }
+  fprintf(f, "};\n\n#endif // SONG_DATA_H\n");
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* output = "TROMBOSS/song_data.h";
+  size_t minLength = 3;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-o") && i + 1 < argc) output = argv[++i];
+    else if (!strcmp(argv[i], "--min") && i + 1 < argc) minLength = (size_t)atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage : %s [-o song_data.h] [--min N]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (minLength < 2) minLength = 2;
+
+  static Level levels[LEVELS];
+  if (!readLevels(levels)) return 1;
+  Packing packing;
+  if (!packSongs(levels, minLength, packing)) {
+    fprintf(stderr, "plus de %d phrases\n", MAX_PHRASES);
+    return 1;
+  }
+  Packed p = pack(levels, packing);
+  if (!verify(levels, p)) return 1;
+
+  // Rapport : place en flash par niveau, comparée aux tableaux MusicNote
+  printf("%-7s %6s %8s %9s %10s %10s\n", "niveau", "notes", "sections", "partagées", "MusicNote", "durées");
+  size_t notes = 0;
+  for (int level = 0; level < LEVELS; level++) {
+    const Level& l = levels[level];
+    printf("%-7d %6zu %8u %9zu %10zu %10zu\n", level + 1, l.notes.size(),
+           p.levelStart[level + 1] - p.levelStart[level], p.sharedNotes[level], l.notes.size() * sizeof(MusicNote),
+           l.durations.size());
+    notes += l.notes.size();
+  }
+  size_t levelBytes = notes * sizeof(MusicNote);
+  size_t sourceBytes = levelBytes + FALLBACK_NOTES * sizeof(MusicNote);
+  size_t packed = packedBytes(p);
+  printf("dictionnaire %zu octets (%zu phrases dont %zu partagées), sections %zu octets, tables %zu octets\n",
+         p.bytes.size(), p.phraseStart.size() - 1, packing.shared.size(), p.sections.size() * SECTION_BYTES,
+         (p.phraseStart.size() + p.levelStart.size()) * sizeof(uint16_t) + LEVELS * CODES);
+  printf("total %zu octets pour %zu notes (%.2f octet/note) ; tableaux MusicNote des niveaux %zu octets "
+         "(x%.2f), avec les 4 de secours %zu octets (x%.2f)\n", packed, notes, (double)packed / notes, levelBytes,
+         (double)levelBytes / packed, sourceBytes, (double)sourceBytes / packed);
+  if (!writeHeader(output, levels, p, notes, sourceBytes)) return 1;
+  printf("écrit %s\n", output);
+  return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * telemdecode.cpp
+ * Décodeur du flux de télémétrie du jeu (TROMBOSS/telemetry.h, compilé avec TELEMETRY 1) :
+ * trames de 10 octets (synchro 0xA5, enregistrement de 8 octets, CRC-8) lues dans un
+ * fichier, capturé sur le port série à 1 Mbaud ou écrit par le banc (--serialout).
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   g++ -std=c++11 -O2 -o telemdecode tools/telemdecode.cpp
+ * Utilisation :
+ *   ./telemdecode FICHIER [--summary] [--period US]
+ *       --summary   : seulement le bilan de chaque niveau, sans la liste des enregistrements
+ *       --period US : durée d'un tick Timer1 en µs pour les dates (25000 par défaut)
+ * Un octet qui ne commence pas une trame valide (synchro absente, CRC faux) est sauté et
+ * compté : le décodage reprend à la trame suivante. Code de sortie 1 si des octets ont été
+ * sautés ou des enregistrements perdus par le jeu (TELEM_LOST).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// ===== FORMAT (mêmes valeurs que telemetry.h) =====
+static const uint8_t SYNC = 0xA5;
+static const size_t FRAME = 10;
+enum {
+  SPAWN = 1, MOVE, HIT, SCORE, JUDGE, DROP, STATE, OVERRUN, LOST, MENU, TYPES
+};
+static const char* const TYPE_NAMES[TYPES] = {
+  "?", "apparition", "déplacement", "touche", "score", "jugement", "sans bloc", "état", "dépassement", "perdus", "menu"
+};
+static const char* const STATE_NAMES[4] = { "MENU", "NIVEAU", "WIN", "LOSE" };
+static const char* const JUDGE_NAMES[3] = { "parfait", "bon", "raté" };
+static const char* const DROP_NAMES[2] = { "trop proche", "réserve" };
+
+struct Record {
+  uint8_t type, a;
+  uint16_t tick, b, c;
+};
+
+static uint8_t crc8(const uint8_t* data, size_t length) {
+  uint8_t crc = 0;
+  while (length--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+static uint16_t word(const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); }
+
+// ===== BILAN D'UN NIVEAU =====
+// Du passage à l'état NIVEAU au changement d'état suivant
+struct Level {
+  uint16_t level;
+  uint64_t start;
+  uint32_t spawns, moves, hits, pixels, drops, overruns, lost;
+  uint32_t judge[3];
+  uint8_t percent;
+  uint16_t current, maximum;
+  int live;   // blocs vivants au plus
+};
+
+static void printLevel(const Level& l, uint64_t end, double period) {
+  printf("niveau %u : %.1f s, %u apparitions, %u sans bloc, %u déplacements (%d blocs vivants au plus), "
+         "%u touches (%u pixels), score %u/%u (%u%%), parfaits %u, bons %u, ratés %u, dépassements %u, "
+         "perdus %u\n", l.level, (end - l.start) * period / 1e6, l.spawns, l.drops, l.moves, l.live, l.hits,
+         l.pixels, l.current, l.maximum, l.percent, l.judge[0], l.judge[1], l.judge[2], l.overruns, l.lost);
+}
+
+int main(int argc, char** argv) {
+  const char* path = NULL;
+  bool summary = false;
+  double period = 25000;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--summary")) summary = true;
+    else if (!strcmp(argv[i], "--period") && i + 1 < argc) period = atof(argv[++i]);
+    else if (!path && argv[i][0] != '-') path = argv[i];
+    else {
+      fprintf(stderr, "usage : %s FICHIER [--summary] [--period US]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (!path) {
+    fprintf(stderr, "usage : %s FICHIER [--summary] [--period US]\n", argv[0]);
+    return 1;
+  }
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.insert(data.end(), buffer, buffer + n);
+  fclose(f);
+
+  uint64_t frames = 0, skipped = 0, lost = 0;
+  uint32_t counts[TYPES] = {};
+  uint64_t tick = 0;            // compteur de ticks déplié (periodicCounter fait le tour en 27 min)
+  bool started = false;
+  Level level = {};
+  bool inLevel = false;
+  size_t i = 0;
+  while (i + FRAME <= data.size()) {
+    const uint8_t* p = &data[i];
+    if (p[0] != SYNC || crc8(p + 1, FRAME - 2) != p[FRAME - 1] || p[1] == 0 || p[1] >= TYPES) {
+      skipped++;
+      i++;
+      continue;
+    }
+    i += FRAME;
+    frames++;
+    Record r = { p[1], p[2], word(p + 3), word(p + 5), word(p + 7) };
+    if (!started) tick = r.tick;
+    else tick += (uint16_t)(r.tick - (uint16_t)tick);
+    started = true;
+    counts[r.type]++;
+
+    if (inLevel) {
+      switch (r.type) {
+        case SPAWN: level.spawns++; break;
+        case MOVE:
+          level.moves++;
+          if (r.a > level.live) level.live = r.a;
+          break;
+        case HIT:
+          level.hits++;
+          level.pixels += r.a;
+          break;
+        case SCORE:
+          level.percent = r.a;
+          level.current = r.b;
+          level.maximum = r.c;
+          break;
+        case JUDGE:
+          if (r.a < 3) level.judge[r.a]++;
+          break;
+        case DROP: level.drops++; break;
+        case OVERRUN: level.overruns++; break;
+        case LOST: level.lost += r.b; break;
+      }
+    }
+    if (r.type == LOST) lost += r.b;
+    if (r.type == STATE) {
+      if (inLevel) printLevel(level, tick, period);
+      inLevel = r.a == 1;
+      if (inLevel) {
+        memset(&level, 0, sizeof(level));
+        level.level = r.c;
+        level.start = tick;
+      }
+    }
+
+    if (summary) continue;
+    printf("%10.3f s  %-13s ", tick * period / 1e6, TYPE_NAMES[r.type]);
+    switch (r.type) {
+      case SPAWN:
+        printf("bloc %u x=%d y=%u l=%u\n", r.a, (int16_t)r.c, r.b & 0xFF, r.b >> 8);
+        break;
+      case MOVE: printf("%u blocs vivants, déplacement %u\n", r.a, r.b); break;
+      case HIT: printf("+%u pixels, curseur ligne %u\n", r.a, r.b); break;
+      case SCORE: printf("%u/%u (%u%%)\n", r.b, r.c, r.a); break;
+      case JUDGE: printf("bloc %u %s\n", r.b, r.a < 3 ? JUDGE_NAMES[r.a] : "?"); break;
+      case DROP: printf("%s\n", r.a < 2 ? DROP_NAMES[r.a] : "?"); break;
+      case STATE:
+        printf("%s -> %s, niveau %u\n", r.b < 4 ? STATE_NAMES[r.b] : "?", r.a < 4 ? STATE_NAMES[r.a] : "?", r.c);
+        break;
+      case OVERRUN:
+        if (r.b) printf("%u µs\n", r.b);
+        else printf("\n");
+        break;
+      case LOST: printf("%u enregistrements\n", r.b); break;
+      case MENU: printf("%s niveau %u, potentiomètre %u\n", r.c ? "validation" : "choix", r.a, r.b); break;
+    }
+  }
+  if (inLevel) printLevel(level, tick, period);
+  skipped += data.size() - i;
+
+  printf("%zu octets, %llu trames, %llu octets sautés, %llu enregistrements perdus par le jeu\n", data.size(),
+         (unsigned long long)frames, (unsigned long long)skipped, (unsigned long long)lost);
+  for (int t = 1; t < TYPES; t++)
+    if (counts[t]) printf("  %-12s %u\n", TYPE_NAMES[t], counts[t]);
+  return skipped || lost ? 1 : 0;
+}